@@ -0,0 +1,154 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/batch.h>
+#include "random_ids.h"
+
+
+
+namespace
+{
+
+void to_literal_loop(benchmark::State& state)
+{
+    const auto ids = random_ids(state.range(0));
+    std::vector<char> buffer(rfc4122::literals_size(std::size(ids), true));
+    for(auto _: state)
+    {
+        char* symbol = std::data(buffer);
+        for(const auto& id: ids)
+        {
+            rfc4122::literal<char> text{};
+            rfc4122::to_literal(text, id);
+            std::memcpy(symbol, text, rfc4122::UUID_STRING_LENGTH);
+            symbol[rfc4122::UUID_STRING_LENGTH] = '\n';
+            symbol += rfc4122::UUID_STRING_LENGTH + 1;
+        }
+        benchmark::DoNotOptimize(std::data(buffer));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    state.SetBytesProcessed(state.iterations() * std::size(buffer));
+}
+
+void to_literals(benchmark::State& state, const rfc4122::__internal::instruction_set kernel)
+{
+    if(rfc4122::__internal::detected_instruction_set() < kernel)
+    {
+        state.SkipWithError("instruction set is not supported");
+        return;
+    }
+    const auto ids = random_ids(state.range(0));
+    std::vector<char> buffer(rfc4122::literals_size(std::size(ids), true));
+    for(auto _: state)
+    {
+        rfc4122::__internal::to_literals(kernel, ids, std::data(buffer), '\n');
+        benchmark::DoNotOptimize(std::data(buffer));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    state.SetBytesProcessed(state.iterations() * std::size(buffer));
+}
+
+} // namespace
+
+using rfc4122::__internal::instruction_set;
+
+BENCHMARK(to_literal_loop)->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(to_literals, scalar, instruction_set::scalar)->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(to_literals, ssse3 , instruction_set::ssse3 )->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(to_literals, avx2  , instruction_set::avx2  )->RangeMultiplier(8)->Range(64, 64 << 12);
+
+namespace
+{
+
+std::string random_literals(const size_t count)
+{
+    std::string text;
+    for(const auto& id: random_ids(count)) text += rfc4122::to_string(id) + "\n";
+    return text;
+}
+
+void from_string_loop(benchmark::State& state)
+{
+    const auto text = random_literals(state.range(0));
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    for(auto _: state)
+    {
+        const char* symbol = std::data(text);
+        for(auto& id: ids)
+        {
+            id = rfc4122::from_string(symbol, rfc4122::UUID_STRING_LENGTH);
+            symbol += rfc4122::UUID_STRING_LENGTH + 1;
+        }
+        benchmark::DoNotOptimize(std::data(ids));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    state.SetBytesProcessed(state.iterations() * std::size(text));
+}
+
+void from_stream(benchmark::State& state)
+{
+    const auto text = random_literals(state.range(0));
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    for(auto _: state)
+    {
+        std::istringstream input{text};
+        for(auto& id: ids) input >> id;
+        benchmark::DoNotOptimize(std::data(ids));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    state.SetBytesProcessed(state.iterations() * std::size(text));
+}
+
+void parse_all(benchmark::State& state)
+{
+    const auto text = random_literals(state.range(0));
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    for(auto _: state)
+    {
+        std::istringstream input{text};
+        rfc4122::parse_all(input, std::begin(ids));
+        benchmark::DoNotOptimize(std::data(ids));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    state.SetBytesProcessed(state.iterations() * std::size(text));
+}
+
+void from_literals(benchmark::State& state, const rfc4122::__internal::instruction_set kernel)
+{
+    if(rfc4122::__internal::detected_instruction_set() < kernel)
+    {
+        state.SkipWithError("instruction set is not supported");
+        return;
+    }
+    const auto text = random_literals(state.range(0));
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    std::vector<uint64_t> validity(rfc4122::validity_size(std::size(ids)));
+    for(auto _: state)
+    {
+        benchmark::DoNotOptimize(rfc4122::__internal::from_literals(kernel, text, ids, validity, '\n'));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    state.SetBytesProcessed(state.iterations() * std::size(text));
+}
+
+} // namespace
+
+BENCHMARK(from_string_loop)->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK(from_stream)->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK(parse_all)->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(from_literals, scalar, instruction_set::scalar)->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(from_literals, ssse3 , instruction_set::ssse3 )->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(from_literals, avx2  , instruction_set::avx2  )->RangeMultiplier(8)->Range(64, 64 << 12);
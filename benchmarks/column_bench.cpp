@@ -0,0 +1,78 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/column.h>
+
+
+
+namespace
+{
+
+std::vector<rfc4122::uuid> sorted_ids(const size_t count)
+{
+    std::vector<rfc4122::uuid> ids(count);
+    rfc4122::generate_n(ids);
+    std::sort(std::begin(ids), std::end(ids));
+    return ids;
+}
+
+std::vector<rfc4122::uuid> probes(const std::vector<rfc4122::uuid>& ids)
+{
+    std::mt19937_64 random{std::size(ids)};
+    std::vector<rfc4122::uuid> picked(1u << 16);
+    for(auto& probe: picked) probe = ids[random() % std::size(ids)];
+    return picked;
+}
+
+void vector_contains(benchmark::State& state)
+{
+    const auto ids = sorted_ids(state.range(0));
+    const auto keys = probes(ids);
+    for(auto _: state)
+    {
+        size_t found = 0u;
+        for(const auto& key: keys) found += std::binary_search(std::begin(ids), std::end(ids), key);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(keys));
+    state.counters["bytes_per_id"] = sizeof(rfc4122::uuid);
+}
+
+void column_contains(benchmark::State& state)
+{
+    const auto ids = sorted_ids(state.range(0));
+    const auto keys = probes(ids);
+    const rfc4122::sorted_column column{ids};
+    for(auto _: state)
+    {
+        size_t found = 0u;
+        for(const auto& key: keys) found += column.contains(key);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(keys));
+    state.counters["bytes_per_id"] = static_cast<double>(std::size(column.bytes())) / std::size(column);
+}
+
+void column_scan(benchmark::State& state)
+{
+    const rfc4122::sorted_column column{sorted_ids(state.range(0))};
+    for(auto _: state)
+    {
+        uint64_t sum = 0u;
+        for(const auto id: column) sum += id.low();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(column));
+}
+
+} // namespace
+
+BENCHMARK(vector_contains)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(column_contains)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(column_scan)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
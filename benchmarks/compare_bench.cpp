@@ -0,0 +1,118 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/algorithm.h>
+#include <rfc4122/uuid.h>
+
+
+
+namespace
+{
+
+// The former octet by octet comparison, kept as the baseline.
+struct octet_less
+{
+    bool operator () (const rfc4122::uuid& left, const rfc4122::uuid& right) const noexcept
+    {
+        uint8_t l[16], r[16];
+        std::memcpy(l, &left, sizeof(l));
+        std::memcpy(r, &right, sizeof(r));
+        for(size_t i = 0; i < 16u; ++i)
+        {
+            if(l[i] != r[i]) return l[i] < r[i];
+        }
+        return false;
+    }
+};
+
+// What callers wrote in the absence of std::hash<uuid>.
+struct octet_hash
+{
+    size_t operator () (const rfc4122::uuid& id) const noexcept
+    {
+        return std::hash<std::string_view>{}({reinterpret_cast<const char*>(&id), sizeof(id)});
+    }
+};
+
+struct octet_equal
+{
+    bool operator () (const rfc4122::uuid& left, const rfc4122::uuid& right) const noexcept
+    {
+        return 0 == std::memcmp(&left, &right, sizeof(left));
+    }
+};
+
+std::vector<rfc4122::uuid> ids(const size_t count, const bool time_based)
+{
+    std::vector<rfc4122::uuid> generated(count);
+    if(time_based) rfc4122::generate_time_based_n(generated);
+    else           rfc4122::generate_n(generated);
+    return generated;
+}
+
+template<typename L>
+void sort(benchmark::State& state)
+{
+    const auto source = ids(state.range(0), false);
+    std::vector<rfc4122::uuid> sorted(std::size(source));
+    for(auto _: state)
+    {
+        state.PauseTiming();
+        sorted = source;
+        state.ResumeTiming();
+        std::sort(std::begin(sorted), std::end(sorted), L{});
+        benchmark::DoNotOptimize(std::data(sorted));
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(source));
+}
+
+void radix_sort(benchmark::State& state)
+{
+    const auto source = ids(state.range(0), false);
+    std::vector<rfc4122::uuid> sorted(std::size(source));
+    for(auto _: state)
+    {
+        state.PauseTiming();
+        sorted = source;
+        state.ResumeTiming();
+        rfc4122::sort(sorted, static_cast<unsigned>(state.range(1)));
+        benchmark::DoNotOptimize(std::data(sorted));
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(source));
+}
+
+template<typename H, typename E>
+void map_find(benchmark::State& state)
+{
+    const auto keys = ids(state.range(0), 0 != state.range(1));
+    std::unordered_map<rfc4122::uuid, size_t, H, E> map;
+    for(size_t i = 0; i < std::size(keys); ++i) map.emplace(keys[i], i);
+    for(auto _: state)
+    {
+        size_t found = 0u;
+        for(const auto& key: keys) found += map.find(key)->second;
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(keys));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(sort, octet_less)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(sort, std::less<rfc4122::uuid>)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+BENCHMARK(radix_sort)->ArgNames({"count", "threads"})->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 18, 16), {1, 0}});
+BENCHMARK_TEMPLATE(sort, std::less<rfc4122::uuid>)->Arg(1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(radix_sort)->ArgNames({"count", "threads"})->Args({1 << 24, 1})->Args({1 << 24, 0})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE2(map_find, octet_hash, octet_equal)
+    ->ArgNames({"count", "time_based"})->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 18, 16), {0, 1}});
+BENCHMARK_TEMPLATE2(map_find, std::hash<rfc4122::uuid>, std::equal_to<rfc4122::uuid>)
+    ->ArgNames({"count", "time_based"})->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 18, 16), {0, 1}});
@@ -0,0 +1,107 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/concurrent_map.h>
+
+
+
+namespace
+{
+
+constexpr size_t KEYS = 1u << 20;
+
+const std::vector<rfc4122::uuid>& keys()
+{
+    static const auto generated = []
+    {
+        std::vector<rfc4122::uuid> ids(KEYS);
+        rfc4122::generate_n(ids);
+        return ids;
+    }();
+    return generated;
+}
+
+template<typename H>
+struct sharded
+{
+    rfc4122::concurrent_uuid_map<uint64_t, H> map;
+
+    uint64_t find(const rfc4122::uuid& key) const {return map.find(key).value_or(0u);}
+    void assign(const rfc4122::uuid& key, const uint64_t value) {map.insert_or_assign(key, value);}
+};
+
+// One uuid_map behind one lock, what a session table starts out as.
+template<typename M>
+struct locked
+{
+    rfc4122::uuid_map<uint64_t, rfc4122::uuid_bits_hash> map;
+    mutable M lock;
+
+    uint64_t find(const rfc4122::uuid& key) const
+    {
+        const auto guard = [this]
+        {
+            if constexpr(std::is_same_v<M, std::shared_mutex>) return std::shared_lock{lock};
+            else                                               return std::unique_lock{lock};
+        }();
+        const auto found = map.find(key);
+        return found ? *found : 0u;
+    }
+
+    void assign(const rfc4122::uuid& key, const uint64_t value)
+    {
+        const std::lock_guard guard{lock};
+        map.insert_or_assign(key, value);
+    }
+};
+
+// range(0) of every 100 operations are writes to existing keys, the rest
+// lookups; every thread works on the same table.
+template<typename M>
+void mixed(benchmark::State& state)
+{
+    static M* map = nullptr;
+    if(0 == state.thread_index())
+    {
+        map = new M{};
+        for(size_t i = 0; i < KEYS; ++i) map->assign(keys()[i], i);
+    }
+
+    const auto& ids = keys();
+    const auto writes = static_cast<uint64_t>(state.range(0));
+    std::mt19937_64 random(state.thread_index());
+    for(auto _: state)
+    {
+        uint64_t sum = 0u;
+        for(int i = 0; i < 256; ++i)
+        {
+            const uint64_t pick = random();
+            const auto& key = ids[pick % KEYS];
+            if((pick >> 40) % 100u < writes) map->assign(key, pick);
+            else                             sum += map->find(key);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 256);
+
+    if(0 == state.thread_index())
+    {
+        delete map;
+        map = nullptr;
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(mixed, sharded<rfc4122::uuid_hash>)->ArgName("writes%")->Arg(1)->Arg(10)->Arg(50)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(mixed, sharded<rfc4122::uuid_bits_hash>)->ArgName("writes%")->Arg(1)->Arg(10)->Arg(50)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(mixed, locked<std::mutex>)->ArgName("writes%")->Arg(1)->Arg(10)->Arg(50)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(mixed, locked<std::shared_mutex>)->ArgName("writes%")->Arg(1)->Arg(10)->Arg(50)->ThreadRange(1, 8)->UseRealTime();
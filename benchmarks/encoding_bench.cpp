@@ -0,0 +1,71 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/encoding.h>
+#include "random_ids.h"
+
+
+
+namespace
+{
+
+using rfc4122::text_encoding;
+using rfc4122::__internal::instruction_set;
+
+void encode_n(benchmark::State& state, const text_encoding encoding, const instruction_set kernel)
+{
+    if(rfc4122::__internal::detected_instruction_set() < kernel)
+    {
+        state.SkipWithError("instruction set is not supported");
+        return;
+    }
+    const auto ids = random_ids(state.range(0));
+    std::vector<char> buffer(rfc4122::encoded_size(encoding, std::size(ids), true));
+    for(auto _: state)
+    {
+        rfc4122::__internal::encode_n(kernel, encoding, ids, std::data(buffer), '\n');
+        benchmark::DoNotOptimize(std::data(buffer));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    state.SetBytesProcessed(state.iterations() * std::size(buffer));
+}
+
+void decode_n(benchmark::State& state, const text_encoding encoding, const instruction_set kernel)
+{
+    if(rfc4122::__internal::detected_instruction_set() < kernel)
+    {
+        state.SkipWithError("instruction set is not supported");
+        return;
+    }
+    std::vector<rfc4122::uuid> ids = random_ids(state.range(0));
+    std::string text(rfc4122::encoded_size(encoding, std::size(ids), true), '\0');
+    rfc4122::encode_n(encoding, std::span<const rfc4122::uuid>{ids}, std::span<char>{text}, '\n');
+    std::vector<uint64_t> validity(rfc4122::validity_size(std::size(ids)));
+    for(auto _: state)
+    {
+        benchmark::DoNotOptimize(rfc4122::__internal::decode_n(kernel, encoding, text, ids, validity, '\n'));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    state.SetBytesProcessed(state.iterations() * std::size(text));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(encode_n, base64url_scalar, text_encoding::base64url, instruction_set::scalar)->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(encode_n, base64url_ssse3 , text_encoding::base64url, instruction_set::ssse3 )->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(encode_n, base64url_avx2  , text_encoding::base64url, instruction_set::avx2  )->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(encode_n, base32_scalar   , text_encoding::base32   , instruction_set::scalar)->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(encode_n, base32_ssse3    , text_encoding::base32   , instruction_set::ssse3 )->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(encode_n, base32_avx2     , text_encoding::base32   , instruction_set::avx2  )->RangeMultiplier(8)->Range(64, 64 << 12);
+
+BENCHMARK_CAPTURE(decode_n, base64url_scalar, text_encoding::base64url, instruction_set::scalar)->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(decode_n, base64url_ssse3 , text_encoding::base64url, instruction_set::ssse3 )->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(decode_n, base32_scalar   , text_encoding::base32   , instruction_set::scalar)->RangeMultiplier(8)->Range(64, 64 << 12);
+BENCHMARK_CAPTURE(decode_n, base32_ssse3    , text_encoding::base32   , instruction_set::ssse3 )->RangeMultiplier(8)->Range(64, 64 << 12);
@@ -0,0 +1,136 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/file.h>
+#include "random_ids.h"
+
+
+
+namespace
+{
+
+const std::filesystem::path& text_path(const size_t count)
+{
+    static const auto path = std::filesystem::temp_directory_path() / "rfc4122_bench.txt";
+    static size_t written = 0;
+    if(written != count)
+    {
+        rfc4122::text_writer{path}.write(random_ids(count));
+        written = count;
+    }
+    return path;
+}
+
+void istream_load(benchmark::State& state)
+{
+    const auto& path = text_path(state.range(0));
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    for(auto _: state)
+    {
+        std::ifstream input{path};
+        for(auto& id: ids)
+        {
+            input >> id;
+            input.get();
+        }
+        benchmark::DoNotOptimize(std::data(ids));
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+}
+
+void text_reader_load(benchmark::State& state)
+{
+    const auto& path = text_path(state.range(0));
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    std::vector<uint64_t> validity(rfc4122::validity_size(std::size(ids)));
+    for(auto _: state)
+    {
+        rfc4122::text_reader reader{path};
+        benchmark::DoNotOptimize(reader.read(ids, validity));
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+}
+
+void text_writer_store(benchmark::State& state)
+{
+    const auto ids  = random_ids(state.range(0));
+    const auto path = std::filesystem::temp_directory_path() / "rfc4122_bench_out.txt";
+    for(auto _: state)
+    {
+        rfc4122::text_writer writer{path};
+        writer.write(ids);
+        writer.close();
+    }
+    std::filesystem::remove(path);
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    state.SetBytesProcessed(state.iterations() * rfc4122::literals_size(std::size(ids), true));
+}
+
+// What exports did before: a string per id through an ostream.
+void ostream_store(benchmark::State& state)
+{
+    const auto ids  = random_ids(state.range(0));
+    const auto path = std::filesystem::temp_directory_path() / "rfc4122_bench_out.txt";
+    for(auto _: state)
+    {
+        std::ofstream output{path};
+        for(const auto& id: ids) output << rfc4122::to_string(id) << '\n';
+    }
+    std::filesystem::remove(path);
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    state.SetBytesProcessed(state.iterations() * rfc4122::literals_size(std::size(ids), true));
+}
+
+void async_writer_store(benchmark::State& state, const rfc4122::text_layout layout)
+{
+    const auto ids  = random_ids(state.range(0));
+    const auto path = std::filesystem::temp_directory_path() / "rfc4122_bench_out.txt";
+    rfc4122::async_writer_metrics totals{};
+    for(auto _: state)
+    {
+        const int descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        {
+            rfc4122::async_text_writer writer{descriptor, {.layout = layout}};
+            for(size_t first = 0; first < std::size(ids); first += 4096u)
+            {
+                writer.write(std::span{ids}.subspan(first, std::min<size_t>(4096u, std::size(ids) - first)));
+            }
+            writer.finish();
+            const auto metrics = writer.metrics();
+            totals.bytes += metrics.bytes;
+            totals.writes += metrics.writes;
+            totals.stalls += metrics.stalls;
+            totals.formatting += metrics.formatting;
+            totals.writing += metrics.writing;
+        }
+        ::close(descriptor);
+    }
+    std::filesystem::remove(path);
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    state.SetBytesProcessed(totals.bytes);
+    state.counters["writes"] = benchmark::Counter(static_cast<double>(totals.writes), benchmark::Counter::kAvgIterations);
+    state.counters["stalls"] = benchmark::Counter(static_cast<double>(totals.stalls), benchmark::Counter::kAvgIterations);
+    state.counters["format_ms"] = benchmark::Counter(std::chrono::duration<double, std::milli>(totals.formatting).count(), benchmark::Counter::kAvgIterations);
+    state.counters["write_ms"]  = benchmark::Counter(std::chrono::duration<double, std::milli>(totals.writing).count(), benchmark::Counter::kAvgIterations);
+}
+
+} // namespace
+
+BENCHMARK(istream_load     )->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(text_reader_load )->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(text_writer_store)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(ostream_store    )->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(async_writer_store, lines, rfc4122::text_layout::lines     )->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(async_writer_store, csv  , rfc4122::text_layout::csv       )->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(async_writer_store, json , rfc4122::text_layout::json_array)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,89 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/batch.h>
+#include <rfc4122/filter.h>
+
+
+
+namespace
+{
+
+using rfc4122::__internal::instruction_set;
+using rfc4122::filter_keys;
+
+constexpr size_t COUNT = 1u << 24;
+
+// Half of the probes were inserted.
+std::vector<rfc4122::uuid> probes(const std::vector<rfc4122::uuid>& inserted)
+{
+    std::vector<rfc4122::uuid> picked(1u << 16);
+    rfc4122::generate_n(picked);
+    for(size_t i = 0; i < std::size(picked); i += 2) picked[i] = inserted[(i * 40503u) % std::size(inserted)];
+    return picked;
+}
+
+template<typename F>
+void single(benchmark::State& state, const F& filter, const std::vector<rfc4122::uuid>& keys)
+{
+    for(auto _: state)
+    {
+        size_t found = 0u;
+        for(const auto& key: keys) found += filter.may_contain(key);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(keys));
+}
+
+template<typename F>
+void batch(benchmark::State& state, const F& filter, const std::vector<rfc4122::uuid>& keys, const instruction_set kernel)
+{
+    std::vector<uint64_t> found(rfc4122::validity_size(std::size(keys)));
+    for(auto _: state)
+    {
+        benchmark::DoNotOptimize(rfc4122::__internal::may_contain_n(kernel, filter, keys, found));
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(keys));
+}
+
+void bloom(benchmark::State& state, const filter_keys keys, const instruction_set kernel, const bool batched)
+{
+    if(rfc4122::__internal::detected_instruction_set() < kernel) return state.SkipWithError("not supported");
+    std::vector<rfc4122::uuid> inserted(COUNT);
+    rfc4122::generate_n(inserted);
+    rfc4122::blocked_bloom_filter filter{COUNT, 0.01, keys};
+    filter.insert(inserted);
+    const auto picked = probes(inserted);
+    if(batched) batch(state, filter, picked, kernel);
+    else        single(state, filter, picked);
+}
+
+void cuckoo(benchmark::State& state, const filter_keys keys, const instruction_set kernel, const bool batched)
+{
+    if(rfc4122::__internal::detected_instruction_set() < kernel) return state.SkipWithError("not supported");
+    std::vector<rfc4122::uuid> inserted(COUNT);
+    rfc4122::generate_n(inserted);
+    rfc4122::cuckoo_filter filter{COUNT, keys};
+    for(const auto& id: inserted) filter.insert(id);
+    const auto picked = probes(inserted);
+    if(batched) batch(state, filter, picked, kernel);
+    else        single(state, filter, picked);
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(bloom, any_single   , filter_keys::any   , instruction_set::scalar, false);
+BENCHMARK_CAPTURE(bloom, random_single, filter_keys::random, instruction_set::scalar, false);
+BENCHMARK_CAPTURE(bloom, random_scalar, filter_keys::random, instruction_set::scalar, true );
+BENCHMARK_CAPTURE(bloom, random_avx2  , filter_keys::random, instruction_set::avx2  , true );
+BENCHMARK_CAPTURE(bloom, any_avx2     , filter_keys::any   , instruction_set::avx2  , true );
+
+BENCHMARK_CAPTURE(cuckoo, any_single   , filter_keys::any   , instruction_set::scalar, false);
+BENCHMARK_CAPTURE(cuckoo, random_single, filter_keys::random, instruction_set::scalar, false);
+BENCHMARK_CAPTURE(cuckoo, random_scalar, filter_keys::random, instruction_set::scalar, true );
+BENCHMARK_CAPTURE(cuckoo, random_avx2  , filter_keys::random, instruction_set::avx2  , true );
+BENCHMARK_CAPTURE(cuckoo, any_avx2     , filter_keys::any   , instruction_set::avx2  , true );
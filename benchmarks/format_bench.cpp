@@ -0,0 +1,136 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/format.h>
+#include "random_ids.h"
+
+
+
+namespace
+{
+
+void to_string(benchmark::State& state)
+{
+    const auto ids = random_ids(1024);
+    for(auto _: state)
+    {
+        for(const auto& id: ids) benchmark::DoNotOptimize(rfc4122::to_string(id));
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+}
+
+void print(benchmark::State& state)
+{
+    const auto ids = random_ids(1024);
+    std::ostringstream output;
+    for(auto _: state)
+    {
+        output.seekp(0);
+        for(const auto& id: ids) rfc4122::print(output, id);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+}
+
+void to_chars(benchmark::State& state)
+{
+    const auto ids = random_ids(1024);
+    const rfc4122::literal_format format{.upper_case = 0 != state.range(0), .hyphens = 0 == state.range(1)};
+    char buffer[rfc4122::MAX_FORMATTED_LENGTH];
+    for(auto _: state)
+    {
+        for(const auto& id: ids)
+        {
+            benchmark::DoNotOptimize(rfc4122::to_chars(std::begin(buffer), std::end(buffer), id, format));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+}
+
+#if defined(__cpp_lib_format)
+void format(benchmark::State& state)
+{
+    const auto ids = random_ids(1024);
+    char buffer[rfc4122::MAX_FORMATTED_LENGTH];
+    for(auto _: state)
+    {
+        for(const auto& id: ids)
+        {
+            benchmark::DoNotOptimize(std::format_to_n(buffer, std::size(buffer), "{}", id));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+}
+#endif
+
+// The same ids in the forms a parser sees on the wire, mixed.
+std::vector<std::string> mixed_literals(const size_t count)
+{
+    const rfc4122::literal_format formats[] = 
+    {
+          {}
+        , {.upper_case = true, .wrap = rfc4122::enclosure::braces}
+        , {.hyphens = false}
+        , {.wrap = rfc4122::enclosure::urn}
+    };
+    std::vector<std::string> texts;
+    for(const auto& id: random_ids(count))
+    {
+        char buffer[rfc4122::MAX_FORMATTED_LENGTH];
+        const auto format = formats[std::size(texts) % std::size(formats)];
+        texts.emplace_back(buffer, rfc4122::format_to(buffer, id, format));
+    }
+    return texts;
+}
+
+// What callers do without parse_literal: strip the wrapping, restore the
+// hyphens and hand the canonical form to from_string.
+void normalize_from_string(benchmark::State& state)
+{
+    const auto texts = mixed_literals(1024);
+    for(auto _: state)
+    {
+        for(const auto& text: texts)
+        {
+            std::string_view body = text;
+            if(body.starts_with('{')) body = body.substr(1, std::size(body) - 2);
+            if(body.starts_with("urn:uuid:")) body.remove_prefix(rfc4122::URN_PREFIX_LENGTH);
+            std::string canonical{body};
+            if(2u * sizeof(rfc4122::uuid) == std::size(canonical))
+            {
+                for(const size_t dash: {8u, 13u, 18u, 23u}) canonical.insert(dash, 1, '-');
+            }
+            benchmark::DoNotOptimize(rfc4122::from_string(canonical.c_str(), std::size(canonical)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(texts));
+}
+
+void parse_literal(benchmark::State& state)
+{
+    const auto texts = mixed_literals(1024);
+    for(auto _: state)
+    {
+        for(const auto& text: texts) benchmark::DoNotOptimize(rfc4122::parse_literal(std::string_view{text}));
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(texts));
+}
+
+} // namespace
+
+BENCHMARK(normalize_from_string);
+BENCHMARK(parse_literal);
+BENCHMARK(to_string);
+BENCHMARK(print);
+BENCHMARK(to_chars)->ArgsProduct({{0, 1}, {0, 1}})->ArgNames({"upper", "no_hyphens"});
+#if defined(__cpp_lib_format)
+BENCHMARK(format);
+#endif
@@ -0,0 +1,227 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/random.h>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/node.h>
+#include <rfc4122/pool.h>
+#include <rfc4122/uuid.h>
+
+
+
+namespace
+{
+
+// What a generator that asks the kernel for every id costs.
+void getrandom_per_id(benchmark::State& state)
+{
+    for(auto _: state)
+    {
+        rfc4122::uuid id{};
+        benchmark::DoNotOptimize(::getrandom(&id, sizeof(id), 0));
+        benchmark::DoNotOptimize(id);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void generate_uuid(benchmark::State& state)
+{
+    for(auto _: state)
+    {
+        benchmark::DoNotOptimize(rfc4122::generate_uuid());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void generate_n(benchmark::State& state)
+{
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    for(auto _: state)
+    {
+        rfc4122::generate_n(ids);
+        benchmark::DoNotOptimize(std::data(ids));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+}
+
+// The same version 1 scheme serialised by one process-wide mutex.
+void generate_time_based_locked(benchmark::State& state)
+{
+    static std::mutex lock;
+    static uint64_t last = 0u;
+    for(auto _: state)
+    {
+        uint64_t tick = 0u;
+        {
+            const std::lock_guard guard{lock};
+            const uint64_t now = std::chrono::system_clock::now().time_since_epoch().count();
+            tick = last = std::max(now, last + 1u);
+        }
+        benchmark::DoNotOptimize(rfc4122::uuid{tick, rfc4122::variant::rfc4122, rfc4122::version::time_based, 0u, 0u});
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void generate_time_based_uuid(benchmark::State& state)
+{
+    for(auto _: state)
+    {
+        benchmark::DoNotOptimize(rfc4122::generate_time_based_uuid());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void generate_time_based_n(benchmark::State& state)
+{
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    for(auto _: state)
+    {
+        rfc4122::generate_time_based_n(ids);
+        benchmark::DoNotOptimize(std::data(ids));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+}
+
+} // namespace
+
+BENCHMARK(getrandom_per_id)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(generate_uuid   )->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(generate_n      )->Arg(1024)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK(generate_time_based_locked)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(generate_time_based_uuid  )->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(generate_time_based_n     )->Arg(1024)->ThreadRange(1, 64)->UseRealTime();
+
+namespace
+{
+
+void generate_reordered_time_uuid(benchmark::State& state)
+{
+    for(auto _: state)
+    {
+        benchmark::DoNotOptimize(rfc4122::generate_reordered_time_uuid());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void generate_unix_time_uuid(benchmark::State& state)
+{
+    for(auto _: state)
+    {
+        benchmark::DoNotOptimize(rfc4122::generate_unix_time_uuid());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void generate_unix_time_n(benchmark::State& state)
+{
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    for(auto _: state)
+    {
+        rfc4122::generate_unix_time_n(ids);
+        benchmark::DoNotOptimize(std::data(ids));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+}
+
+} // namespace
+
+BENCHMARK(generate_reordered_time_uuid)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(generate_unix_time_uuid     )->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(generate_unix_time_n        )->Arg(1024)->ThreadRange(1, 64)->UseRealTime();
+
+namespace
+{
+
+rfc4122::id_pool& shared_pool(const rfc4122::version kind)
+{
+    static rfc4122::id_pool random_pool{{.version = rfc4122::version::random, .capacity = 1u << 16, .low_watermark = 1u << 15}};
+    static rfc4122::id_pool unix_time_pool{{.version = rfc4122::version::unix_time, .capacity = 1u << 16, .low_watermark = 1u << 15}};
+    return rfc4122::version::random == kind ? random_pool : unix_time_pool;
+}
+
+void id_pool_pop(benchmark::State& state, const rfc4122::version kind)
+{
+    auto& pool = shared_pool(kind);
+    for(auto _: state)
+    {
+        benchmark::DoNotOptimize(pool.pop());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Every call timed on its own; the counters are the median and the 99.9th
+// percentile, which is what the pool is for.
+template<typename G>
+void tail_latency(benchmark::State& state, const G& generate)
+{
+    std::vector<int64_t> nanoseconds(1u << 16);
+    for(auto _: state)
+    {
+        for(auto& elapsed: nanoseconds)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            benchmark::DoNotOptimize(generate());
+            elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+    std::sort(std::begin(nanoseconds), std::end(nanoseconds));
+    state.counters["p50_ns"]  = static_cast<double>(nanoseconds[std::size(nanoseconds) / 2u]);
+    state.counters["p999_ns"] = static_cast<double>(nanoseconds[std::size(nanoseconds) * 999u / 1000u]);
+    state.SetItemsProcessed(state.iterations() * std::size(nanoseconds));
+}
+
+void generate_uuid_latency(benchmark::State& state)
+{
+    tail_latency(state, []{return rfc4122::generate_uuid();});
+}
+
+void id_pool_latency(benchmark::State& state)
+{
+    auto& pool = shared_pool(rfc4122::version::random);
+    tail_latency(state, [&pool]{return pool.pop();});
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(id_pool_pop, random   , rfc4122::version::random   )->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_CAPTURE(id_pool_pop, unix_time, rfc4122::version::unix_time)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(generate_uuid_latency);
+BENCHMARK(id_pool_latency);
+
+namespace
+{
+
+void host_node(benchmark::State& state)
+{
+    for(auto _: state) benchmark::DoNotOptimize(rfc4122::host_node());
+    state.SetItemsProcessed(state.iterations());
+}
+
+// What working the node out on every call would cost.
+void discover_node(benchmark::State& state)
+{
+    for(auto _: state)
+    {
+        auto node = rfc4122::__internal::interface_node("/sys/class/net");
+        if(!node) node = rfc4122::__internal::machine_id_node("/etc/machine-id");
+        benchmark::DoNotOptimize(node);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(host_node)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(discover_node);
@@ -0,0 +1,83 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/hash.h>
+#include <rfc4122/uuid.h>
+
+
+
+namespace
+{
+
+using rfc4122::__internal::hash_algorithm;
+using rfc4122::__internal::instruction_set;
+
+std::vector<std::string> host_names(const size_t count)
+{
+    std::vector<std::string> names;
+    for(size_t i = 0; i < count; ++i) names.push_back("host-" + std::to_string(i) + ".example.com");
+    return names;
+}
+
+void hash_n(benchmark::State& state, const hash_algorithm algorithm, const instruction_set kernel)
+{
+    if(rfc4122::__internal::detected_instruction_set() < kernel)
+    {
+        state.SkipWithError("instruction set is not supported");
+        return;
+    }
+    const auto texts = host_names(state.range(0));
+    const std::vector<std::string_view> names(std::begin(texts), std::end(texts));
+    std::vector<rfc4122::__internal::digest> digests(std::size(names));
+    const auto prefix = std::as_bytes(std::span{&rfc4122::NAMESPACE_DNS, 1u});
+    for(auto _: state)
+    {
+        rfc4122::__internal::hash_n(kernel, algorithm, prefix, names, digests);
+        benchmark::DoNotOptimize(std::data(digests));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(names));
+}
+
+void generate_sha1_loop(benchmark::State& state)
+{
+    const auto names = host_names(state.range(0));
+    std::vector<rfc4122::uuid> ids(std::size(names));
+    for(auto _: state)
+    {
+        for(size_t i = 0; i < std::size(names); ++i) ids[i] = rfc4122::generate_sha1_uuid(rfc4122::NAMESPACE_DNS, names[i]);
+        benchmark::DoNotOptimize(std::data(ids));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(names));
+}
+
+void generate_sha1_n(benchmark::State& state)
+{
+    const auto texts = host_names(state.range(0));
+    const std::vector<std::string_view> names(std::begin(texts), std::end(texts));
+    std::vector<rfc4122::uuid> ids(std::size(names));
+    for(auto _: state)
+    {
+        rfc4122::generate_sha1_n(rfc4122::NAMESPACE_DNS, names, ids);
+        benchmark::DoNotOptimize(std::data(ids));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(names));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(hash_n, md5_scalar , hash_algorithm::md5 , instruction_set::scalar)->Arg(4096);
+BENCHMARK_CAPTURE(hash_n, md5_x4     , hash_algorithm::md5 , instruction_set::ssse3 )->Arg(4096);
+BENCHMARK_CAPTURE(hash_n, md5_x8     , hash_algorithm::md5 , instruction_set::avx2  )->Arg(4096);
+BENCHMARK_CAPTURE(hash_n, sha1_scalar, hash_algorithm::sha1, instruction_set::scalar)->Arg(4096);
+BENCHMARK_CAPTURE(hash_n, sha1_x4    , hash_algorithm::sha1, instruction_set::ssse3 )->Arg(4096);
+BENCHMARK_CAPTURE(hash_n, sha1_x8    , hash_algorithm::sha1, instruction_set::avx2  )->Arg(4096);
+BENCHMARK(generate_sha1_loop)->Arg(4096);
+BENCHMARK(generate_sha1_n)->Arg(4096);
@@ -0,0 +1,108 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/map.h>
+
+
+
+namespace
+{
+
+constexpr size_t LOOKUPS = 1u << 20;
+
+// Entry counts are taken from UUID_BENCH_MAP_SIZES, e.g. "100000000", and
+// default to 1M and 10M. 100M entries need ~3GB as uuid_map and ~6GB as
+// std::unordered_map, more than a plain run should take.
+void map_sizes(benchmark::internal::Benchmark* benchmark)
+{
+    const char* sizes = std::getenv("UUID_BENCH_MAP_SIZES");
+    if(nullptr == sizes || '\0' == *sizes) sizes = "1000000,10000000";
+    for(char* end = nullptr; ; sizes = end + 1)
+    {
+        const long long size = std::strtoll(sizes, &end, 10);
+        if(end == sizes) break;
+        if(size > 0) benchmark->Arg(size);
+        if(',' != *end) break;
+    }
+}
+
+struct std_map
+{
+    std::unordered_map<rfc4122::uuid, uint64_t> map;
+
+    void reserve(const size_t count) {map.reserve(count);}
+    void insert(const rfc4122::uuid& key, const uint64_t value) {map.try_emplace(key, value);}
+    uint64_t find(const rfc4122::uuid& key) const {const auto found = map.find(key); return found == std::end(map) ? 0u : found->second;}
+};
+
+template<typename H>
+struct flat_map
+{
+    rfc4122::uuid_map<uint64_t, H> map;
+
+    void reserve(const size_t count) {map.reserve(count);}
+    void insert(const rfc4122::uuid& key, const uint64_t value) {map.try_emplace(key, value);}
+    uint64_t find(const rfc4122::uuid& key) const {const auto found = map.find(key); return found ? *found : 0u;}
+};
+
+std::vector<rfc4122::uuid> keys(const size_t count)
+{
+    std::vector<rfc4122::uuid> generated(count);
+    rfc4122::generate_n(generated);
+    return generated;
+}
+
+// Random hits, so each lookup is a cache miss once the table outgrows the caches.
+template<typename M>
+void lookup(benchmark::State& state)
+{
+    const auto inserted = keys(state.range(0));
+    M map;
+    map.reserve(std::size(inserted));
+    for(size_t i = 0; i < std::size(inserted); ++i) map.insert(inserted[i], i);
+
+    std::mt19937_64 random{std::size(inserted)};
+    std::vector<rfc4122::uuid> probes(std::min(LOOKUPS, std::size(inserted)));
+    for(auto& probe: probes) probe = inserted[random() % std::size(inserted)];
+    for(auto _: state)
+    {
+        uint64_t sum = 0u;
+        for(const auto& probe: probes) sum += map.find(probe);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(probes));
+}
+
+// Growth included, the way caches fill up in practice.
+template<typename M>
+void insert(benchmark::State& state)
+{
+    const auto inserted = keys(state.range(0));
+    for(auto _: state)
+    {
+        M map;
+        for(size_t i = 0; i < std::size(inserted); ++i) map.insert(inserted[i], i);
+        benchmark::DoNotOptimize(&map);
+        state.PauseTiming();
+        map = M{};
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(inserted));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(lookup, std_map)->Apply(map_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(lookup, flat_map<rfc4122::uuid_hash>)->Apply(map_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(lookup, flat_map<rfc4122::uuid_bits_hash>)->Apply(map_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(insert, std_map)->Apply(map_sizes)->Unit(benchmark::kMillisecond)->Iterations(1);
+BENCHMARK_TEMPLATE(insert, flat_map<rfc4122::uuid_hash>)->Apply(map_sizes)->Unit(benchmark::kMillisecond)->Iterations(1);
+BENCHMARK_TEMPLATE(insert, flat_map<rfc4122::uuid_bits_hash>)->Apply(map_sizes)->Unit(benchmark::kMillisecond)->Iterations(1);
@@ -0,0 +1,80 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/metrics.h>
+#include <rfc4122/uuid.h>
+
+
+
+namespace
+{
+
+// Run once in a default build and once with -DUUID_ENABLE_METRICS=ON: the
+// first must match from_string, to_literal and generate_uuid of a tree
+// without metrics, the second shows what the counters and clocks cost.
+void label(benchmark::State& state)
+{
+    state.SetLabel(rfc4122::METRICS_ENABLED ? "metrics on" : "metrics off");
+}
+
+void metered_parse(benchmark::State& state)
+{
+    std::vector<std::string> texts(1024);
+    for(auto& text: texts) text = rfc4122::to_string(rfc4122::generate_uuid());
+    for(auto _: state)
+    {
+        for(const auto& text: texts) benchmark::DoNotOptimize(rfc4122::from_string(std::data(text), std::size(text)));
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(texts));
+    label(state);
+}
+
+void metered_format(benchmark::State& state)
+{
+    std::vector<rfc4122::uuid> ids(1024);
+    rfc4122::generate_n(ids);
+    rfc4122::literal<char> buffer{};
+    for(auto _: state)
+    {
+        for(const auto& id: ids)
+        {
+            rfc4122::to_literal(buffer, id);
+            benchmark::DoNotOptimize(buffer);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+    label(state);
+}
+
+void metered_generate(benchmark::State& state)
+{
+    for(auto _: state) benchmark::DoNotOptimize(rfc4122::generate_uuid());
+    state.SetItemsProcessed(state.iterations());
+    label(state);
+}
+
+void metrics_snapshot(benchmark::State& state)
+{
+    for(auto _: state) benchmark::DoNotOptimize(rfc4122::collect_metrics());
+    label(state);
+}
+
+void prometheus_text(benchmark::State& state)
+{
+    const auto snapshot = rfc4122::collect_metrics();
+    for(auto _: state) benchmark::DoNotOptimize(rfc4122::to_prometheus(snapshot));
+    label(state);
+}
+
+} // namespace
+
+BENCHMARK(metered_parse);
+BENCHMARK(metered_format);
+BENCHMARK(metered_generate)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(metrics_snapshot);
+BENCHMARK(prometheus_text);
@@ -0,0 +1,109 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/page_file.h>
+
+
+
+namespace
+{
+
+// Sorted reordered time ids, so both the value and the time statistics of
+// the pages are tight.
+const std::filesystem::path& page_path(const size_t count)
+{
+    static const auto path = std::filesystem::temp_directory_path() / "rfc4122_bench.pages";
+    static size_t written = 0;
+    if(written != count)
+    {
+        std::vector<rfc4122::uuid> ids(count);
+        rfc4122::generate_reordered_time_n(ids);
+        std::sort(std::begin(ids), std::end(ids));
+        rfc4122::page_file_writer writer{path};
+        writer.write(ids);
+        writer.close();
+        written = count;
+    }
+    return path;
+}
+
+// The range covers 1/64 of the file.
+std::pair<rfc4122::uuid, rfc4122::uuid> range_of(const rfc4122::page_file& file)
+{
+    const auto ids = file.ids();
+    return {ids[std::size(ids) / 2], ids[std::size(ids) / 2 + std::size(ids) / 64]};
+}
+
+void full_scan_select(benchmark::State& state)
+{
+    const rfc4122::page_file file{page_path(state.range(0))};
+    const auto [low, high] = range_of(file);
+    for(auto _: state)
+    {
+        const auto ids = file.ids();
+        const size_t found = std::count_if(std::begin(ids), std::end(ids), [&](const auto& id) {return low <= id && id <= high;});
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void page_select(benchmark::State& state)
+{
+    const rfc4122::page_file file{page_path(state.range(0))};
+    const auto [low, high] = range_of(file);
+    for(auto _: state)
+    {
+        size_t found = 0;
+        for(const auto& run: file.select(low, high)) found += std::size(run);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void full_scan_select_time(benchmark::State& state)
+{
+    const rfc4122::page_file file{page_path(state.range(0))};
+    const auto [low, high] = range_of(file);
+    const auto from = *rfc4122::to_time_point(low);
+    const auto to   = *rfc4122::to_time_point(high);
+    for(auto _: state)
+    {
+        const auto ids = file.ids();
+        const size_t found = std::count_if(std::begin(ids), std::end(ids), [&](const auto& id)
+        {
+            const auto time = rfc4122::to_time_point(id);
+            return time && from <= *time && *time <= to;
+        });
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void page_select_time(benchmark::State& state)
+{
+    const rfc4122::page_file file{page_path(state.range(0))};
+    const auto [low, high] = range_of(file);
+    const auto from = std::chrono::time_point_cast<rfc4122::uuid_time_point::duration>(*rfc4122::to_time_point(low));
+    const auto to   = std::chrono::time_point_cast<rfc4122::uuid_time_point::duration>(*rfc4122::to_time_point(high));
+    for(auto _: state)
+    {
+        size_t found = 0;
+        for(const auto& run: file.select_time(from, to)) found += std::size(run);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(full_scan_select)->Arg(1 << 22);
+BENCHMARK(page_select)->Arg(1 << 22);
+BENCHMARK(full_scan_select_time)->Arg(1 << 22);
+BENCHMARK(page_select_time)->Arg(1 << 22);
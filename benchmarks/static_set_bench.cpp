@@ -0,0 +1,90 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <array>
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/map.h>
+#include <rfc4122/static_set.h>
+
+
+
+namespace
+{
+
+using rfc4122::uuid;
+
+// A few hundred well-known ids, as type or tenant tables have.
+constexpr auto KNOWN_IDS = []
+{
+    std::array<uuid, 300> ids{};
+    uint64_t state = 0x2545f4914f6cdd1du;
+    for(auto& id: ids)
+    {
+        state = rfc4122::hash(uuid{state, ~state});
+        const uint64_t high = state;
+        state = rfc4122::hash(uuid{state, ~state});
+        id = uuid{(high & ~uint64_t{0xF000}) | 0x4000u, (state & ~(uint64_t{3} << 62)) | (uint64_t{2} << 62)};
+    }
+    return ids;
+}();
+
+constexpr rfc4122::static_uuid_set KNOWN{KNOWN_IDS};
+
+// Every other message carries a known id.
+std::vector<uuid> messages()
+{
+    std::vector<uuid> ids(4096);
+    rfc4122::generate_n(ids);
+    for(size_t i = 0; i < std::size(ids); i += 2) ids[i] = KNOWN_IDS[(i * 40503u) % std::size(KNOWN_IDS)];
+    return ids;
+}
+
+template<typename F>
+void match(benchmark::State& state, const F& contains)
+{
+    const auto ids = messages();
+    for(auto _: state)
+    {
+        size_t matched = 0u;
+        for(const auto& id: ids) matched += contains(id);
+        benchmark::DoNotOptimize(matched);
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(ids));
+}
+
+void static_set(benchmark::State& state)
+{
+    match(state, [](const uuid& id) {return KNOWN.contains(id);});
+}
+
+void flat_map(benchmark::State& state)
+{
+    rfc4122::uuid_map<uint32_t> map;
+    for(uint32_t i = 0; i < std::size(KNOWN_IDS); ++i) map.try_emplace(KNOWN_IDS[i], i);
+    match(state, [&](const uuid& id) {return nullptr != map.find(id);});
+}
+
+void unordered_set(benchmark::State& state)
+{
+    const std::unordered_set<uuid> set(std::begin(KNOWN_IDS), std::end(KNOWN_IDS));
+    match(state, [&](const uuid& id) {return set.contains(id);});
+}
+
+void sorted_vector(benchmark::State& state)
+{
+    std::vector<uuid> sorted(std::begin(KNOWN_IDS), std::end(KNOWN_IDS));
+    std::sort(std::begin(sorted), std::end(sorted));
+    match(state, [&](const uuid& id) {return std::binary_search(std::begin(sorted), std::end(sorted), id);});
+}
+
+} // namespace
+
+BENCHMARK(static_set);
+BENCHMARK(flat_map);
+BENCHMARK(unordered_set);
+BENCHMARK(sorted_vector);
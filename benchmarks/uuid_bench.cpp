@@ -0,0 +1,219 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <rfc4122/fields.h>
+#include <rfc4122/uuid.h>
+#include "random_ids.h"
+
+
+
+// Every benchmark here runs over batches of ids and reports time per id
+// (items) and per text or binary byte. The batch sizes are taken from
+// UUID_BENCH_BATCH_SIZES, e.g. "16,1024,65536", and default to 1, 64 and
+// 4096. Runs are diffed with the library's own JSON output:
+//   uuid_bench --benchmark_out=run.json --benchmark_out_format=json
+//   compare.py benchmarks before.json after.json
+
+namespace
+{
+
+void batch_sizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgName("batch");
+    const char* sizes = std::getenv("UUID_BENCH_BATCH_SIZES");
+    if(nullptr == sizes || '\0' == *sizes) sizes = "1,64,4096";
+    for(char* end = nullptr; ; sizes = end + 1)
+    {
+        const long long size = std::strtoll(sizes, &end, 10);
+        if(end == sizes) break;
+        if(size > 0) benchmark->Arg(size);
+        if(',' != *end) break;
+    }
+}
+
+void per_id(benchmark::State& state, const size_t count, const size_t bytes_per_id)
+{
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * count * bytes_per_id);
+}
+
+template<typename C>
+void to_literal(benchmark::State& state)
+{
+    const auto ids = random_ids(state.range(0));
+    rfc4122::literal<C> buffer{};
+    for(auto _: state)
+    {
+        for(const auto& id: ids)
+        {
+            rfc4122::to_literal(buffer, id);
+            benchmark::DoNotOptimize(buffer);
+        }
+    }
+    per_id(state, std::size(ids), rfc4122::UUID_STRING_LENGTH * sizeof(C));
+}
+
+template<typename S>
+void to_basic_string(benchmark::State& state)
+{
+    const auto ids = random_ids(state.range(0));
+    for(auto _: state)
+    {
+        for(const auto& id: ids) benchmark::DoNotOptimize(rfc4122::to_basic_string<S>(id));
+    }
+    per_id(state, std::size(ids), rfc4122::UUID_STRING_LENGTH * sizeof(typename S::value_type));
+}
+
+template<typename S>
+void from_string(benchmark::State& state)
+{
+    std::vector<S> texts;
+    for(const auto& id: random_ids(state.range(0))) texts.push_back(rfc4122::to_basic_string<S>(id));
+    for(auto _: state)
+    {
+        for(const auto& text: texts) benchmark::DoNotOptimize(rfc4122::from_string(std::data(text), std::size(text)));
+    }
+    per_id(state, std::size(texts), rfc4122::UUID_STRING_LENGTH * sizeof(typename S::value_type));
+}
+
+void parse(benchmark::State& state)
+{
+    std::string text;
+    for(const auto& id: random_ids(state.range(0))) text += rfc4122::to_string(id) + '\n';
+    std::istringstream input;
+    for(auto _: state)
+    {
+        input.clear();
+        input.str(text);
+        rfc4122::uuid id{};
+        while(rfc4122::parse(input, id)) benchmark::DoNotOptimize(id);
+    }
+    per_id(state, state.range(0), rfc4122::UUID_STRING_LENGTH + 1u);
+}
+
+// Neighbours are compared, so the outcome is not predictable.
+void compare(benchmark::State& state)
+{
+    auto ids = random_ids(state.range(0) + 1);
+    for(size_t i = 1; i < std::size(ids); i += 2) ids[i] = ids[i - 1];
+    for(auto _: state)
+    {
+        for(size_t i = 1; i < std::size(ids); ++i)
+        {
+            benchmark::DoNotOptimize(ids[i - 1] == ids[i]);
+            benchmark::DoNotOptimize(ids[i - 1] <  ids[i]);
+            benchmark::DoNotOptimize(ids[i - 1] <=> ids[i]);
+        }
+    }
+    per_id(state, std::size(ids) - 1u, 2u * sizeof(rfc4122::uuid));
+}
+
+void parts(benchmark::State& state)
+{
+    const auto ids = random_ids(state.range(0));
+    for(auto _: state)
+    {
+        for(const auto& id: ids)
+        {
+            benchmark::DoNotOptimize(id.part1());
+            benchmark::DoNotOptimize(id.part2());
+            benchmark::DoNotOptimize(id.part3());
+            benchmark::DoNotOptimize(id.part4());
+            benchmark::DoNotOptimize(id.part5());
+        }
+    }
+    per_id(state, std::size(ids), sizeof(rfc4122::uuid));
+}
+
+void time_fields(benchmark::State& state)
+{
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    rfc4122::generate_time_based_n(ids);
+    for(auto _: state)
+    {
+        for(const auto& id: ids)
+        {
+            benchmark::DoNotOptimize(id.timestamp());
+            benchmark::DoNotOptimize(id.clock_sequence());
+            benchmark::DoNotOptimize(id.node());
+        }
+    }
+    per_id(state, std::size(ids), sizeof(rfc4122::uuid));
+}
+
+// The same fields, and the time, decoded into columns.
+void extract_fields(benchmark::State& state)
+{
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    rfc4122::generate_time_based_n(ids);
+    std::vector<rfc4122::uuid_time_point> times(std::size(ids));
+    std::vector<uint16_t> clock_sequences(std::size(ids));
+    std::vector<uint64_t> nodes(std::size(ids));
+    for(auto _: state)
+    {
+        rfc4122::extract_fields(ids, {.times = times, .clock_sequences = clock_sequences, .nodes = nodes, .versions = {}, .variants = {}});
+        benchmark::ClobberMemory();
+    }
+    per_id(state, std::size(ids), sizeof(rfc4122::uuid));
+}
+
+// Converts back and forth, so every round rewrites every id twice.
+void reorder_time(benchmark::State& state)
+{
+    std::vector<rfc4122::uuid> ids(state.range(0));
+    rfc4122::generate_time_based_n(ids);
+    for(auto _: state)
+    {
+        benchmark::DoNotOptimize(rfc4122::to_reordered_time_n(ids));
+        benchmark::DoNotOptimize(rfc4122::to_time_based_n(ids));
+    }
+    per_id(state, 2u * std::size(ids), sizeof(rfc4122::uuid));
+}
+
+void generate_name_based(benchmark::State& state, rfc4122::uuid (*generate)(const rfc4122::uuid&, std::string_view) noexcept)
+{
+    std::vector<std::string> names;
+    for(const auto& id: random_ids(state.range(0))) names.push_back("www." + rfc4122::to_string(id) + ".example");
+    for(auto _: state)
+    {
+        for(const auto& name: names) benchmark::DoNotOptimize(generate(rfc4122::NAMESPACE_DNS, name));
+    }
+    per_id(state, std::size(names), sizeof(rfc4122::uuid));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(to_literal, char    )->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(to_literal, char8_t )->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(to_literal, wchar_t )->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(to_literal, char16_t)->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(to_literal, char32_t)->Apply(batch_sizes);
+
+BENCHMARK_TEMPLATE(to_basic_string, std::string   )->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(to_basic_string, std::u8string )->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(to_basic_string, std::wstring  )->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(to_basic_string, std::u16string)->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(to_basic_string, std::u32string)->Apply(batch_sizes);
+
+BENCHMARK_TEMPLATE(from_string, std::string   )->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(from_string, std::u8string )->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(from_string, std::wstring  )->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(from_string, std::u16string)->Apply(batch_sizes);
+BENCHMARK_TEMPLATE(from_string, std::u32string)->Apply(batch_sizes);
+
+BENCHMARK(parse)->Apply(batch_sizes);
+BENCHMARK(compare)->Apply(batch_sizes);
+BENCHMARK(parts)->Apply(batch_sizes);
+BENCHMARK(time_fields)->Apply(batch_sizes);
+BENCHMARK(extract_fields)->Apply(batch_sizes);
+BENCHMARK(reorder_time)->Apply(batch_sizes);
+BENCHMARK_CAPTURE(generate_name_based, md5 , rfc4122::generate_md5_uuid )->Apply(batch_sizes);
+BENCHMARK_CAPTURE(generate_name_based, sha1, rfc4122::generate_sha1_uuid)->Apply(batch_sizes);
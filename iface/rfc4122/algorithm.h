@@ -0,0 +1,21 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <span>
+
+#include <rfc4122/uuid.h>
+
+
+
+namespace rfc4122
+{
+
+    // Sorts in the order of operator<=>. Large arrays take a radix sort over
+    // the 16 octets, most significant first: the first pass is split between
+    // `threads` (0: one per core), the buckets it makes are then sorted side
+    // by side. Octets equal in every id of a bucket cost no pass.
+    void sort(const std::span<uuid> ids, unsigned threads = 0u);
+
+} // namespace rfc4122
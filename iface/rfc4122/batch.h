@@ -0,0 +1,110 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include <rfc4122/uuid.h>
+#include <rfc4122/simd.h>
+
+
+
+namespace rfc4122
+{
+    namespace __internal
+    {
+
+        // Formats every id of `ids` into `buffer`, which must hold
+        // `literals_size(std::size(ids), delimiter.has_value())` characters.
+        void to_literals(   const instruction_set kernel
+                          , const std::span<const uuid> ids
+                          , char* const buffer
+                          , const std::optional<char> delimiter ) noexcept;
+
+    } // __internal
+
+    struct literals_result
+    {
+        size_t count    = 0u; // records stored into ids
+        size_t invalid  = 0u; // records among them that are not well-formed
+        size_t consumed = 0u; // characters of text covered by these records
+    };
+
+    namespace __internal
+    {
+
+        literals_result from_literals(   const instruction_set kernel
+                                       , const std::string_view text
+                                       , const std::span<uuid> ids
+                                       , const std::span<uint64_t> validity
+                                       , const char delimiter ) noexcept;
+
+    } // __internal
+
+    constexpr size_t literals_size(const size_t count, const bool delimited) noexcept
+    {
+        return count * (UUID_STRING_LENGTH + (delimited ? 1u : 0u));
+    }
+
+    // Writes as many whole literals of `ids` as `buffer` can hold, each one
+    // followed by `delimiter` when it is given, and returns the number of
+    // characters written.
+    template<typename C>
+    size_t to_literals(   const std::span<const uuid> ids
+                        , const std::span<C> buffer
+                        , const std::type_identity_t<std::optional<C>> delimiter = std::nullopt ) noexcept
+    {
+        const size_t stride = literals_size(1u, delimiter.has_value());
+        const size_t count  = std::min(std::size(ids), std::size(buffer) / stride);
+        if constexpr (sizeof(C) == sizeof(char))
+        {
+            const __internal::meter timer{metered_operation::format};
+            const auto narrow = delimiter ? std::optional<char>{static_cast<char>(*delimiter)} : std::nullopt;
+            __internal::to_literals( __internal::detected_instruction_set()
+                                   , ids.first(count)
+                                   , reinterpret_cast<char*>(std::data(buffer))
+                                   , narrow );
+            timer.done(count);
+        }
+        else
+        {
+            C* symbol = std::data(buffer);
+            for(const uuid& id: ids.first(count))
+            {
+                literal<C> text{};
+                to_literal(text, id);
+                std::copy_n(std::data(text), UUID_STRING_LENGTH, symbol);
+                symbol += UUID_STRING_LENGTH;
+                if(delimiter) *symbol++ = *delimiter;
+            }
+        }
+        return count * stride;
+    }
+
+    constexpr size_t validity_size(const size_t count) noexcept
+    {
+        return (count + 63u) / 64u;
+    }
+
+    // Parses `delimiter`-separated records of `text` into `ids`, one id per
+    // record; a trailing carriage return of a record is ignored and the last
+    // record does not need a delimiter. Bit `i % 64` of `validity[i / 64]` is
+    // set when record `i` is a well-formed literal, otherwise `ids[i]` is
+    // NIL_UUID. Stops when either `ids` or `validity` is full.
+    inline literals_result from_literals(   const std::string_view text
+                                          , const std::span<uuid> ids
+                                          , const std::span<uint64_t> validity
+                                          , const char delimiter = '\n' ) noexcept
+    {
+        const __internal::meter timer{metered_operation::parse};
+        const auto result = __internal::from_literals(__internal::detected_instruction_set(), text, ids, validity, delimiter);
+        timer.done(result.count, result.invalid);
+        return result;
+    }
+
+} // namespace rfc4122
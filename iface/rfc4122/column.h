@@ -0,0 +1,114 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <rfc4122/uuid.h>
+#include <rfc4122/file.h>
+
+
+
+namespace rfc4122
+{
+
+    // Immutable sorted set of ids in blocks of BLOCK_SIZE. Bits that are the
+    // same in every id (version, variant, shared time prefixes) are dropped,
+    // the rest are stored as differences between neighbours, bit packed at
+    // the width of each block's largest one. The first id of every block is
+    // kept whole in an index, so a lookup binary searches the index and
+    // decodes a single block. The container is one flat image that save()
+    // writes out and the path constructor maps back in place; it is in host
+    // byte order.
+    class sorted_column
+    {
+    public:
+        static constexpr size_t BLOCK_SIZE = 64u;
+
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = uuid;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = uuid;
+            using pointer           = void;
+
+            iterator() noexcept = default;
+
+            uuid operator * () const noexcept;
+            iterator& operator ++ () noexcept;
+            iterator operator ++ (int) noexcept {auto copy = *this; ++*this; return copy;}
+            bool operator == (const iterator& other) const noexcept {return position == other.position;}
+
+        private:
+            friend class sorted_column;
+
+            void enter(const size_t block) noexcept;
+
+            const sorted_column* column = nullptr;
+            size_t position = 0u;
+            const uint8_t* block = nullptr;
+            size_t width = 0u;
+            size_t bit = 0u;
+            uint64_t high = 0u;
+            uint64_t low = 0u;
+        };
+
+        sorted_column() noexcept = default;
+
+        // Sorts a copy of `ids`, duplicates are kept once.
+        explicit sorted_column(const std::span<const uuid> ids);
+
+        // Maps a file written by save(). Errors are reported with std::system_error.
+        explicit sorted_column(const std::filesystem::path& path);
+
+        sorted_column(sorted_column&& other) noexcept;
+        sorted_column& operator = (sorted_column&& other) noexcept;
+
+        size_t size() const noexcept {return count;}
+        bool empty() const noexcept {return 0u == count;}
+        std::span<const std::byte> bytes() const noexcept {return image;}
+
+        iterator begin() const noexcept;
+        iterator end() const noexcept;
+
+        // First id not less than `key`.
+        iterator lower_bound(const uuid& key) const noexcept;
+        bool contains(const uuid& key) const noexcept;
+
+        void save(const std::filesystem::path& path) const;
+
+    private:
+        bool attach(std::span<const std::byte> bytes) noexcept;
+        uuid first_key(const size_t block) const noexcept;
+        uint64_t block_offset(const size_t block) const noexcept;
+        std::pair<uint64_t, uint64_t> compact(const uuid& id) const noexcept;
+        uuid expand(const uint64_t high, const uint64_t low) const noexcept;
+
+        // Runs of stored bits, as (first bit, bit count) from the least
+        // significant end; the bits between them are `fixed` in every id.
+        static constexpr size_t MAX_RUNS = 8u;
+        uint8_t runs[MAX_RUNS][2] = {};
+        size_t runs_count = 0u;
+        uint64_t fixed_high = 0u;
+        uint64_t fixed_low = 0u;
+
+        std::vector<std::byte> owned;
+        mapped_file file;
+        std::span<const std::byte> image;
+        size_t count = 0u;
+        size_t blocks = 0u;
+        const std::byte* keys = nullptr;
+        const std::byte* offsets = nullptr;
+        const uint8_t* payload = nullptr;
+    };
+
+} // namespace rfc4122
@@ -0,0 +1,369 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <rfc4122/uuid.h>
+#include <rfc4122/map.h>
+
+
+
+namespace rfc4122
+{
+    namespace __internal
+    {
+
+        // Linear probing table whose readers run without a lock. Writers keep
+        // it consistent between two increments of `sequence`; readers copy
+        // what they find and retry when the sequence has moved. Erase shifts
+        // later entries back instead of leaving tombstones, so a table only
+        // ever grows by doubling.
+        template<typename V>
+        class seqlock_table
+        {
+        public:
+            struct slot
+            {
+                uuid key;
+                V value;
+            };
+
+            explicit seqlock_table(const size_t capacity)
+                : mask{capacity - 1u}
+                , controls{static_cast<uint8_t*>(::operator new(capacity, std::align_val_t{64}))}
+                , slots{static_cast<slot*>(::operator new(capacity * sizeof(slot), std::align_val_t{64}))}
+            {
+                std::memset(controls, 0, capacity);
+            }
+
+            ~seqlock_table()
+            {
+                ::operator delete(controls, std::align_val_t{64});
+                ::operator delete(slots, std::align_val_t{64});
+            }
+
+            seqlock_table(const seqlock_table&) = delete;
+            seqlock_table& operator = (const seqlock_table&) = delete;
+
+            size_t capacity() const noexcept {return mask + 1u;}
+
+            // Nonzero control of a full slot: the top bit and hash bits 41 to
+            // 47, below those of the shard. The top two bits of the hash are
+            // the fixed variant with uuid_bits_hash, they tell no keys apart.
+            static uint8_t control_of(const size_t hash) noexcept
+            {
+                return static_cast<uint8_t>(0x80u | ((static_cast<uint64_t>(hash) >> 41) & 0x7Fu));
+            }
+
+            uint8_t control(const size_t index) const noexcept
+            {
+                return std::atomic_ref<uint8_t>{controls[index]}.load(std::memory_order_relaxed);
+            }
+
+            void set_control(const size_t index, const uint8_t value) noexcept
+            {
+                std::atomic_ref<uint8_t>{controls[index]}.store(value, std::memory_order_relaxed);
+            }
+
+            // Writers only. Index of `key`, or of the empty slot ending its probe.
+            size_t locate(const uuid& key, const size_t hash) const noexcept
+            {
+                const uint8_t wanted = control_of(hash);
+                for(size_t index = hash & mask; ; index = (index + 1u) & mask)
+                {
+                    const uint8_t found = controls[index];
+                    if(0u == found || (wanted == found && slots[index].key == key)) return index;
+                }
+            }
+
+            // Readers. Copies the value of `key` into `value`, the result is
+            // only meaningful if the sequence did not move meanwhile.
+            bool read(const uuid& key, const size_t hash, std::array<std::byte, sizeof(V)>& value) const noexcept
+            {
+                const uint8_t wanted = control_of(hash);
+                for(size_t index = hash & mask, probes = 0u; probes <= mask; index = (index + 1u) & mask, ++probes)
+                {
+                    const uint8_t found = control(index);
+                    if(0u == found) return false;
+                    if(wanted != found) continue;
+                    uuid candidate{};
+                    std::memcpy(static_cast<void*>(&candidate), &slots[index].key, sizeof(uuid));
+                    if(candidate != key) continue;
+                    std::memcpy(std::data(value), &slots[index].value, sizeof(V));
+                    return true;
+                }
+                return false;
+            }
+
+            void store(const size_t index, const uuid& key, const size_t hash, const V& value) noexcept
+            {
+                new(slots + index) slot{key, value};
+                set_control(index, control_of(hash));
+            }
+
+            // Backward shift deletion: later entries of the same run move up
+            // into the hole as long as that does not take them before their
+            // home slot.
+            template<typename H>
+            void remove(size_t hole, const H& hasher) noexcept
+            {
+                for(size_t index = (hole + 1u) & mask; 0u != controls[index]; index = (index + 1u) & mask)
+                {
+                    const size_t home = hasher(slots[index].key) & mask;
+                    if(((index - home) & mask) < ((index - hole) & mask)) continue;
+                    std::memcpy(static_cast<void*>(slots + hole), slots + index, sizeof(slot));
+                    set_control(hole, controls[index]);
+                    hole = index;
+                }
+                set_control(hole, 0u);
+            }
+
+            const slot& at(const size_t index) const noexcept {return slots[index];}
+            slot& at(const size_t index) noexcept {return slots[index];}
+            bool full(const size_t index) const noexcept {return 0u != controls[index];}
+
+        private:
+            const size_t mask;
+            uint8_t* const controls;
+            slot* const slots;
+        };
+
+    } // __internal
+
+    // Hash map from ids to small trivially copyable values for tables that
+    // many threads read and some write. Keys are spread over shards, each
+    // with its own writer mutex and sequence lock; lookups take no lock and
+    // write nothing shared, they copy the value out and retry if a writer
+    // was busy in the shard. A lookup that keeps losing to writers takes the
+    // shard's mutex in the end, so it always finishes.
+    //
+    // Shards and slots come from the hash: bits 48 and up pick the shard, the
+    // seven below them tag full slots and the low bits pick the slot. With
+    // uuid_bits_hash they are the id's own random bits, fine for version 4
+    // keys; uuid_hash suits any id.
+    //
+    // A shard that grows keeps its old table until the map is destroyed, as a
+    // reader may still be in it; the old tables together are never larger
+    // than the current one.
+    template<typename V, typename H = uuid_hash>
+    class concurrent_uuid_map
+    {
+        static_assert(std::is_trivially_copyable_v<V>, "values are copied out while writers may be changing them");
+
+    public:
+        static constexpr size_t MAX_SHARDS = size_t{1} << 14;
+
+        // `shards` is rounded up to a power of two; zero picks four per
+        // hardware thread.
+        explicit concurrent_uuid_map(const size_t shards = 0u, const H& hasher = H{})
+            : hasher{hasher}
+            , shard_mask{std::bit_ceil(std::clamp<size_t>(0u != shards ? shards : 4u * std::max(1u, std::thread::hardware_concurrency()), 1u, MAX_SHARDS)) - 1u}
+            , shards{std::make_unique<shard[]>(shard_mask + 1u)}
+        {}
+
+        concurrent_uuid_map(const concurrent_uuid_map&) = delete;
+        concurrent_uuid_map& operator = (const concurrent_uuid_map&) = delete;
+
+        size_t shards_count() const noexcept {return shard_mask + 1u;}
+
+        // Exact only while no one writes.
+        size_t size() const noexcept
+        {
+            size_t total = 0u;
+            for(size_t index = 0; index <= shard_mask; ++index) total += shards[index].count.load(std::memory_order_relaxed);
+            return total;
+        }
+
+        std::optional<V> find(const uuid& key) const
+        {
+            const size_t hash = hasher(key);
+            const shard& home = shard_of(hash);
+            std::array<std::byte, sizeof(V)> value;
+            for(int attempt = 0; attempt < OPTIMISTIC_ATTEMPTS; ++attempt)
+            {
+                const uint64_t before = home.sequence.load(std::memory_order_acquire);
+                if(0u != (before & 1u))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                const table* const current = home.current.load(std::memory_order_acquire);
+                const bool found = nullptr != current && current->read(key, hash, value);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(before == home.sequence.load(std::memory_order_relaxed))
+                {
+                    return found ? std::optional<V>{std::bit_cast<V>(value)} : std::nullopt;
+                }
+            }
+
+            const std::lock_guard lock{home.writer};
+            const table* const current = home.current.load(std::memory_order_relaxed);
+            if(nullptr == current || !current->read(key, hash, value)) return std::nullopt;
+            return std::bit_cast<V>(value);
+        }
+
+        bool contains(const uuid& key) const
+        {
+            return find(key).has_value();
+        }
+
+        // Both return true if the key was not there before.
+        bool insert(const uuid& key, const V& value)
+        {
+            return write(key, value, false);
+        }
+
+        bool insert_or_assign(const uuid& key, const V& value)
+        {
+            return write(key, value, true);
+        }
+
+        // Calls function(value) under the shard's lock, value being a V& to
+        // change in place; false if the key is absent.
+        template<typename F>
+        bool update(const uuid& key, F&& function)
+        {
+            const size_t hash = hasher(key);
+            shard& home = shard_of(hash);
+            const std::lock_guard lock{home.writer};
+            table* const current = home.current.load(std::memory_order_relaxed);
+            if(nullptr == current) return false;
+            const size_t index = current->locate(key, hash);
+            if(!current->full(index)) return false;
+
+            V value = current->at(index).value;
+            function(value);
+            begin_write(home);
+            current->at(index).value = value;
+            end_write(home);
+            return true;
+        }
+
+        bool erase(const uuid& key)
+        {
+            const size_t hash = hasher(key);
+            shard& home = shard_of(hash);
+            const std::lock_guard lock{home.writer};
+            table* const current = home.current.load(std::memory_order_relaxed);
+            if(nullptr == current) return false;
+            const size_t index = current->locate(key, hash);
+            if(!current->full(index)) return false;
+
+            begin_write(home);
+            current->remove(index, hasher);
+            end_write(home);
+            home.count.fetch_sub(1u, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Calls function(key, value) for every entry, one shard locked at a time.
+        template<typename F>
+        void for_each(F&& function) const
+        {
+            for(size_t index = 0; index <= shard_mask; ++index)
+            {
+                const shard& part = shards[index];
+                const std::lock_guard lock{part.writer};
+                const table* const current = part.current.load(std::memory_order_relaxed);
+                if(nullptr == current) continue;
+                for(size_t slot = 0; slot < current->capacity(); ++slot)
+                {
+                    if(current->full(slot)) function(current->at(slot).key, current->at(slot).value);
+                }
+            }
+        }
+
+    private:
+        using table = __internal::seqlock_table<V>;
+
+        static constexpr int OPTIMISTIC_ATTEMPTS = 64;
+        static constexpr size_t INITIAL_CAPACITY = 16u;
+
+        struct alignas(64) shard
+        {
+            std::atomic<uint64_t> sequence{0u};
+            std::atomic<table*> current{nullptr};
+            std::atomic<size_t> count{0u};
+            mutable std::mutex writer;
+            std::vector<std::unique_ptr<table>> tables;
+        };
+
+        shard& shard_of(const size_t hash) const noexcept
+        {
+            return shards[(static_cast<uint64_t>(hash) >> 48) & shard_mask];
+        }
+
+        static void begin_write(shard& part) noexcept
+        {
+            part.sequence.store(part.sequence.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        static void end_write(shard& part) noexcept
+        {
+            part.sequence.store(part.sequence.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+        }
+
+        bool write(const uuid& key, const V& value, const bool assign)
+        {
+            const size_t hash = hasher(key);
+            shard& home = shard_of(hash);
+            const std::lock_guard lock{home.writer};
+            table* current = home.current.load(std::memory_order_relaxed);
+            const size_t count = home.count.load(std::memory_order_relaxed);
+
+            size_t index = nullptr != current ? current->locate(key, hash) : 0u;
+            const bool inserted = nullptr == current || !current->full(index);
+            if(!inserted && !assign) return false;
+
+            // Load factor stays at or below 7/8; readers of the old table
+            // notice the sequence move and look again in the new one.
+            if(inserted && (nullptr == current || (count + 1u) * 8u > current->capacity() * 7u))
+            {
+                auto grown = std::make_unique<table>(nullptr == current ? INITIAL_CAPACITY : 2u * current->capacity());
+                if(nullptr != current)
+                {
+                    for(size_t index = 0; index < current->capacity(); ++index)
+                    {
+                        if(!current->full(index)) continue;
+                        const auto& entry = current->at(index);
+                        const size_t entry_hash = hasher(entry.key);
+                        grown->store(grown->locate(entry.key, entry_hash), entry.key, entry_hash, entry.value);
+                    }
+                }
+                home.tables.push_back(std::move(grown));
+                begin_write(home);
+                current = home.tables.back().get();
+                home.current.store(current, std::memory_order_release);
+                end_write(home);
+                index = current->locate(key, hash);
+            }
+
+            begin_write(home);
+            current->store(index, key, hash, value);
+            end_write(home);
+            if(inserted) home.count.fetch_add(1u, std::memory_order_relaxed);
+            return inserted;
+        }
+
+        [[no_unique_address]] H hasher{};
+        const size_t shard_mask;
+        const std::unique_ptr<shard[]> shards;
+    };
+
+} // namespace rfc4122
@@ -0,0 +1,280 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <rfc4122/uuid.h>
+#include <rfc4122/batch.h>
+#include <rfc4122/simd.h>
+
+
+
+namespace rfc4122
+{
+
+    // Compact text forms of the 128 bits, most significant first:
+    //   base64url - 22 symbols of RFC 4648 "A-Za-z0-9-_" without padding, the
+    //               last one carries 2 bits and its low 4 bits are zero;
+    //   base32    - 26 Crockford symbols, the first one carries 3 bits, so it
+    //               is never above '7'. Sorts like the ids themselves.
+    enum class text_encoding: uint8_t
+    {
+          base64url
+        , base32
+    };
+
+    static constexpr size_t BASE64URL_LENGTH = 22u;
+    static constexpr size_t BASE32_LENGTH    = 26u;
+
+    template<typename C>
+    using base64url_literal = C[BASE64URL_LENGTH + 1u];
+    template<typename C>
+    using base32_literal = C[BASE32_LENGTH + 1u];
+
+    constexpr size_t encoded_length(const text_encoding encoding) noexcept
+    {
+        return text_encoding::base64url == encoding ? BASE64URL_LENGTH : BASE32_LENGTH;
+    }
+
+    namespace __internal
+    {
+
+        static constexpr const char BASE64URL_LETTERS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+        static constexpr const char BASE32_LETTERS[]    = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+
+        // Crockford values of 'a'..'z' in either case; I and L read as 1, O as 0, U is not used.
+        static constexpr const int8_t BASE32_LETTER_VALUES[] =
+        {
+              10, 11, 12, 13, 14, 15, 16, 17,  1, 18, 19,  1, 20
+            , 21,  0, 22, 23, 24, 25, 26, -1, 27, 28, 29, 30, 31
+        };
+
+        template<typename C>
+        constexpr int base64url_value(const C symbol) noexcept
+        {
+            const auto code = static_cast<uint32_t>(symbol);
+            return    'A' <= code && code <= 'Z' ? static_cast<int>(code - 'A')
+                    : 'a' <= code && code <= 'z' ? static_cast<int>(code - 'a') + 26
+                    : '0' <= code && code <= '9' ? static_cast<int>(code - '0') + 52
+                    : '-' == code ? 62
+                    : '_' == code ? 63
+                    : -1;
+        }
+
+        template<typename C>
+        constexpr int base32_value(const C symbol) noexcept
+        {
+            const auto code = static_cast<uint32_t>(symbol);
+            return    '0' <= code && code <= '9' ? static_cast<int>(code - '0')
+                    : 'A' <= code && code <= 'Z' ? BASE32_LETTER_VALUES[code - 'A']
+                    : 'a' <= code && code <= 'z' ? BASE32_LETTER_VALUES[code - 'a']
+                    : -1;
+        }
+
+        // `width` bits of the 128-bit value high:low starting at bit `shift`.
+        constexpr uint32_t bits(const uint64_t high, const uint64_t low, const unsigned shift, const unsigned width) noexcept
+        {
+            const uint64_t window =   shift >= 64u ? high >> (shift - 64u)
+                                    : 0u == shift  ? low
+                                    : (low >> shift) | (high << (64u - shift));
+            return static_cast<uint32_t>(window & ((uint64_t{1} << width) - 1u));
+        }
+
+        constexpr void shift_in(uint64_t& high, uint64_t& low, const unsigned width, const uint32_t value) noexcept
+        {
+            high = (high << width) | (low >> (64u - width));
+            low  = (low  << width) | value;
+        }
+
+        // Decode exactly BASE64URL_LENGTH or BASE32_LENGTH symbols of `text`.
+        template<typename C>
+        constexpr bool decode_base64url(const C* const text, uuid& id) noexcept
+        {
+            uint64_t high = 0u;
+            uint64_t low  = 0u;
+            for(auto i = 0u; i + 1u < BASE64URL_LENGTH; ++i)
+            {
+                const int value = base64url_value(text[i]);
+                if(value < 0) return false;
+                shift_in(high, low, 6u, static_cast<uint32_t>(value));
+            }
+            const int last = base64url_value(text[BASE64URL_LENGTH - 1u]);
+            if(last < 0 || 0 != (last & 0x0F)) return false;
+            shift_in(high, low, 2u, static_cast<uint32_t>(last) >> 4);
+            id = uuid{high, low};
+            return true;
+        }
+
+        template<typename C>
+        constexpr bool decode_base32(const C* const text, uuid& id) noexcept
+        {
+            const int first = base32_value(text[0]);
+            if(first < 0 || first > 7) return false;
+            uint64_t high = 0u;
+            uint64_t low  = static_cast<uint64_t>(first);
+            for(auto i = 1u; i < BASE32_LENGTH; ++i)
+            {
+                const int value = base32_value(text[i]);
+                if(value < 0) return false;
+                shift_in(high, low, 5u, static_cast<uint32_t>(value));
+            }
+            id = uuid{high, low};
+            return true;
+        }
+
+        // Writes `encoded_size(encoding, std::size(ids), delimiter.has_value())`
+        // characters into `buffer`.
+        void encode_n(   const instruction_set kernel
+                       , const text_encoding encoding
+                       , const std::span<const uuid> ids
+                       , char* const buffer
+                       , const std::optional<char> delimiter ) noexcept;
+
+        literals_result decode_n(   const instruction_set kernel
+                                  , const text_encoding encoding
+                                  , const std::string_view text
+                                  , const std::span<uuid> ids
+                                  , const std::span<uint64_t> validity
+                                  , const char delimiter ) noexcept;
+
+    } // __internal
+
+    template<typename C>
+    constexpr void to_base64url(base64url_literal<C>& buffer, const uuid& id) noexcept
+    {
+        using namespace rfc4122::__internal;
+
+        const uint64_t high = id.high();
+        const uint64_t low  = id.low();
+        for(auto i = 0u; i + 1u < BASE64URL_LENGTH; ++i)
+        {
+            buffer[i] = BASE64URL_LETTERS[bits(high, low, 122u - 6u * i, 6u)];
+        }
+        buffer[BASE64URL_LENGTH - 1u] = BASE64URL_LETTERS[bits(high, low, 0u, 2u) << 4];
+    }
+
+    template<typename C>
+    constexpr void to_base32(base32_literal<C>& buffer, const uuid& id) noexcept
+    {
+        using namespace rfc4122::__internal;
+
+        const uint64_t high = id.high();
+        const uint64_t low  = id.low();
+        buffer[0] = BASE32_LETTERS[high >> 61];
+        for(auto i = 1u; i < BASE32_LENGTH; ++i)
+        {
+            buffer[i] = BASE32_LETTERS[bits(high, low, 125u - 5u * i, 5u)];
+        }
+    }
+
+    template<typename S = std::string>
+    S to_base64url(const uuid& id)
+    {
+        using C = typename S::value_type;
+        S string(BASE64URL_LENGTH, '\0');
+        auto& buffer = *static_cast<base64url_literal<C>*>(static_cast<void*>(std::data(string)));
+        to_base64url(buffer, id);
+        return string;
+    }
+
+    template<typename S = std::string>
+    S to_base32(const uuid& id)
+    {
+        using C = typename S::value_type;
+        S string(BASE32_LENGTH, '\0');
+        auto& buffer = *static_cast<base32_literal<C>*>(static_cast<void*>(std::data(string)));
+        to_base32(buffer, id);
+        return string;
+    }
+
+    // Both return NIL_UUID unless `text` is exactly one encoded id.
+    template<typename C>
+    constexpr uuid from_base64url(const C* const text, const size_t length) noexcept
+    {
+        uuid id{};
+        return BASE64URL_LENGTH == length && __internal::decode_base64url(text, id) ? id : uuid{};
+    }
+
+    template<typename C>
+    constexpr uuid from_base32(const C* const text, const size_t length) noexcept
+    {
+        uuid id{};
+        return BASE32_LENGTH == length && __internal::decode_base32(text, id) ? id : uuid{};
+    }
+
+    template<typename C, typename T>
+    constexpr uuid from_base64url(const std::basic_string_view<C,T>& text) noexcept
+    {
+        return from_base64url(std::data(text), std::size(text));
+    }
+
+    template<typename C, typename T>
+    constexpr uuid from_base32(const std::basic_string_view<C,T>& text) noexcept
+    {
+        return from_base32(std::data(text), std::size(text));
+    }
+
+    constexpr size_t encoded_size(const text_encoding encoding, const size_t count, const bool delimited) noexcept
+    {
+        return count * (encoded_length(encoding) + (delimited ? 1u : 0u));
+    }
+
+    // Batch forms of the above, laid out like to_literals() and from_literals().
+    template<typename C>
+    size_t encode_n(   const text_encoding encoding
+                     , const std::span<const uuid> ids
+                     , const std::span<C> buffer
+                     , const std::type_identity_t<std::optional<C>> delimiter = std::nullopt ) noexcept
+    {
+        const size_t stride = encoded_size(encoding, 1u, delimiter.has_value());
+        const size_t count  = std::min(std::size(ids), std::size(buffer) / stride);
+        if constexpr (sizeof(C) == sizeof(char))
+        {
+            const auto narrow = delimiter ? std::optional<char>{static_cast<char>(*delimiter)} : std::nullopt;
+            __internal::encode_n( __internal::detected_instruction_set()
+                                , encoding
+                                , ids.first(count)
+                                , reinterpret_cast<char*>(std::data(buffer))
+                                , narrow );
+        }
+        else
+        {
+            C* symbol = std::data(buffer);
+            for(const uuid& id: ids.first(count))
+            {
+                if(text_encoding::base64url == encoding)
+                {
+                    base64url_literal<C> text{};
+                    to_base64url(text, id);
+                    symbol = std::copy_n(text, BASE64URL_LENGTH, symbol);
+                }
+                else
+                {
+                    base32_literal<C> text{};
+                    to_base32(text, id);
+                    symbol = std::copy_n(text, BASE32_LENGTH, symbol);
+                }
+                if(delimiter) *symbol++ = *delimiter;
+            }
+        }
+        return count * stride;
+    }
+
+    inline literals_result decode_n(   const text_encoding encoding
+                                     , const std::string_view text
+                                     , const std::span<uuid> ids
+                                     , const std::span<uint64_t> validity
+                                     , const char delimiter = '\n' ) noexcept
+    {
+        return __internal::decode_n(__internal::detected_instruction_set(), encoding, text, ids, validity, delimiter);
+    }
+
+} // namespace rfc4122
@@ -0,0 +1,102 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <rfc4122/uuid.h>
+#include <rfc4122/simd.h>
+
+
+
+namespace rfc4122
+{
+
+    // Creation time in the 100ns ticks of time-based ids, which it holds
+    // exactly and without overflow for any timestamp; it converts to
+    // std::chrono::system_clock::time_point implicitly where that is exact.
+    using uuid_time_point = std::chrono::time_point<std::chrono::system_clock, __internal::gregorian_ticks>;
+
+    // Columns for extract_fields(). Empty ones are skipped, the others must
+    // be at least as long as the ids.
+    struct field_columns
+    {
+        std::span<uuid_time_point>  times;           // time_point::min() for ids without a time
+        std::span<uint16_t>         clock_sequences; // as clock_sequence()
+        std::span<uint64_t>         nodes;           // as node()
+        std::span<rfc4122::version> versions;        // as version()
+        std::span<rfc4122::variant> variants;        // as variant()
+    };
+
+    namespace __internal
+    {
+
+        // Octets 0-7 of a time-based id laid out as a reordered time one and
+        // back; octets 8-15 are the same in both.
+        constexpr uint64_t reordered_high(const uint64_t high) noexcept
+        {
+            return    ((high & 0x0FFFu) << 52)
+                    | ((high << 20) & 0x000FFFF000000000u)
+                    | ((high >> 28) & 0x0000000FFFFF0000u)
+                    | (uint64_t{static_cast<uint8_t>(version::reordered_time)} << 12)
+                    | ((high >> 32) & 0x0FFFu);
+        }
+
+        constexpr uint64_t time_based_high(const uint64_t high) noexcept
+        {
+            const uint64_t timestamp = ((high >> 16) << 12) | (high & 0x0FFFu);
+            return    (timestamp << 32)
+                    | ((timestamp >> 16) & 0xFFFF0000u)
+                    | (uint64_t{static_cast<uint8_t>(version::time_based)} << 12)
+                    | ((timestamp >> 48) & 0x0FFFu);
+        }
+
+        void extract_fields(const instruction_set kernel, const std::span<const uuid> ids, const field_columns& columns) noexcept;
+
+        // Rewrites the ids of version `from` in the layout of `to`, one of
+        // time-based and reordered time; returns how many there were.
+        size_t convert_time_layout(   const instruction_set kernel
+                                    , const std::span<uuid> ids
+                                    , const version from
+                                    , const version to ) noexcept;
+
+    } // __internal
+
+    // Decodes the fields of every id into columns, several ids per vector
+    // instruction where the CPU allows.
+    inline void extract_fields(const std::span<const uuid> ids, const field_columns& columns) noexcept
+    {
+        __internal::extract_fields(__internal::detected_instruction_set(), ids, columns);
+    }
+
+    // A time-based id as the reordered time id with the same timestamp,
+    // clock sequence and node, which sorts by time; other ids are returned
+    // as they are.
+    constexpr uuid to_reordered_time(const uuid& id) noexcept
+    {
+        return version::time_based == id.version() ? uuid{__internal::reordered_high(id.high()), id.low()} : id;
+    }
+
+    // Inverse of to_reordered_time().
+    constexpr uuid to_time_based(const uuid& id) noexcept
+    {
+        return version::reordered_time == id.version() ? uuid{__internal::time_based_high(id.high()), id.low()} : id;
+    }
+
+    // In place forms of the above, for migrating stored keys; they return
+    // how many ids were converted.
+    inline size_t to_reordered_time_n(const std::span<uuid> ids) noexcept
+    {
+        return __internal::convert_time_layout(__internal::detected_instruction_set(), ids, version::time_based, version::reordered_time);
+    }
+
+    inline size_t to_time_based_n(const std::span<uuid> ids) noexcept
+    {
+        return __internal::convert_time_layout(__internal::detected_instruction_set(), ids, version::reordered_time, version::time_based);
+    }
+
+} // namespace rfc4122
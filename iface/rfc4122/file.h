@@ -0,0 +1,218 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <rfc4122/uuid.h>
+#include <rfc4122/batch.h>
+
+
+
+namespace rfc4122
+{
+
+    // Read-only, shared mapping of a whole file. Errors are reported with
+    // std::system_error.
+    class mapped_file
+    {
+    public:
+        mapped_file() noexcept = default;
+        explicit mapped_file(const std::filesystem::path& path);
+        mapped_file(mapped_file&& other) noexcept;
+        mapped_file& operator = (mapped_file&& other) noexcept;
+        ~mapped_file();
+
+        std::span<const std::byte> bytes() const noexcept {return {address, size};}
+
+    private:
+        const std::byte* address = nullptr;
+        size_t size = 0u;
+    };
+
+    // File of raw 16-byte records, viewed in place.
+    class binary_reader
+    {
+    public:
+        explicit binary_reader(const std::filesystem::path& path);
+
+        std::span<const uuid> ids() const noexcept;
+
+    private:
+        mapped_file file;
+    };
+
+    // File of delimiter-separated literals, decoded chunk by chunk.
+    class text_reader
+    {
+    public:
+        explicit text_reader(const std::filesystem::path& path, const char delimiter = '\n');
+
+        // Decodes the next records into `ids` as from_literals() does.
+        literals_result read(const std::span<uuid> ids, const std::span<uint64_t> validity) noexcept;
+
+        bool eof() const noexcept {return offset >= std::size(file.bytes());}
+        std::string_view text() const noexcept;
+
+    private:
+        mapped_file file;
+        size_t offset = 0u;
+        char delimiter;
+    };
+
+    // Buffered writer that hands data to the kernel in large chunks. The
+    // destructor flushes too, but only close() reports errors.
+    class file_writer
+    {
+    public:
+        static constexpr size_t DEFAULT_CHUNK_SIZE = size_t{1} << 20u;
+
+        explicit file_writer(const std::filesystem::path& path, const size_t chunk_size = DEFAULT_CHUNK_SIZE);
+        file_writer(file_writer&& other) noexcept;
+        ~file_writer();
+
+        void write(std::span<const std::byte> bytes);
+        void flush();
+        void close();
+
+    protected:
+        std::span<char> reserve(const size_t at_least);
+        void commit(const size_t used) noexcept {filled += used;}
+
+    private:
+        void write_through(std::span<const std::byte> bytes);
+
+        int descriptor = -1;
+        std::unique_ptr<char[]> chunk;
+        size_t chunk_size = 0u;
+        size_t filled = 0u;
+        std::filesystem::path path;
+    };
+
+    // Writes ids as raw 16-byte records readable by binary_reader.
+    class binary_writer: public file_writer
+    {
+    public:
+        using file_writer::file_writer;
+
+        void write(const std::span<const uuid> ids) {file_writer::write(std::as_bytes(ids));}
+    };
+
+    // Writes ids as literals, each one followed by the delimiter.
+    class text_writer: public file_writer
+    {
+    public:
+        explicit text_writer(   const std::filesystem::path& path
+                              , const char delimiter = '\n'
+                              , const size_t chunk_size = DEFAULT_CHUNK_SIZE );
+
+        void write(std::span<const uuid> ids);
+
+    private:
+        char delimiter;
+    };
+
+    // How async_text_writer lays out the literals.
+    enum class text_layout: uint8_t
+    {
+          lines       // one per line
+        , csv         // one line, comma separated
+        , json_array  // ["...","..."] and a newline
+    };
+
+    struct async_writer_options
+    {
+        text_layout layout = text_layout::lines;
+        size_t buffer_size = size_t{1} << 20u;
+        // Two is enough for formatting to overlap the writes; with more, a
+        // write call takes all the full ones at once.
+        size_t buffers = 2u;
+    };
+
+    struct async_writer_metrics
+    {
+        uint64_t ids;
+        uint64_t bytes;                      // handed to the kernel
+        uint64_t writes;                     // write and writev calls
+        uint64_t stalls;                     // times formatting waited for a free buffer
+        std::chrono::nanoseconds formatting; // in write() calls, stalls included
+        std::chrono::nanoseconds writing;    // in the I/O thread's system calls
+    };
+
+    // Formats ids straight into page-aligned buffers with the vector
+    // kernels of to_literals() and hands full buffers to a thread that
+    // writes them to `descriptor`, so formatting one buffer overlaps
+    // writing another. The descriptor stays open and owned by the caller.
+    // A failed write is reported as std::system_error by the next write(),
+    // flush() or finish(); the destructor finishes too but throws nothing.
+    class async_text_writer
+    {
+    public:
+        explicit async_text_writer(const int descriptor, const async_writer_options& options = {});
+        ~async_text_writer();
+
+        async_text_writer(const async_text_writer&) = delete;
+        async_text_writer& operator = (const async_text_writer&) = delete;
+
+        void write(std::span<const uuid> ids);
+
+        // Waits until everything written so far is with the kernel.
+        void flush();
+
+        // Writes the closing text of the layout and flushes; takes no more ids.
+        void finish();
+
+        async_writer_metrics metrics() const noexcept;
+        const async_writer_options& options() const noexcept {return settings;}
+
+    private:
+        struct aligned_delete
+        {
+            void operator () (char* const buffer) const noexcept;
+        };
+
+        void append(const std::string_view text);
+        size_t format(const std::span<const uuid> ids, char* const out, const size_t room, size_t& bytes) noexcept;
+        void submit();
+        void write_loop();
+        void check() const;
+
+        const async_writer_options settings;
+        const int descriptor;
+        std::vector<std::unique_ptr<char, aligned_delete>> buffers;
+        size_t current = 0u;
+        size_t used = 0u;
+        bool started = false;
+        bool finished = false;
+
+        mutable std::mutex lock;
+        std::condition_variable changed;
+        std::vector<size_t> free_buffers;
+        std::deque<std::pair<size_t, size_t>> full_buffers; // (buffer, bytes)
+        size_t in_flight = 0u;
+        bool stopping = false;
+        int error = 0;
+
+        uint64_t ids_count = 0u;
+        uint64_t bytes_count = 0u;
+        uint64_t writes_count = 0u;
+        uint64_t stalls_count = 0u;
+        std::chrono::nanoseconds formatting_time{0};
+        std::chrono::nanoseconds writing_time{0};
+
+        std::thread writer;
+    };
+
+} // namespace rfc4122
@@ -0,0 +1,209 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include <rfc4122/uuid.h>
+#include <rfc4122/file.h>
+#include <rfc4122/simd.h>
+
+
+
+namespace rfc4122
+{
+
+    // Where filters take their bits from. Random (version 4) ids are uniform
+    // already but for the version and variant, so their own bits are used;
+    // time-based and other structured ids are hashed first.
+    enum class filter_keys: uint8_t
+    {
+          random
+        , any
+    };
+
+    namespace __internal
+    {
+
+        // Two independent words per id: `index` picks the block or bucket by
+        // its most significant bits, `probe` supplies the rest from its least
+        // significant ones. Neither overlaps the version or variant bits.
+        struct filter_key
+        {
+            uint64_t index;
+            uint64_t probe;
+        };
+
+        constexpr filter_key make_filter_key(const uuid& id, const filter_keys keys) noexcept
+        {
+            if(filter_keys::random == keys) return {std::rotl(id.high(), 16), id.low()};
+            return {hash(id, 0x2d358dccaa6c78a5u), hash(id, 0x8bb84b93962eacc9u)};
+        }
+
+        // (value * range) >> 64, a bias-free enough map of `value` onto [0, range).
+        constexpr uint64_t scale(const uint64_t value, const uint64_t range) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            return static_cast<uint64_t>((static_cast<unsigned __int128>(value) * range) >> 64);
+#else
+            return (value >> 32) * range >> 32;
+#endif
+        }
+
+        // One 64 octet line, the unit filters are allocated in.
+        struct alignas(64) cache_line
+        {
+            std::byte bytes[64];
+        };
+
+    } // __internal
+
+    class blocked_bloom_filter;
+    class cuckoo_filter;
+
+    namespace __internal
+    {
+
+        size_t may_contain_n(   const instruction_set kernel
+                              , const blocked_bloom_filter& filter
+                              , const std::span<const uuid> ids
+                              , const std::span<uint64_t> found ) noexcept;
+
+        size_t may_contain_n(   const instruction_set kernel
+                              , const cuckoo_filter& filter
+                              , const std::span<const uuid> ids
+                              , const std::span<uint64_t> found ) noexcept;
+
+    } // __internal
+
+    // Split block Bloom filter: every id sets one bit in each of the eight
+    // 32-bit words of a single 32 octet block, so a query touches one cache
+    // line and is tested with one vector compare. Sized for `capacity` ids
+    // at `false_positive_rate`; past that the rate degrades gracefully.
+    // Filters mapped from a file are read-only, insert() on them fails.
+    class blocked_bloom_filter
+    {
+    public:
+        static constexpr size_t BLOCK_SIZE = 32u;
+
+        blocked_bloom_filter() noexcept = default;
+        blocked_bloom_filter(   const size_t capacity
+                              , const double false_positive_rate
+                              , const filter_keys keys = filter_keys::any );
+
+        // Maps a file written by save(). Errors are reported with std::system_error.
+        explicit blocked_bloom_filter(const std::filesystem::path& path);
+
+        blocked_bloom_filter(blocked_bloom_filter&& other) noexcept;
+        blocked_bloom_filter& operator = (blocked_bloom_filter&& other) noexcept;
+
+        bool insert(const uuid& id) noexcept;
+        bool insert(const std::span<const uuid> ids) noexcept;
+
+        bool may_contain(const uuid& id) const noexcept;
+
+        // Sets bit i of `found` for each of `ids` that may be present and
+        // returns how many; `found` holds validity_size(std::size(ids)) words.
+        size_t may_contain(const std::span<const uuid> ids, const std::span<uint64_t> found) const noexcept
+        {
+            return __internal::may_contain_n(__internal::detected_instruction_set(), *this, ids, found);
+        }
+
+        // Ids inserted, duplicates included.
+        size_t size() const noexcept {return inserted;}
+        size_t blocks() const noexcept {return blocks_count;}
+        filter_keys keys() const noexcept {return key_source;}
+
+        void save(const std::filesystem::path& path) const;
+
+    private:
+        friend size_t __internal::may_contain_n(   const __internal::instruction_set
+                                                 , const blocked_bloom_filter&
+                                                 , const std::span<const uuid>
+                                                 , const std::span<uint64_t> ) noexcept;
+
+        bool attach(const std::span<const std::byte> bytes) noexcept;
+
+        std::vector<__internal::cache_line> owned;
+        mapped_file file;
+        const uint32_t* words = nullptr;
+        uint32_t* writable = nullptr;
+        size_t blocks_count = 0u;
+        size_t inserted = 0u;
+        filter_keys key_source = filter_keys::any;
+    };
+
+    // Cuckoo filter of 16-bit fingerprints in buckets of four, each id may
+    // sit in one of two buckets. Unlike the Bloom filter ids can be erased;
+    // inserting an id again stores it again, so every insert() may be undone
+    // by one erase(). The false positive rate is about 8 / 65536 at any load.
+    // insert() fails once the table is full or the filter is mapped.
+    class cuckoo_filter
+    {
+    public:
+        static constexpr size_t BUCKET_SIZE = 4u;
+
+        cuckoo_filter() noexcept = default;
+        explicit cuckoo_filter(const size_t capacity, const filter_keys keys = filter_keys::any);
+
+        // Maps a file written by save(). Errors are reported with std::system_error.
+        explicit cuckoo_filter(const std::filesystem::path& path);
+
+        cuckoo_filter(cuckoo_filter&& other) noexcept;
+        cuckoo_filter& operator = (cuckoo_filter&& other) noexcept;
+
+        bool insert(const uuid& id) noexcept;
+
+        // Removes one copy of an id that was inserted; erasing an id that
+        // never was may remove another one sharing its fingerprint.
+        bool erase(const uuid& id) noexcept;
+
+        bool may_contain(const uuid& id) const noexcept;
+
+        // As blocked_bloom_filter::may_contain().
+        size_t may_contain(const std::span<const uuid> ids, const std::span<uint64_t> found) const noexcept
+        {
+            return __internal::may_contain_n(__internal::detected_instruction_set(), *this, ids, found);
+        }
+
+        size_t size() const noexcept {return stored;}
+        size_t buckets() const noexcept {return size_t{1} << buckets_log2;}
+        filter_keys keys() const noexcept {return key_source;}
+
+        void save(const std::filesystem::path& path) const;
+
+    private:
+        friend size_t __internal::may_contain_n(   const __internal::instruction_set
+                                                 , const cuckoo_filter&
+                                                 , const std::span<const uuid>
+                                                 , const std::span<uint64_t> ) noexcept;
+
+        bool attach(const std::span<const std::byte> bytes) noexcept;
+
+        // Stores `print` in `bucket` or its other one, evicting residents
+        // when both are full.
+        void settle(uint64_t bucket, uint16_t print) noexcept;
+
+        std::vector<__internal::cache_line> owned;
+        mapped_file file;
+        const uint64_t* slots = nullptr;
+        uint64_t* writable = nullptr;
+        size_t buckets_log2 = 0u;
+        size_t stored = 0u;
+        filter_keys key_source = filter_keys::any;
+
+        // The fingerprint left homeless by the last failed insert(), kept so
+        // that it is not lost; while it is taken the filter is full.
+        bool has_victim = false;
+        uint16_t victim_fingerprint = 0u;
+        uint64_t victim_bucket = 0u;
+        uint64_t kick_state = 0x9e3779b97f4a7c15u;
+    };
+
+} // namespace rfc4122
@@ -0,0 +1,268 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <system_error>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+#include <rfc4122/uuid.h>
+
+
+
+namespace rfc4122
+{
+
+    enum class enclosure: uint8_t
+    {
+          none
+        , braces // {...}
+        , urn    // urn:uuid:...
+    };
+
+    // Variations of the canonical literal, which is the default.
+    struct literal_format
+    {
+        bool upper_case = false;
+        bool hyphens    = true;
+        enclosure wrap  = enclosure::none;
+    };
+
+    static constexpr char URN_PREFIX[] = "urn:uuid:";
+    static constexpr size_t URN_PREFIX_LENGTH = std::size(URN_PREFIX) - 1u;
+    static constexpr size_t MAX_FORMATTED_LENGTH = URN_PREFIX_LENGTH + UUID_STRING_LENGTH;
+
+    constexpr size_t formatted_size(const literal_format format) noexcept
+    {
+        return   (format.hyphens ? UUID_STRING_LENGTH : 2u * sizeof(uuid))
+               + (  enclosure::braces == format.wrap ? 2u
+                  : enclosure::urn    == format.wrap ? URN_PREFIX_LENGTH
+                  : 0u );
+    }
+
+    namespace __internal
+    {
+
+        // Hex letters of the 32-bit `value`, the first one in the most
+        // significant byte; 8 nibbles are spread to bytes and turned into
+        // letters together.
+        constexpr uint64_t hex_letters(const uint64_t value, const bool upper_case) noexcept
+        {
+            uint64_t x = ((value & 0xFFFF0000u) << 16) | (value & 0x0000FFFFu);
+            x = ((x & 0x0000FF000000FF00u) << 8) | (x & 0x000000FF000000FFu);
+            x = ((x & 0x00F000F000F000F0u) << 4) | (x & 0x000F000F000F000Fu);
+            const uint64_t above_nine = ((x + 0x0606060606060606u) >> 4) & 0x0101010101010101u;
+            return x + 0x3030303030303030u + above_nine * (upper_case ? 'A' - '9' - 1 : 'a' - '9' - 1);
+        }
+
+        // Offsets of the 32 hex digits when there are no hyphens.
+        static constexpr auto PLAIN_DIGITS = []() constexpr
+        {
+            std::array<uint8_t, 32> offsets{};
+            for(auto digit = 0u; digit < std::size(offsets); ++digit) offsets[digit] = static_cast<uint8_t>(digit);
+            return offsets;
+        }();
+
+    } // __internal
+
+    // Writes formatted_size(format) characters from `output` on and returns
+    // the end of them. Never allocates.
+    template<typename C>
+    constexpr C* format_to(C* output, const uuid& id, const literal_format format = {}) noexcept
+    {
+        using namespace rfc4122::__internal;
+
+        const uint64_t words[] = {id.high(), id.low()};
+        char letters[2u * sizeof(uuid)] = {};
+        for(auto i = 0u; i < 4u; ++i)
+        {
+            const uint64_t eight = hex_letters((words[i / 2u] >> (32u - 32u * (i % 2u))) & 0xFFFFFFFFu, format.upper_case);
+            for(auto j = 0u; j < 8u; ++j) letters[8u * i + j] = static_cast<char>(eight >> (56u - 8u * j));
+        }
+
+        if(enclosure::braces == format.wrap) *output++ = '{';
+        if(enclosure::urn    == format.wrap) output = std::copy_n(URN_PREFIX, URN_PREFIX_LENGTH, output);
+        if(!format.hyphens)
+        {
+            output = std::copy_n(letters, std::size(letters), output);
+        }
+        else
+        {
+            const char* letter = letters;
+            for(auto part = 0u; part < std::size(PARTS_QUARTETS_COUNT); ++part)
+            {
+                if(part > 0u) *output++ = '-';
+                output = std::copy_n(letter, PARTS_QUARTETS_COUNT[part], output);
+                letter += PARTS_QUARTETS_COUNT[part];
+            }
+        }
+        if(enclosure::braces == format.wrap) *output++ = '}';
+        return output;
+    }
+
+    // Like std::to_chars: fails with std::errc::value_too_large, writing
+    // nothing, when [first, last) is too short.
+    inline std::to_chars_result to_chars(   char* const first
+                                          , char* const last
+                                          , const uuid& id
+                                          , const literal_format format = {} ) noexcept
+    {
+        if(last - first < static_cast<std::ptrdiff_t>(formatted_size(format))) return {last, std::errc::value_too_large};
+        return {format_to(first, id, format), std::errc{}};
+    }
+
+    // Reads the uuid part of a std::format spec: any of 'U' (upper case),
+    // 'n' (no hyphens), then at most one of 'b' (braces) or 'r' (urn:uuid:).
+    // Returns the position of the first character it does not take, which
+    // must be the closing brace.
+    template<typename C>
+    constexpr const C* parse_format(const C* spec, const C* const end, literal_format& format) noexcept
+    {
+        for(; spec != end; ++spec)
+        {
+            switch(*spec)
+            {
+                case 'U': format.upper_case = true; break;
+                case 'n': format.hyphens = false; break;
+                case 'b': if(enclosure::none != format.wrap) return spec; format.wrap = enclosure::braces; break;
+                case 'r': if(enclosure::none != format.wrap) return spec; format.wrap = enclosure::urn; break;
+                default: return spec;
+            }
+        }
+        return spec;
+    }
+
+    enum class parse_error: uint8_t
+    {
+          none
+        , length    // no accepted form is this long
+        , digit     // a hex digit is missing at `offset`
+        , separator // a hyphen, a brace or the urn prefix is missing at `offset`
+    };
+
+    // Outcome of parse_literal(), in the manner of std::expected: the id
+    // and the form it was written in, or the first error and its offset.
+    struct parse_result
+    {
+        uuid id{};
+        literal_format format{};
+        parse_error error = parse_error::none;
+        size_t offset = 0u;
+
+        constexpr bool has_value() const noexcept {return parse_error::none == error;}
+        constexpr explicit operator bool () const noexcept {return has_value();}
+        constexpr const uuid& operator * () const noexcept {return id;}
+        constexpr uuid value_or(const uuid& fallback) const noexcept {return has_value() ? id : fallback;}
+    };
+
+    // Accepts every form format_to() writes, in either case, and tells which
+    // one it was from the length and first symbol:
+    //   32 hex digits, the canonical 36, {36}, {32} and urn:uuid:36.
+    // Digits are decoded in one pass; only a failed text is scanned again to
+    // find the offset of its first error.
+    template<typename C>
+    constexpr parse_result parse_literal(const C* const text, const size_t length) noexcept
+    {
+        using namespace rfc4122::__internal;
+
+        parse_result result{};
+        const auto fail = [&result](const parse_error error, const size_t offset) noexcept
+        {
+            result.error  = error;
+            result.offset = offset;
+            return result;
+        };
+
+        size_t first = 0u;
+        switch(length)
+        {
+            case 2u * sizeof(uuid)     : result.format.hyphens = false; break;
+            case UUID_STRING_LENGTH    : break;
+            case 2u * sizeof(uuid) + 2u: result.format.hyphens = false; [[fallthrough]];
+            case UUID_STRING_LENGTH + 2u:
+                result.format.wrap = enclosure::braces;
+                first = 1u;
+                if('{' != static_cast<uint32_t>(text[0])) return fail(parse_error::separator, 0u);
+                if('}' != static_cast<uint32_t>(text[length - 1u])) return fail(parse_error::separator, length - 1u);
+                break;
+            case URN_PREFIX_LENGTH + UUID_STRING_LENGTH:
+                result.format.wrap = enclosure::urn;
+                first = URN_PREFIX_LENGTH;
+                for(auto i = 0u; i < URN_PREFIX_LENGTH; ++i)
+                {
+                    // Only letters differ by 0x20 between cases; ':' must match exactly.
+                    const auto code = static_cast<uint32_t>(text[i]);
+                    const auto lower = ':' == URN_PREFIX[i] ? code : code | 0x20u;
+                    if(lower != static_cast<uint32_t>(URN_PREFIX[i])) return fail(parse_error::separator, i);
+                }
+                break;
+            default: return fail(parse_error::length, 0u);
+        }
+
+        const C* const digits = text + first;
+        const bool decoded = result.format.hyphens ? decode_literal(digits, result.id)
+                                                   : decode_digits(digits, PLAIN_DIGITS, result.id);
+        if(!decoded)
+        {
+            for(auto index = 0u; ; ++index)
+            {
+                const bool dash = result.format.hyphens && is_dash_index(index);
+                if(dash && '-' != static_cast<uint32_t>(digits[index])) return fail(parse_error::separator, first + index);
+                if(!dash && hex_value(digits[index]) > 0x0Fu) return fail(parse_error::digit, first + index);
+            }
+        }
+        // 'A'..'F' are the only symbols here with 0x40 set and 0x20 clear;
+        // hyphens have neither.
+        const size_t count = result.format.hyphens ? UUID_STRING_LENGTH : 2u * sizeof(uuid);
+        uint32_t upper = 0u;
+        for(auto index = 0u; index < count; ++index)
+        {
+            const auto code = static_cast<uint32_t>(digits[index]);
+            upper |= code & ~(code << 1);
+        }
+        result.format.upper_case = 0u != (upper & 0x40u);
+        return result;
+    }
+
+    template<typename C, typename T>
+    constexpr parse_result parse_literal(const std::basic_string_view<C,T>& text) noexcept
+    {
+        return parse_literal(std::data(text), std::size(text));
+    }
+
+} // namespace rfc4122
+
+#if defined(__cpp_lib_format)
+
+// std::format("{}", id), with the spec read by rfc4122::parse_format, e.g. "{:Ub}".
+template<typename C>
+struct std::formatter<rfc4122::uuid, C>
+{
+    rfc4122::literal_format spec{};
+
+    constexpr auto parse(std::basic_format_parse_context<C>& context)
+    {
+        const C* const begin = std::to_address(context.begin());
+        const C* const end   = std::to_address(context.end());
+        const C* const stop  = rfc4122::parse_format(begin, end, spec);
+        if(stop != end && '}' != *stop) throw std::format_error("invalid uuid format spec");
+        return context.begin() + (stop - begin);
+    }
+
+    template<typename O>
+    auto format(const rfc4122::uuid& id, std::basic_format_context<O, C>& context) const
+    {
+        C buffer[rfc4122::MAX_FORMATTED_LENGTH];
+        const C* const end = rfc4122::format_to(buffer, id, spec);
+        return std::copy(buffer, end, context.out());
+    }
+};
+
+#endif // __cpp_lib_format
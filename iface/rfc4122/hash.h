@@ -0,0 +1,40 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include <rfc4122/simd.h>
+
+
+
+namespace rfc4122
+{
+    namespace __internal
+    {
+
+        enum class hash_algorithm: uint8_t
+        {
+              md5
+            , sha1
+        };
+
+        // Large enough for either algorithm, an md5 digest takes the first 16 octets.
+        using digest = std::array<uint8_t, 20>;
+
+        // Hashes `prefix` followed by each of `messages` into `digests`. Vector
+        // kernels run several independent messages side by side, one per lane.
+        void hash_n(   const instruction_set kernel
+                     , const hash_algorithm algorithm
+                     , const std::span<const std::byte> prefix
+                     , const std::span<const std::string_view> messages
+                     , const std::span<digest> digests ) noexcept;
+
+    } // __internal
+
+} // namespace rfc4122
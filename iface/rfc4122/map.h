@@ -0,0 +1,392 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <rfc4122/uuid.h>
+
+
+
+namespace rfc4122
+{
+
+    // Takes the hash straight from the key. Only for random (version 4) ids,
+    // whose low octets are uniform already; time-based ids need uuid_hash.
+    struct uuid_bits_hash
+    {
+        constexpr size_t operator () (const uuid& id) const noexcept
+        {
+            return static_cast<size_t>(id.low());
+        }
+    };
+
+    namespace __internal
+    {
+
+        // One control byte per slot: EMPTY, DELETED or, for a full slot, the
+        // low 7 bits of its hash.
+        enum control: int8_t
+        {
+              EMPTY   = -128
+            , DELETED = -2
+        };
+
+        // 16 control bytes matched at once.
+        struct control_group
+        {
+            static constexpr size_t WIDTH = 16u;
+
+#if defined(__SSE2__)
+            explicit control_group(const int8_t* const controls) noexcept
+                : controls{_mm_loadu_si128(reinterpret_cast<const __m128i*>(controls))}
+            {}
+
+            uint32_t match(const int8_t h2) const noexcept
+            {
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8(h2))));
+            }
+
+            uint32_t match_empty() const noexcept
+            {
+                return match(EMPTY);
+            }
+
+            uint32_t match_free() const noexcept
+            {
+                return static_cast<uint32_t>(_mm_movemask_epi8(controls));
+            }
+
+            __m128i controls;
+#else
+            explicit control_group(const int8_t* const controls) noexcept
+            {
+                std::memcpy(this->controls, controls, WIDTH);
+            }
+
+            uint32_t match(const int8_t h2) const noexcept
+            {
+                uint32_t mask = 0u;
+                for(size_t i = 0; i < WIDTH; ++i) mask |= static_cast<uint32_t>(controls[i] == h2) << i;
+                return mask;
+            }
+
+            uint32_t match_empty() const noexcept
+            {
+                return match(EMPTY);
+            }
+
+            uint32_t match_free() const noexcept
+            {
+                uint32_t mask = 0u;
+                for(size_t i = 0; i < WIDTH; ++i) mask |= static_cast<uint32_t>(controls[i] < 0) << i;
+                return mask;
+            }
+
+            int8_t controls[WIDTH];
+#endif
+        };
+
+        struct no_value {};
+
+        // Open addressing over groups of 16 slots, probed triangularly so every
+        // group is visited once the table is a power of two groups long. Slots
+        // keep the key next to its value; control bytes live in their own array
+        // so a probe touches one cache line of them.
+        template<typename V, typename H>
+        class flat_table
+        {
+        public:
+            struct slot
+            {
+                uuid key;
+                [[no_unique_address]] V value;
+            };
+
+            flat_table() noexcept = default;
+
+            explicit flat_table(const size_t expected, const H& hasher = H{})
+                : hasher{hasher}
+            {
+                reserve(expected);
+            }
+
+            flat_table(flat_table&& other) noexcept
+                : controls   {std::exchange(other.controls, nullptr)}
+                , slots      {std::exchange(other.slots, nullptr)}
+                , groups     {std::exchange(other.groups, 0u)}
+                , count      {std::exchange(other.count, 0u)}
+                , growth_left{std::exchange(other.growth_left, 0u)}
+                , hasher     {other.hasher}
+            {}
+
+            flat_table& operator = (flat_table&& other) noexcept
+            {
+                if(this != &other)
+                {
+                    release();
+                    controls    = std::exchange(other.controls, nullptr);
+                    slots       = std::exchange(other.slots, nullptr);
+                    groups      = std::exchange(other.groups, 0u);
+                    count       = std::exchange(other.count, 0u);
+                    growth_left = std::exchange(other.growth_left, 0u);
+                    hasher      = other.hasher;
+                }
+                return *this;
+            }
+
+            ~flat_table()
+            {
+                release();
+            }
+
+            size_t size() const noexcept {return count;}
+            bool empty() const noexcept {return 0u == count;}
+            size_t capacity() const noexcept {return groups * control_group::WIDTH;}
+
+            void reserve(const size_t expected)
+            {
+                // Load factor stays at or below 7/8.
+                const size_t needed = expected + expected / 7u;
+                if(needed <= capacity() && expected <= count + growth_left) return;
+                rehash(std::bit_ceil(std::max(needed / control_group::WIDTH + 1u, size_t{1})));
+            }
+
+            void clear() noexcept
+            {
+                for_each_slot([](slot& entry) noexcept {entry.~slot();});
+                if(controls) std::memset(controls, EMPTY, capacity());
+                count = 0u;
+                growth_left = max_load(groups);
+            }
+
+            slot* find(const uuid& key) const noexcept
+            {
+                if(0u == count) return nullptr;
+                const size_t hash = hasher(key);
+                const int8_t h2 = static_cast<int8_t>(hash & 0x7Fu);
+                for(size_t group = (hash >> 7) & (groups - 1u), step = 1u; ; group = (group + step++) & (groups - 1u))
+                {
+                    const control_group controls_group{controls + group * control_group::WIDTH};
+                    for(uint32_t mask = controls_group.match(h2); 0u != mask; mask &= mask - 1u)
+                    {
+                        slot& candidate = slots[group * control_group::WIDTH + std::countr_zero(mask)];
+                        if(candidate.key == key) return &candidate;
+                    }
+                    if(0u != controls_group.match_empty()) return nullptr;
+                }
+            }
+
+            template<typename... A>
+            std::pair<slot*, bool> try_emplace(const uuid& key, A&&... arguments)
+            {
+                if(slot* const found = find(key)) return {found, false};
+                if(0u == growth_left)
+                {
+                    // Mostly tombstones: rebuild at the same size, else grow.
+                    rehash(count >= max_load(groups) / 2u ? std::max(groups * 2u, size_t{1}) : groups);
+                }
+                const size_t hash = hasher(key);
+                const size_t index = free_slot(hash);
+                // Published only once constructed: a throwing V leaves no
+                // full control byte over a dead slot.
+                slot* const entry = new(slots + index) slot{key, V(std::forward<A>(arguments)...)};
+                growth_left -= EMPTY == controls[index];
+                controls[index] = static_cast<int8_t>(hash & 0x7Fu);
+                ++count;
+                return {entry, true};
+            }
+
+            bool erase(const uuid& key) noexcept
+            {
+                slot* const found = find(key);
+                if(nullptr == found) return false;
+                const size_t index = static_cast<size_t>(found - slots);
+                found->~slot();
+                // A slot whose group still has an empty one never stopped a
+                // probe, it can become empty again.
+                const bool reusable = 0u != control_group{controls + (index & ~(control_group::WIDTH - 1u))}.match_empty();
+                controls[index] = reusable ? EMPTY : DELETED;
+                growth_left += reusable;
+                --count;
+                return true;
+            }
+
+            template<typename F>
+            void for_each_slot(F&& function) const
+            {
+                for(size_t index = 0; index < capacity(); ++index)
+                {
+                    if(controls[index] >= 0) function(slots[index]);
+                }
+            }
+
+        private:
+            static constexpr size_t max_load(const size_t groups) noexcept
+            {
+                return groups * control_group::WIDTH * 7u / 8u;
+            }
+
+            size_t free_slot(const size_t hash) const noexcept
+            {
+                for(size_t group = (hash >> 7) & (groups - 1u), step = 1u; ; group = (group + step++) & (groups - 1u))
+                {
+                    const uint32_t mask = control_group{controls + group * control_group::WIDTH}.match_free();
+                    if(0u != mask) return group * control_group::WIDTH + std::countr_zero(mask);
+                }
+            }
+
+            void rehash(const size_t new_groups)
+            {
+                const size_t slots_count = new_groups * control_group::WIDTH;
+                int8_t* const new_controls = static_cast<int8_t*>(::operator new(slots_count, std::align_val_t{64}));
+                slot* new_slots = nullptr;
+                try
+                {
+                    new_slots = static_cast<slot*>(::operator new(slots_count * sizeof(slot), std::align_val_t{64}));
+                }
+                catch(...)
+                {
+                    ::operator delete(new_controls, std::align_val_t{64});
+                    throw;
+                }
+                std::memset(new_controls, EMPTY, slots_count);
+
+                int8_t* const old_controls = std::exchange(controls, new_controls);
+                slot* const old_slots = std::exchange(slots, new_slots);
+                const size_t old_capacity = capacity();
+                groups = new_groups;
+                growth_left = max_load(groups) - count;
+                for(size_t index = 0; index < old_capacity; ++index)
+                {
+                    if(old_controls[index] < 0) continue;
+                    const size_t hash = hasher(old_slots[index].key);
+                    const size_t target = free_slot(hash);
+                    controls[target] = static_cast<int8_t>(hash & 0x7Fu);
+                    new(slots + target) slot{std::move(old_slots[index])};
+                    old_slots[index].~slot();
+                }
+                ::operator delete(old_controls, std::align_val_t{64});
+                ::operator delete(old_slots, std::align_val_t{64});
+            }
+
+            void release() noexcept
+            {
+                if(nullptr == controls) return;
+                for_each_slot([](slot& entry) noexcept {entry.~slot();});
+                ::operator delete(controls, std::align_val_t{64});
+                ::operator delete(slots, std::align_val_t{64});
+                controls = nullptr;
+                slots = nullptr;
+            }
+
+            int8_t* controls = nullptr;
+            slot* slots = nullptr;
+            size_t groups = 0u;
+            size_t count = 0u;
+            size_t growth_left = 0u;
+            [[no_unique_address]] H hasher{};
+        };
+
+    } // __internal
+
+    // Flat hash map keyed by ids, without a node allocation per entry.
+    // Pointers to values stay valid until the next insertion or erase.
+    template<typename V, typename H = uuid_hash>
+    class uuid_map
+    {
+    public:
+        uuid_map() noexcept = default;
+        explicit uuid_map(const size_t expected, const H& hasher = H{}): table{expected, hasher} {}
+
+        size_t size() const noexcept {return table.size();}
+        bool empty() const noexcept {return table.empty();}
+        size_t capacity() const noexcept {return table.capacity();}
+        void reserve(const size_t expected) {table.reserve(expected);}
+        void clear() noexcept {table.clear();}
+
+        V* find(const uuid& key) noexcept
+        {
+            const auto found = table.find(key);
+            return found ? &found->value : nullptr;
+        }
+
+        const V* find(const uuid& key) const noexcept
+        {
+            const auto found = table.find(key);
+            return found ? &found->value : nullptr;
+        }
+
+        bool contains(const uuid& key) const noexcept {return nullptr != table.find(key);}
+
+        // Constructs the value only if the key is absent, like std::unordered_map.
+        template<typename... A>
+        std::pair<V*, bool> try_emplace(const uuid& key, A&&... arguments)
+        {
+            const auto [entry, inserted] = table.try_emplace(key, std::forward<A>(arguments)...);
+            return {&entry->value, inserted};
+        }
+
+        std::pair<V*, bool> insert_or_assign(const uuid& key, V value)
+        {
+            auto result = try_emplace(key, std::move(value));
+            if(!result.second) *result.first = std::move(value);
+            return result;
+        }
+
+        V& operator [] (const uuid& key) {return *try_emplace(key).first;}
+
+        bool erase(const uuid& key) noexcept {return table.erase(key);}
+
+        // Calls function(key, value) for every entry, in no particular order.
+        template<typename F>
+        void for_each(F&& function) const
+        {
+            table.for_each_slot([&](auto& entry) {function(std::as_const(entry.key), entry.value);});
+        }
+
+    private:
+        __internal::flat_table<V, H> table;
+    };
+
+    // Flat hash set of ids, the same table as uuid_map with 16-byte slots.
+    template<typename H = uuid_hash>
+    class uuid_set
+    {
+    public:
+        uuid_set() noexcept = default;
+        explicit uuid_set(const size_t expected, const H& hasher = H{}): table{expected, hasher} {}
+
+        size_t size() const noexcept {return table.size();}
+        bool empty() const noexcept {return table.empty();}
+        size_t capacity() const noexcept {return table.capacity();}
+        void reserve(const size_t expected) {table.reserve(expected);}
+        void clear() noexcept {table.clear();}
+
+        bool contains(const uuid& key) const noexcept {return nullptr != table.find(key);}
+        bool insert(const uuid& key) {return table.try_emplace(key).second;}
+        bool erase(const uuid& key) noexcept {return table.erase(key);}
+
+        template<typename F>
+        void for_each(F&& function) const
+        {
+            table.for_each_slot([&](const auto& entry) {function(entry.key);});
+        }
+
+    private:
+        __internal::flat_table<__internal::no_value, H> table;
+    };
+
+} // namespace rfc4122
@@ -0,0 +1,124 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+namespace rfc4122
+{
+
+    // Counting and timing of parse, format and generate calls. Compiled in
+    // only when the whole program, library included, is built with
+    // UUID_ENABLE_METRICS=1 (the CMake option of the same name); otherwise
+    // every hook is empty and collect_metrics() returns zeros.
+#if defined(UUID_ENABLE_METRICS) && UUID_ENABLE_METRICS
+    inline constexpr bool METRICS_ENABLED = true;
+#else
+    inline constexpr bool METRICS_ENABLED = false;
+#endif
+
+    enum class metered_operation: uint8_t
+    {
+          parse     // from_string(), from_literals(), parse() and parse_all()
+        , format    // to_literal() and to_literals()
+        , generate  // the generate_ functions
+    };
+
+    inline constexpr size_t METERED_OPERATIONS = 3u;
+
+    // Bucket i counts calls that took less than 2^i ns, and at least
+    // 2^(i-1) ns; the last one takes everything longer.
+    inline constexpr size_t LATENCY_BUCKETS = 32u;
+
+    // Every call is counted, but only one in this many per thread is timed:
+    // reading the clock costs more than parsing a literal.
+    inline constexpr uint32_t LATENCY_SAMPLING = 16u;
+
+    struct operation_metrics
+    {
+        uint64_t calls = 0u;
+        uint64_t ids = 0u;
+        uint64_t failures = 0u; // malformed literals, each of which came back as NIL_UUID
+        std::chrono::nanoseconds latency_sum{0};         // of the timed calls
+        std::array<uint64_t, LATENCY_BUCKETS> latency{}; // timed calls per bucket
+    };
+
+    struct thread_generation
+    {
+        uint64_t thread; // numbered from 0 in the order threads first record something
+        uint64_t ids;
+    };
+
+    struct metrics_snapshot
+    {
+        std::array<operation_metrics, METERED_OPERATIONS> operations{};
+        uint64_t clock_regressions = 0u; // wall clock readings behind an earlier one, see generate_time_based_uuid()
+        std::vector<thread_generation> threads; // live threads only; totals include finished ones
+
+        const operation_metrics& of(const metered_operation operation) const noexcept
+        {
+            return operations[static_cast<size_t>(operation)];
+        }
+    };
+
+    // Sums the counters of every thread. Each thread only ever writes its
+    // own, so this takes relaxed loads and one lock, nothing more.
+    metrics_snapshot collect_metrics();
+
+    // The snapshot in the Prometheus text exposition format.
+    std::string to_prometheus(const metrics_snapshot& snapshot);
+
+    namespace __internal
+    {
+
+        void record_operation(const metered_operation operation, const uint64_t ids, const uint64_t failures) noexcept;
+        void record_latency(const metered_operation operation, const std::chrono::nanoseconds latency) noexcept;
+        void record_clock_regression() noexcept;
+
+        inline thread_local uint32_t latency_countdown = 1u;
+
+        // Counts one call at done() and times it from construction when its
+        // turn comes. Without metrics it holds nothing the compiler has to keep.
+        class meter
+        {
+        public:
+            explicit meter(const metered_operation operation) noexcept
+            {
+                if constexpr(METRICS_ENABLED)
+                {
+                    this->operation = operation;
+                    if(0u == --latency_countdown)
+                    {
+                        latency_countdown = LATENCY_SAMPLING;
+                        start = std::chrono::steady_clock::now();
+                        timed = true;
+                    }
+                }
+            }
+
+            void done(const uint64_t ids = 1u, const uint64_t failures = 0u) const noexcept
+            {
+                if constexpr(METRICS_ENABLED)
+                {
+                    record_operation(operation, ids, failures);
+                    if(timed) record_latency(operation, std::chrono::steady_clock::now() - start);
+                }
+            }
+
+        private:
+            metered_operation operation{};
+            bool timed = false;
+            std::chrono::steady_clock::time_point start{};
+        };
+
+    } // __internal
+
+} // namespace rfc4122
@@ -0,0 +1,51 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+#include <rfc4122/uuid.h>
+
+
+
+namespace rfc4122
+{
+
+    // Where the node of time-based and reordered time ids comes from, in
+    // order of preference.
+    enum class node_source: uint8_t
+    {
+          interface  // universally administered MAC address of a network interface
+        , machine_id // digest of /etc/machine-id, multicast bit set
+        , random     // multicast bit set, drawn again in the child after fork()
+    };
+
+    struct host_node_id
+    {
+        uint64_t node;
+        node_source source;
+    };
+
+    // The node generate_time_based_uuid() and generate_reordered_time_uuid()
+    // use. Worked out on first call, then one atomic load.
+    host_node_id host_node() noexcept;
+
+    namespace __internal
+    {
+
+        // MAC of the first interface of a /sys/class/net like `directory`
+        // that has a device behind it, or else of the first one at all, by
+        // name. Loopback, multicast and locally administered addresses
+        // do not count.
+        std::optional<uint64_t> interface_node(const std::filesystem::path& directory) noexcept;
+
+        // Node derived from a machine-id(5) like `file`; the id itself does
+        // not show in it.
+        std::optional<uint64_t> machine_id_node(const std::filesystem::path& file) noexcept;
+
+    } // __internal
+
+} // namespace rfc4122
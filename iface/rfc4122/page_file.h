@@ -0,0 +1,117 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include <rfc4122/uuid.h>
+#include <rfc4122/fields.h>
+#include <rfc4122/file.h>
+
+
+
+namespace rfc4122
+{
+    namespace __internal
+    {
+
+        // Statistics of one page as stored in the file.
+        struct page_stats
+        {
+            uuid min;
+            uuid max;
+            int64_t first_time; // 100ns ticks since the Unix epoch, over ids with a time
+            int64_t last_time;
+            uint64_t flags;
+            uint64_t reserved;
+        };
+        static_assert(64u == sizeof(page_stats));
+
+    } // __internal
+
+    struct page_info
+    {
+        std::span<const uuid> ids;
+        uuid min;
+        uuid max;
+        // Bounds of to_time_point() over the ids that have one; if none does,
+        // first_time is after last_time.
+        uuid_time_point first_time;
+        uuid_time_point last_time;
+        bool sorted;
+    };
+
+    // Writes a page file: ids as raw 16-byte records in pages of
+    // `page_size` ids, then the statistics of every page. Pages and their
+    // statistics are written as they fill, so the ids need not fit in memory.
+    // Errors are reported with std::system_error; close() writes the last
+    // page and the index and must be called for the file to be readable.
+    class page_file_writer
+    {
+    public:
+        static constexpr size_t DEFAULT_PAGE_SIZE = 8192u;
+
+        // `page_size` is at most 2^32.
+        explicit page_file_writer(const std::filesystem::path& path, const size_t page_size = DEFAULT_PAGE_SIZE);
+
+        void write(std::span<const uuid> ids);
+        void close();
+
+    private:
+        void write_page();
+
+        const size_t ids_per_page;
+        file_writer output;
+        std::vector<uuid> page;
+        std::vector<__internal::page_stats> index;
+        uint64_t count = 0u;
+        bool sorted = true;
+        bool closed = false;
+    };
+
+    // Page file mapped in place. The ids are one span straight into the
+    // mapping; the statistics let a query skip every page that cannot hold
+    // what it looks for. All multi-octet numbers are in host byte order.
+    class page_file
+    {
+    public:
+        // Maps a file written by page_file_writer. Errors are reported with std::system_error.
+        explicit page_file(const std::filesystem::path& path);
+
+        size_t size() const noexcept {return std::size(all);}
+        size_t page_size() const noexcept {return ids_per_page;}
+        size_t pages() const noexcept {return std::size(index);}
+
+        // Every page is sorted and each one starts at or after the last id
+        // of the one before.
+        bool sorted() const noexcept {return ordered;}
+
+        std::span<const uuid> ids() const noexcept {return all;}
+        page_info page(const size_t page) const noexcept;
+
+        // Ids that may lie within [low, high], as runs of neighbouring pages
+        // whose min and max overlap it. In a sorted file the runs are cut to
+        // exactly the ids within.
+        std::vector<std::span<const uuid>> select(const uuid& low, const uuid& high) const;
+
+        // Ids of pages whose times overlap [from, to]; only ids with a time
+        // count, so pages of random ids are always skipped.
+        std::vector<std::span<const uuid>> select_time(const uuid_time_point from, const uuid_time_point to) const;
+
+    private:
+        template<typename P>
+        std::vector<std::span<const uuid>> select_pages(const P& overlaps) const;
+
+        mapped_file file;
+        std::span<const uuid> all;
+        std::span<const __internal::page_stats> index;
+        size_t ids_per_page = 0u;
+        bool ordered = false;
+    };
+
+} // namespace rfc4122
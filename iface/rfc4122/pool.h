@@ -0,0 +1,196 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+
+#include <rfc4122/uuid.h>
+
+
+
+namespace rfc4122
+{
+    namespace __internal
+    {
+
+        // Bounded multi-producer multi-consumer queue after Dmitry Vyukov:
+        // every cell carries a sequence number telling whose turn it is, so a
+        // push or pop is one compare-exchange on its own position and never
+        // waits for another thread. `capacity` is rounded up to a power of two.
+        template<typename T>
+        class mpmc_ring
+        {
+        public:
+            explicit mpmc_ring(const size_t capacity)
+                : mask{std::bit_ceil(std::max<size_t>(capacity, 2u)) - 1u}
+                , cells{std::make_unique<cell[]>(mask + 1u)}
+            {
+                for(size_t i = 0; i <= mask; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            size_t capacity() const noexcept {return mask + 1u;}
+
+            // Approximate while others push and pop.
+            size_t size() const noexcept
+            {
+                const size_t tail = dequeue_position.load(std::memory_order_relaxed);
+                const size_t head = enqueue_position.load(std::memory_order_relaxed);
+                return head > tail ? std::min(head - tail, capacity()) : 0u;
+            }
+
+            size_t pushed() const noexcept {return enqueue_position.load(std::memory_order_relaxed);}
+            size_t popped() const noexcept {return dequeue_position.load(std::memory_order_relaxed);}
+
+            bool try_push(const T& value) noexcept
+            {
+                size_t position = enqueue_position.load(std::memory_order_relaxed);
+                for(;;)
+                {
+                    cell& slot = cells[position & mask];
+                    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                    const auto lag = static_cast<std::ptrdiff_t>(sequence - position);
+                    if(lag < 0) return false;
+                    if(0 == lag)
+                    {
+                        if(enqueue_position.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed))
+                        {
+                            slot.value = value;
+                            slot.sequence.store(position + 1u, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else
+                    {
+                        position = enqueue_position.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            bool try_pop(T& value) noexcept
+            {
+                size_t position = dequeue_position.load(std::memory_order_relaxed);
+                for(;;)
+                {
+                    cell& slot = cells[position & mask];
+                    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                    const auto lag = static_cast<std::ptrdiff_t>(sequence - (position + 1u));
+                    if(lag < 0) return false;
+                    if(0 == lag)
+                    {
+                        if(dequeue_position.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed))
+                        {
+                            value = slot.value;
+                            slot.sequence.store(position + mask + 1u, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else
+                    {
+                        position = dequeue_position.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+        private:
+            struct cell
+            {
+                std::atomic<size_t> sequence;
+                T value;
+            };
+
+            const size_t mask;
+            std::unique_ptr<cell[]> cells;
+            alignas(64) std::atomic<size_t> enqueue_position{0u};
+            alignas(64) std::atomic<size_t> dequeue_position{0u};
+        };
+
+    } // __internal
+
+    // What pop() does when the ring is empty.
+    enum class drained_policy: uint8_t
+    {
+          wait      // until the refill thread has pushed more
+        , generate  // make the id in the calling thread
+    };
+
+    struct id_pool_options
+    {
+        // Random, time-based, reordered time or Unix time.
+        rfc4122::version version = rfc4122::version::random;
+        size_t capacity = 4096u;
+        // Refills start once no more than this many ids are left.
+        size_t low_watermark = 1024u;
+        drained_policy when_drained = drained_policy::generate;
+    };
+
+    struct id_pool_metrics
+    {
+        size_t size;             // ids ready now
+        size_t lowest_size;      // fewest ids ready when a refill started
+        uint64_t popped;
+        uint64_t generated;      // by the refill thread
+        uint64_t refills;
+        uint64_t drained;        // pops that found the ring empty
+        uint64_t fallbacks;      // ids generated by callers instead
+    };
+
+    // Hands out ids made ahead of time by a background thread, so a pop is a
+    // few atomic operations with no syscall even when the generator stalls on
+    // entropy or the clock. The ring starts full. A pop that takes it down to
+    // the low watermark wakes the refill thread, the one pop per refill that
+    // makes a syscall. Time-based ids carry the time they were made, not the
+    // time they were popped. A pool is shared by any number of threads.
+    class id_pool
+    {
+    public:
+        // Name-based versions and a low watermark not below the capacity,
+        // once rounded up, are refused with std::invalid_argument.
+        explicit id_pool(const id_pool_options& options = {});
+        ~id_pool();
+
+        id_pool(const id_pool&) = delete;
+        id_pool& operator = (const id_pool&) = delete;
+
+        // Drained, it waits or generates as the options say.
+        uuid pop();
+
+        bool try_pop(uuid& id) noexcept;
+
+        id_pool_metrics metrics() const noexcept;
+        const id_pool_options& options() const noexcept {return settings;}
+
+    private:
+        void refill_loop();
+        void wake_refiller() noexcept;
+
+        const id_pool_options settings;
+        void (*const generate)(std::span<uuid>);
+        __internal::mpmc_ring<uuid> ring;
+
+        // Bumped by pops to wake the refill thread; `refill_pending` keeps it
+        // to one pop per refill.
+        alignas(64) std::atomic<uint32_t> refill_requests{0u};
+        std::atomic<bool> refill_pending{false};
+        std::atomic<bool> stopping{false};
+
+        // Bumped by the refill thread after every batch, for waiting pops.
+        alignas(64) std::atomic<uint32_t> refilled{0u};
+        std::atomic<uint32_t> waiters{0u};
+
+        alignas(64) std::atomic<uint64_t> drained{0u};
+        std::atomic<uint64_t> fallbacks{0u};
+        std::atomic<uint64_t> refills{0u};
+        std::atomic<size_t> lowest_size;
+
+        std::thread refiller;
+    };
+
+} // namespace rfc4122
@@ -0,0 +1,27 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <cstdint>
+
+
+
+namespace rfc4122
+{
+    namespace __internal
+    {
+
+        enum class instruction_set: uint8_t
+        {
+              scalar = 0
+            , ssse3  = 1
+            , avx2   = 2
+        };
+
+        // Best kernel family the running CPU supports, detected once per process.
+        instruction_set detected_instruction_set() noexcept;
+
+    } // __internal
+
+} // namespace rfc4122
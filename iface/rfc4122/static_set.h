@@ -0,0 +1,181 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <rfc4122/uuid.h>
+
+
+
+namespace rfc4122
+{
+    namespace __internal
+    {
+
+        // Not constexpr, see malformed_uuid_literal().
+        inline void duplicate_id_in_static_set() noexcept {}
+        inline void no_perfect_hash_found() noexcept {}
+
+    } // __internal
+
+    // Fixed set of ids with a perfect hash built by the compiler, for
+    // matching against well-known ids: a lookup is one hash, one bucket
+    // displacement and one slot compare, and nothing runs at startup.
+    //
+    //     static constexpr rfc4122::static_uuid_set KNOWN{{  "..."_uuid
+    //                                                      , "..."_uuid }};
+    //
+    // The hash is built by hash and displace: ids go into buckets of about
+    // four by one half of their hash, and each bucket, largest first, gets
+    // the displacement that puts all its ids into free slots of a table twice
+    // their number. Duplicate ids do not compile.
+    template<size_t N>
+    class static_uuid_set
+    {
+        static_assert(N > 0u && N < (size_t{1} << 24), "from one id to a few million");
+
+    public:
+        static constexpr size_t SLOTS   = std::bit_ceil(2u * N);
+        static constexpr size_t BUCKETS = (N + 3u) / 4u;
+
+        consteval explicit static_uuid_set(const uuid (&ids)[N])
+            : static_uuid_set{std::to_array(ids)}
+        {}
+
+        consteval explicit static_uuid_set(const std::array<uuid, N>& ids)
+        {
+            std::array<uuid, N> sorted = ids;
+            std::sort(std::begin(sorted), std::end(sorted));
+            if(std::end(sorted) != std::adjacent_find(std::begin(sorted), std::end(sorted))) __internal::duplicate_id_in_static_set();
+
+            for(seed = 0u; seed < MAX_SEEDS; ++seed)
+            {
+                if(build(ids)) return;
+            }
+            __internal::no_perfect_hash_found();
+        }
+
+        static constexpr size_t size() noexcept {return N;}
+
+        // Position of `id` in the list the set was built from.
+        constexpr std::optional<size_t> find(const uuid& id) const noexcept
+        {
+            const entry& found = slots[slot_of(hash(id, seed))];
+            if(found.position < N && found.key == id) return found.position;
+            return std::nullopt;
+        }
+
+        constexpr bool contains(const uuid& id) const noexcept
+        {
+            const entry& found = slots[slot_of(hash(id, seed))];
+            return found.position < N && found.key == id;
+        }
+
+    private:
+        static constexpr uint64_t MAX_SEEDS = 64u;
+        static constexpr uint32_t MAX_DISPLACEMENTS = 1u << 16;
+
+        struct entry
+        {
+            uuid key{};
+            uint32_t position = N;
+        };
+
+        static constexpr size_t bucket_of(const uint64_t hashed) noexcept
+        {
+            return static_cast<size_t>(((hashed >> 32) * BUCKETS) >> 32);
+        }
+
+        static constexpr uint32_t displacement_of(const uint32_t index) noexcept
+        {
+            return static_cast<uint32_t>(__internal::fold_multiply(index, 0x9e3779b97f4a7c15u));
+        }
+
+        // Multiplied after the displacement, as a plain xor would keep the
+        // ids of a bucket that share low bits together in every slot.
+        static constexpr size_t place(const uint64_t hashed, const uint32_t displacement) noexcept
+        {
+            return static_cast<size_t>(((hashed ^ displacement) * 0xc6a4a7935bd1e995u) >> (64 - std::countr_zero(SLOTS)));
+        }
+
+        constexpr size_t slot_of(const uint64_t hashed) const noexcept
+        {
+            return place(hashed, displacements[bucket_of(hashed)]);
+        }
+
+        // Tries the current seed, false if some bucket found no displacement.
+        consteval bool build(const std::array<uuid, N>& ids)
+        {
+            std::array<uint64_t, N> hashes{};
+            std::array<uint32_t, BUCKETS + 1u> starts{};
+            for(size_t i = 0; i < N; ++i)
+            {
+                hashes[i] = hash(ids[i], seed);
+                ++starts[bucket_of(hashes[i]) + 1u];
+            }
+            for(size_t bucket = 0; bucket < BUCKETS; ++bucket) starts[bucket + 1u] += starts[bucket];
+
+            std::array<uint32_t, N> members{};
+            std::array<uint32_t, BUCKETS> filled{};
+            for(uint32_t i = 0; i < N; ++i)
+            {
+                const size_t bucket = bucket_of(hashes[i]);
+                members[starts[bucket] + filled[bucket]++] = i;
+            }
+
+            std::array<uint32_t, BUCKETS> order{};
+            for(uint32_t bucket = 0; bucket < BUCKETS; ++bucket) order[bucket] = bucket;
+            std::sort(std::begin(order), std::end(order), [&](const uint32_t left, const uint32_t right)
+            {
+                return filled[left] > filled[right] || (filled[left] == filled[right] && left < right);
+            });
+
+            slots = {};
+            std::array<bool, SLOTS> taken{};
+            for(const uint32_t bucket: order)
+            {
+                if(0u == filled[bucket]) break;
+                bool placed = false;
+                for(uint32_t index = 0; index < MAX_DISPLACEMENTS && !placed; ++index)
+                {
+                    const uint32_t displacement = displacement_of(index);
+                    placed = true;
+                    for(uint32_t member = starts[bucket]; member < starts[bucket + 1u]; ++member)
+                    {
+                        const size_t slot = place(hashes[members[member]], displacement);
+                        if(taken[slot])
+                        {
+                            for(uint32_t undo = starts[bucket]; undo < member; ++undo) taken[place(hashes[members[undo]], displacement)] = false;
+                            placed = false;
+                            break;
+                        }
+                        taken[slot] = true;
+                    }
+                    if(placed) displacements[bucket] = displacement;
+                }
+                if(!placed) return false;
+            }
+
+            for(uint32_t i = 0; i < N; ++i) slots[slot_of(hashes[i])] = entry{ids[i], i};
+            return true;
+        }
+
+        uint64_t seed = 0u;
+        std::array<uint32_t, BUCKETS> displacements{};
+        std::array<entry, SLOTS> slots{};
+    };
+
+    template<size_t N>
+    static_uuid_set(const uuid (&)[N]) -> static_uuid_set<N>;
+
+    template<size_t N>
+    static_uuid_set(const std::array<uuid, N>&) -> static_uuid_set<N>;
+
+} // namespace rfc4122
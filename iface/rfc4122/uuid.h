@@ -3,16 +3,24 @@
 // Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
 //
 
+#include <array>
+#include <bit>
+#include <chrono>
+#include <compare>
 #include <cstdint>
 #include <cctype>
 #include <cinttypes>
+#include <functional>
 #include <optional>
+#include <span>
 #include <utility>
 #include <string>
 #include <string_view>
 #include <ostream>
 #include <istream>
 
+#include <rfc4122/metrics.h>
+
 
 
 namespace rfc4122
@@ -191,7 +199,7 @@ namespace rfc4122
 
                 if constexpr (host == target)
                 {
-                    int shift = static_cast<int>(to - from - 1);
+                    int shift = static_cast<int>(8 * (to - from - 1));
                     for(auto i = from; i < to; ++i, shift -= 8)
                     {
                         byte[i] = static_cast<uint8_t>((value >> shift) & V{0xFF});
@@ -210,13 +218,37 @@ namespace rfc4122
             template<uint16_t from, uint16_t to, size_t bytes_size, typename V>
             static constexpr void value_to_net_bytes(uint8_t (&byte)[bytes_size], const V value) noexcept
             {
-                value_to_bytes<from,to,net>(byte, value);
+                value_to_bytes<from,to,other(net)>(byte, value);
             }
 
             template<uint16_t from, uint16_t to, size_t bytes_size, typename V>
             static constexpr void value_to_little_bytes(uint8_t (&byte)[bytes_size], const V value) noexcept
             {
-                value_to_bytes<from,to,little_endian>(byte, value);
+                value_to_bytes<from,to,other(little_endian)>(byte, value);
+            }
+
+            // Half of the 16 octets as one word in host order, a plain load.
+            static constexpr uint64_t host_word(const uint8_t (&byte)[16], const size_t index) noexcept
+            {
+                return std::bit_cast<std::array<uint64_t, 2>>(byte)[index];
+            }
+
+            // Half of the 16 octets as one big-endian word, so words compare
+            // like the octets do.
+            static constexpr uint64_t net_word(const uint8_t (&byte)[16], const size_t index) noexcept
+            {
+                const uint64_t word = host_word(byte, index);
+                if constexpr (host == net)
+                {
+                    return word;
+                }
+#if defined(__GNUC__)
+                return __builtin_bswap64(word);
+#else
+                uint64_t swapped = 0u;
+                for(int i = 0; i < 8; ++i) swapped = (swapped << 8) | (0xFFu & (word >> (8 * i)));
+                return swapped;
+#endif
             }
         };
 
@@ -254,6 +286,10 @@ namespace rfc4122
 
         static constexpr uint32_t PARTS_QUARTETS_COUNT[] = {8u, 4u, 4u, 4u, 12u};
 
+        // 100ns intervals between the Gregorian reform, 1582-10-15, and the Unix epoch.
+        static constexpr uint64_t GREGORIAN_TO_UNIX = 0x01B21DD213814000u;
+        using gregorian_ticks = std::chrono::duration<int64_t, std::ratio<1, 10'000'000>>;
+
         using quartet = std::byte;
         using octet   = uint8_t;
 
@@ -304,22 +340,37 @@ namespace rfc4122
 
     enum class variant: uint8_t
     {
-		  unknown           = 0b11000000
+		  unknown           = 0b11111111
 		, ncs_compatibility = 0b00000000
 		, rfc4122           = 0b10000000
-		, microsoft         = 0b10100000
+		, microsoft         = 0b11000000
 		, future            = 0b11100000
 	};
 
     enum class version: uint8_t
     {
-          time_based   = 1
-        , dce_security = 2
-        , md5_name     = 3
-        , random       = 4
-        , sha1_name    = 5
+          time_based     = 1
+        , dce_security   = 2
+        , md5_name       = 3
+        , random         = 4
+        , sha1_name      = 5
+        , reordered_time = 6
+        , unix_time      = 7
     };
 
+    namespace __internal
+    {
+
+        // Bits of octet 8 taken by the variant, the rest belongs to the clock sequence.
+        constexpr uint8_t variant_mask(const rfc4122::variant variant) noexcept
+        {
+            return    variant == rfc4122::variant::ncs_compatibility ? 0b10000000
+                    : variant == rfc4122::variant::rfc4122           ? 0b11000000
+                    :                                                  0b11100000;
+        }
+
+    } // __internal
+
     struct uuid
     {
         constexpr uuid() noexcept = default;
@@ -350,63 +401,60 @@ namespace rfc4122
             __internal::byte_order::value_to_net_bytes<10,16>(byte, part5);
         }
 
+        // Inverse of high() and low().
+        constexpr uuid(const uint64_t high, const uint64_t low) noexcept
+        {
+            __internal::byte_order::value_to_net_bytes<0, 8>(byte, high);
+            __internal::byte_order::value_to_net_bytes<8,16>(byte, low);
+        }
+
         constexpr uuid(   const uint64_t timestamp
                         , const rfc4122::variant variant
                         , const rfc4122::version version 
                         , const uint16_t clock_sequence
                         , const uint64_t node           ) noexcept
         {
-            __internal::byte_order::value_to_little_bytes< 0, 7>(byte, timestamp);
-            byte[7] = (0xF0 & static_cast<uint8_t>(variant))
-                    | (0x0F & static_cast<uint8_t>(version));
+            const uint16_t time_high = (0x0FFF & static_cast<uint16_t>(timestamp >> 48))
+                                     | (0xF000 & static_cast<uint16_t>(static_cast<uint16_t>(version) << 12));
+            const uint8_t  reserved  = __internal::variant_mask(variant);
+            __internal::byte_order::value_to_net_bytes< 0, 4>(byte, static_cast<uint32_t>(timestamp));
+            __internal::byte_order::value_to_net_bytes< 4, 6>(byte, static_cast<uint16_t>(timestamp >> 32));
+            __internal::byte_order::value_to_net_bytes< 6, 8>(byte, time_high);
             __internal::byte_order::value_to_net_bytes< 8,10>(byte, clock_sequence);
             __internal::byte_order::value_to_net_bytes<10,16>(byte, node);
+            byte[8] = (reserved & static_cast<uint8_t>(variant)) | (~reserved & byte[8]);
         }
 
-#ifndef __cpp_impl_three_way_comparison
         constexpr bool operator == (const uuid& other) const noexcept
         {
-            return byte[ 0] == other.byte[ 0]
-                && byte[ 1] == other.byte[ 1]
-                && byte[ 2] == other.byte[ 2]
-                && byte[ 3] == other.byte[ 3]
-                && byte[ 4] == other.byte[ 4]
-                && byte[ 5] == other.byte[ 5]
-                && byte[ 6] == other.byte[ 6]
-                && byte[ 7] == other.byte[ 7]
-                && byte[ 8] == other.byte[ 8]
-                && byte[ 9] == other.byte[ 9]
-                && byte[10] == other.byte[10]
-                && byte[11] == other.byte[11];
+            using __internal::byte_order;
+            return 0u == (  (byte_order::host_word(byte, 0) ^ byte_order::host_word(other.byte, 0))
+                          | (byte_order::host_word(byte, 1) ^ byte_order::host_word(other.byte, 1)) );
         }
 
+#ifndef __cpp_impl_three_way_comparison
         constexpr bool operator != (const uuid& other) const noexcept
         {
             return !(*this == other);
         }
+
+        constexpr bool operator < (const uuid& other) const noexcept
+        {
+            return high() < other.high() || (high() == other.high() && low() < other.low());
+        }
 #else
-        constexpr auto operator <=> (const uuid& other) const noexcept
-        {
-            constexpr auto equal = uint8_t{0} <=> uint8_t{0};
-            auto temp = equal;
-            const auto result =
-                  equal != (temp = byte[ 0] <=> other.byte[ 0]) ? temp
-                : equal != (temp = byte[ 1] <=> other.byte[ 1]) ? temp
-                : equal != (temp = byte[ 2] <=> other.byte[ 2]) ? temp
-                : equal != (temp = byte[ 3] <=> other.byte[ 3]) ? temp
-                : equal != (temp = byte[ 4] <=> other.byte[ 4]) ? temp
-                : equal != (temp = byte[ 5] <=> other.byte[ 5]) ? temp
-                : equal != (temp = byte[ 6] <=> other.byte[ 6]) ? temp
-                : equal != (temp = byte[ 7] <=> other.byte[ 7]) ? temp
-                : equal != (temp = byte[ 8] <=> other.byte[ 8]) ? temp
-                : equal != (temp = byte[ 9] <=> other.byte[ 9]) ? temp
-                : equal != (temp = byte[10] <=> other.byte[10]) ? temp
-                : equal != (temp = byte[11] <=> other.byte[11]) ? temp
-                : equal;
-            return result;
+        constexpr std::strong_ordering operator <=> (const uuid& other) const noexcept
+        {
+            const auto order = high() <=> other.high();
+            return order != 0 ? order : low() <=> other.low();
         }
 #endif // __cpp_impl_three_way_comparison
 
+        // Octets 0-7 and 8-15 as big-endian numbers. (high, low) orders ids
+        // the same way as their octets and their literals.
+        constexpr uint64_t high() const noexcept {return __internal::byte_order::net_word(byte, 0);}
+        constexpr uint64_t low () const noexcept {return __internal::byte_order::net_word(byte, 1);}
+
         constexpr uint32_t part1() const noexcept {return __internal::byte_order::bytes_from_net_to_value(byte[0],byte[1],byte[2],byte[3]);}
         constexpr uint16_t part2() const noexcept {return __internal::byte_order::bytes_from_net_to_value(byte[4],byte[5]);}
         constexpr uint16_t part3() const noexcept {return __internal::byte_order::bytes_from_net_to_value(byte[6],byte[7]);}
@@ -415,32 +463,31 @@ namespace rfc4122
 
         constexpr uint64_t timestamp() const noexcept 
         {
-            return __internal::byte_order::bytes_from_little_to_value
-            (
-                  byte[0], byte[1], byte[2], byte[3]
-                , byte[4], byte[5], byte[6], byte[7] & 0xF0
-            );
+            return    (static_cast<uint64_t>(part3() & 0x0FFF) << 48)
+                    | (static_cast<uint64_t>(part2()         ) << 32)
+                    |  static_cast<uint64_t>(part1()         );
         }
 
         constexpr rfc4122::variant variant() const noexcept
         {
             using variants = rfc4122::variant;
-            const uint8_t byte7 = byte[7];
-            return    (byte7 & 0b10000000) == static_cast<uint8_t>(variants::ncs_compatibility) ? variants::ncs_compatibility
-                    : (byte7 & 0b11000000) == static_cast<uint8_t>(variants::rfc4122          ) ? variants::rfc4122
-                    : (byte7 & 0b11100000) == static_cast<uint8_t>(variants::microsoft        ) ? variants::microsoft
-                    : (byte7 & 0b11100000) == static_cast<uint8_t>(variants::future           ) ? variants::future
+            const uint8_t byte8 = byte[8];
+            return    (byte8 & 0b10000000) == static_cast<uint8_t>(variants::ncs_compatibility) ? variants::ncs_compatibility
+                    : (byte8 & 0b11000000) == static_cast<uint8_t>(variants::rfc4122          ) ? variants::rfc4122
+                    : (byte8 & 0b11100000) == static_cast<uint8_t>(variants::microsoft        ) ? variants::microsoft
+                    : (byte8 & 0b11100000) == static_cast<uint8_t>(variants::future           ) ? variants::future
                     : rfc4122::variant::unknown;
         }
 
         constexpr rfc4122::version version() const noexcept
         {
-            return static_cast<rfc4122::version>(byte[7] & 0x0F);
+            return static_cast<rfc4122::version>(byte[6] >> 4);
         }
 
         constexpr uint16_t clock_sequence() const noexcept 
         {
-            return part4() & 0x3F;
+            const uint16_t reserved = static_cast<uint16_t>(__internal::variant_mask(variant()) << 8);
+            return part4() & static_cast<uint16_t>(~reserved);
         }
 
         constexpr uint64_t node() const noexcept 
@@ -448,43 +495,181 @@ namespace rfc4122
             return part5();
         }
 
+        // Timestamp of a reordered time (version 6) id, in the same 100ns
+        // Gregorian ticks as timestamp() of a time-based id.
+        constexpr uint64_t reordered_timestamp() const noexcept
+        {
+            return    (static_cast<uint64_t>(part1()         ) << 28)
+                    | (static_cast<uint64_t>(part2()         ) << 12)
+                    |  static_cast<uint64_t>(part3() & 0x0FFF);
+        }
+
+        // Milliseconds since the Unix epoch of a Unix time (version 7) id.
+        constexpr uint64_t unix_timestamp() const noexcept
+        {
+            return    (static_cast<uint64_t>(part1()) << 16)
+                    |  static_cast<uint64_t>(part2());
+        }
+
     private:
         uint8_t byte[16] = {};
         
         template<typename C>
         friend constexpr void to_literal(literal<C>& buffer, const uuid& id) noexcept;
 
-        template<typename C>
-        friend constexpr uuid from_string(const C* const text, const size_t length) noexcept;
-
-        template<typename C, typename T>
-        friend std::basic_istream<C,T>& parse(std::basic_istream<C,T>& input, rfc4122::uuid& id);    
-
     }; // uuid
     static_assert(16u == sizeof(uuid));
     static_assert(std::is_trivially_copyable_v<uuid>);
 
     static constexpr uuid NIL_UUID{};
 
-    // uuid generate_uuid();
+    namespace __internal
+    {
 
-    template<typename C>
-    constexpr void to_literal(literal<C>& buffer, const uuid& id) noexcept
+        // 64x64 to 128 bit multiply with the halves folded together, the mixing step of wyhash.
+        constexpr uint64_t fold_multiply(const uint64_t left, const uint64_t right) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            const unsigned __int128 product = static_cast<unsigned __int128>(left) * right;
+            return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+            const uint64_t ll = (left & 0xFFFFFFFFu) * (right & 0xFFFFFFFFu);
+            const uint64_t lh = (left & 0xFFFFFFFFu) * (right >> 32);
+            const uint64_t hl = (left >> 32) * (right & 0xFFFFFFFFu);
+            const uint64_t hh = (left >> 32) * (right >> 32);
+            const uint64_t middle = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+            const uint64_t low  = (middle << 32) | (ll & 0xFFFFFFFFu);
+            const uint64_t high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+            return low ^ high;
+#endif
+        }
+
+    } // __internal
+
+    // Mixes all 128 bits, so sequential time-based ids spread as well as random ones.
+    constexpr uint64_t hash(const uuid& id, const uint64_t seed = 0u) noexcept
     {
+        const uint64_t mixed = __internal::fold_multiply(id.high() ^ seed ^ 0xa0761d6478bd642fu, id.low() ^ 0xe7037ed1a0b428dbu);
+        return __internal::fold_multiply(mixed ^ 0x8ebc6af09c88c6e3u, seed ^ 0x589965cc75374cc3u);
+    }
+
+    // Random seed drawn once per process.
+    uint64_t process_hash_seed() noexcept;
+
+    // Hasher for unordered containers, std::hash<uuid> is the unseeded one.
+    struct uuid_hash
+    {
+        uint64_t seed = 0u;
+
+        constexpr size_t operator () (const uuid& id) const noexcept
+        {
+            return static_cast<size_t>(hash(id, seed));
+        }
+    };
+
+    // For tables keyed by ids from untrusted input: crafted collisions stop
+    // working once the seed is unknown.
+    struct seeded_uuid_hash: uuid_hash
+    {
+        seeded_uuid_hash() noexcept: uuid_hash{process_hash_seed()} {}
+    };
+
+    // Name spaces of RFC 4122, appendix C.
+    static constexpr uuid NAMESPACE_DNS {0x6ba7b810u, 0x9dadu, 0x11d1u, 0x80b4u, 0x00c04fd430c8u};
+    static constexpr uuid NAMESPACE_URL {0x6ba7b811u, 0x9dadu, 0x11d1u, 0x80b4u, 0x00c04fd430c8u};
+    static constexpr uuid NAMESPACE_OID {0x6ba7b812u, 0x9dadu, 0x11d1u, 0x80b4u, 0x00c04fd430c8u};
+    static constexpr uuid NAMESPACE_X500{0x6ba7b814u, 0x9dadu, 0x11d1u, 0x80b4u, 0x00c04fd430c8u};
+
+    // Random (version 4) ids, drawn from a per-thread pool that is refilled
+    // from the operating system in bulk.
+    uuid generate_uuid();
+    void generate_n(const std::span<uuid> ids);
+
+    // Time-based (version 1) ids. Timestamps are strictly increasing across
+    // all threads of the process; a wall clock that moves backwards bumps the
+    // clock sequence instead of repeating timestamps, and so does fork() in
+    // the child. The node is host_node() of rfc4122/node.h.
+    uuid generate_time_based_uuid();
+    void generate_time_based_n(const std::span<uuid> ids);
+
+    // Reordered time (version 6) ids: version 1 ids with the timestamp moved
+    // to the front, so they sort by creation time.
+    uuid generate_reordered_time_uuid();
+    void generate_reordered_time_n(const std::span<uuid> ids);
+
+    // Unix time (version 7) ids: a millisecond timestamp, a 12-bit counter
+    // that keeps ids of the same millisecond increasing, and 62 random bits.
+    uuid generate_unix_time_uuid();
+    void generate_unix_time_n(const std::span<uuid> ids);
+
+    // Name-based ids: the md5 (version 3) or sha1 (version 5) digest of the
+    // name space followed by the name. The batch forms hash several names at
+    // once, one per vector lane.
+    uuid generate_md5_uuid (const uuid& name_space, const std::string_view name) noexcept;
+    uuid generate_sha1_uuid(const uuid& name_space, const std::string_view name) noexcept;
+    void generate_md5_n (const uuid& name_space, const std::span<const std::string_view> names, const std::span<uuid> ids) noexcept;
+    void generate_sha1_n(const uuid& name_space, const std::span<const std::string_view> names, const std::span<uuid> ids) noexcept;
+
+    // Creation time of time-based, reordered time and Unix time ids.
+    constexpr std::optional<std::chrono::system_clock::time_point> to_time_point(const uuid& id) noexcept
+    {
+        using namespace std::chrono;
         using namespace rfc4122::__internal;
 
-        auto symbol_index = 0u;
-        auto  octet_index = 0u;
-        for(auto quartets_count: PARTS_QUARTETS_COUNT)
+        const auto gregorian = [](const uint64_t timestamp) noexcept
         {
-            for(auto i = 0u; i < quartets_count; i += 2u, ++octet_index)
+            const gregorian_ticks since_unix{static_cast<int64_t>(timestamp) - static_cast<int64_t>(GREGORIAN_TO_UNIX)};
+            return system_clock::time_point{duration_cast<system_clock::duration>(since_unix)};
+        };
+        switch(id.version())
+        {
+            case version::time_based    : return gregorian(id.timestamp());
+            case version::reordered_time: return gregorian(id.reordered_timestamp());
+            case version::unix_time     : return system_clock::time_point{duration_cast<system_clock::duration>(milliseconds{id.unix_timestamp()})};
+            default: return std::nullopt;
+        }
+    }
+
+    namespace __internal
+    {
+
+        template<typename C>
+        constexpr void write_literal(literal<C>& buffer, const uint8_t (&bytes)[16]) noexcept
+        {
+            auto symbol_index = 0u;
+            auto  octet_index = 0u;
+            for(auto quartets_count: PARTS_QUARTETS_COUNT)
             {
-                buffer[symbol_index++] = high_hex(id.byte[octet_index]); 
-                buffer[symbol_index++] =  low_hex(id.byte[octet_index]);
+                for(auto i = 0u; i < quartets_count; i += 2u, ++octet_index)
+                {
+                    buffer[symbol_index++] = high_hex(bytes[octet_index]); 
+                    buffer[symbol_index++] =  low_hex(bytes[octet_index]);
+                }
+                if(symbol_index >= UUID_STRING_LENGTH) break;
+                buffer[symbol_index++] = '-';
             }
-            if(symbol_index >= UUID_STRING_LENGTH) break;
-            buffer[symbol_index++] = '-';
         }
+
+        template<typename C>
+        void metered_to_literal(literal<C>& buffer, const uint8_t (&bytes)[16]) noexcept
+        {
+            const meter timer{metered_operation::format};
+            write_literal(buffer, bytes);
+            timer.done();
+        }
+
+    } // __internal
+
+    template<typename C>
+    constexpr void to_literal(literal<C>& buffer, const uuid& id) noexcept
+    {
+        using namespace rfc4122::__internal;
+
+        if constexpr(METRICS_ENABLED)
+        {
+            if(!std::is_constant_evaluated()) return metered_to_literal(buffer, id.byte);
+        }
+        write_literal(buffer, id.byte);
     }
 
     template<typename C, typename T>
@@ -512,28 +697,117 @@ namespace rfc4122
     static std::u32string to_u32string(const rfc4122::uuid& id) {return to_basic_string<std::u32string>(id);}
 
 
-    template<typename C>
-    constexpr uuid from_string(const C* const text, const size_t length) noexcept
+    namespace __internal
     {
-        using namespace rfc4122::__internal;
-        
-        uuid id{};
-        auto symbol_index = 0u;
-        auto  octet_index = 0u;
-        for(auto quartets_count: PARTS_QUARTETS_COUNT)
+
+        template<typename C>
+        constexpr bool is_space(const C symbol) noexcept
+        {
+            const auto code = static_cast<uint32_t>(symbol);
+            return ' ' == code || ('\t' <= code && code <= '\r');
+        }
+
+        constexpr bool is_dash_index(const size_t index) noexcept
         {
-            for(auto i = 0u; i < quartets_count; i += 2u, ++octet_index)
+            return 8u == index || 13u == index || 18u == index || 23u == index;
+        }
+
+        // Value of every 7-bit symbol as a hex digit, 0xFF if it is none.
+        static constexpr auto HEX_VALUES = []() constexpr
+        {
+            std::array<uint8_t, 128> values{};
+            for(auto code = 0u; code < std::size(values); ++code)
             {
-                const C high = text[symbol_index++];
-                const C  low = text[symbol_index++];
-                const std::optional<octet> temp = hexes_to_octet(high, low);
-                if(!temp) break;
-                id.byte[octet_index] = *temp;
+                const auto quartet = hex_to_quartet(static_cast<char>(code));
+                values[code] = quartet ? static_cast<uint8_t>(*quartet) : uint8_t{0xFF};
             }
-            if(symbol_index >= UUID_STRING_LENGTH) break;
-            if('-' != text[symbol_index++]) return uuid{};
+            return values;
+        }();
+
+        template<typename C>
+        constexpr uint32_t hex_value(const C symbol) noexcept
+        {
+            const auto code = static_cast<uint32_t>(symbol);
+            return code < std::size(HEX_VALUES) ? HEX_VALUES[code] : 0xFFu;
         }
-        return id;
+
+        // Whether `symbol` may stand at `index` of a canonical literal.
+        template<typename C>
+        constexpr bool fits_literal(const size_t index, const C symbol) noexcept
+        {
+            return is_dash_index(index) ? '-' == static_cast<uint32_t>(symbol) : hex_value(symbol) < 0x10u;
+        }
+
+        // Offsets of the 32 hex digits within a canonical literal.
+        static constexpr auto LITERAL_DIGITS = []() constexpr
+        {
+            std::array<uint8_t, 32> offsets{};
+            for(auto index = 0u, digit = 0u; index < UUID_STRING_LENGTH; ++index)
+            {
+                if(!is_dash_index(index)) offsets[digit++] = static_cast<uint8_t>(index);
+            }
+            return offsets;
+        }();
+
+        // Decodes 32 hex digits found at `offsets` from `text`; the two
+        // halves are built side by side.
+        template<typename C>
+        constexpr bool decode_digits(const C* const text, const std::array<uint8_t, 32>& offsets, uuid& id) noexcept
+        {
+            uint64_t high = 0u;
+            uint64_t low  = 0u;
+            uint32_t invalid = 0u;
+            for(auto digit = 0u; digit < 16u; ++digit)
+            {
+                const uint32_t high_value = hex_value(text[offsets[digit      ]]);
+                const uint32_t low_value  = hex_value(text[offsets[digit + 16u]]);
+                invalid |= high_value | low_value;
+                high = (high << 4) | high_value;
+                low  = (low  << 4) | low_value;
+            }
+            if(0u != (invalid & 0xF0u)) return false;
+            id = uuid{high, low};
+            return true;
+        }
+
+        // Decodes UUID_STRING_LENGTH symbols of `text`, all of which must fit.
+        template<typename C>
+        constexpr bool decode_literal(const C* const text, uuid& id) noexcept
+        {
+            const uint32_t dashes =   ('-' ^ static_cast<uint32_t>(text[ 8]))
+                                    | ('-' ^ static_cast<uint32_t>(text[13]))
+                                    | ('-' ^ static_cast<uint32_t>(text[18]))
+                                    | ('-' ^ static_cast<uint32_t>(text[23]));
+            return 0u == dashes && decode_digits(text, LITERAL_DIGITS, id);
+        }
+
+    } // __internal
+
+    namespace __internal
+    {
+
+        template<typename C>
+        uuid metered_from_string(const C* const text, const size_t length) noexcept
+        {
+            const meter timer{metered_operation::parse};
+            uuid id{};
+            const bool valid = UUID_STRING_LENGTH == length && decode_literal(text, id);
+            timer.done(1u, valid ? 0u : 1u);
+            return valid ? id : uuid{};
+        }
+
+    } // __internal
+
+    // The canonical literal, in either case; NIL_UUID if `text` is anything else.
+    template<typename C>
+    constexpr uuid from_string(const C* const text, const size_t length) noexcept
+    {
+        if constexpr(METRICS_ENABLED)
+        {
+            if(!std::is_constant_evaluated()) return __internal::metered_from_string(text, length);
+        }
+        uuid id{};
+        return UUID_STRING_LENGTH == length && __internal::decode_literal(text, id) ? id : uuid{};
     }
 
     template<typename C>
@@ -554,39 +828,160 @@ namespace rfc4122
         return from_string(std::basic_string_view<C,std::char_traits<C>>{text});
     }
 
-    template<typename C, typename T>
-    std::basic_istream<C,T>& parse(std::basic_istream<C,T>& input, rfc4122::uuid& id)
+    namespace __internal
+    {
+
+        // Not constexpr: reaching it while evaluating a literal at compile
+        // time stops the build, with its name in the diagnostic.
+        inline void malformed_uuid_literal() noexcept {}
+
+        // The canonical literal, anything else does not compile.
+        template<typename C>
+        consteval uuid checked_literal(const C* const text, const size_t length)
+        {
+            uuid id{};
+            if(UUID_STRING_LENGTH != length || !decode_literal(text, id)) malformed_uuid_literal();
+            return id;
+        }
+
+    } // __internal
+
+    namespace __internal
     {
-        using namespace rfc4122::__internal;
 
-        uint8_t* byte = std::data(id.byte);
-        const uint8_t* const end_byte = byte + std::size(id.byte);
-        for(auto quartets_count: PARTS_QUARTETS_COUNT)
+        // Reaches the get area of any stream buffer through its protected accessors.
+        template<typename C, typename T>
+        struct get_area: std::basic_streambuf<C,T>
+        {
+            static const C* next(std::basic_streambuf<C,T>& buffer) noexcept {return (buffer.*&get_area::gptr )();}
+            static const C* end (std::basic_streambuf<C,T>& buffer) noexcept {return (buffer.*&get_area::egptr)();}
+            static void bump(std::basic_streambuf<C,T>& buffer, const int count) noexcept {(buffer.*&get_area::gbump)(count);}
+        };
+
+        // Extracts one literal from `buffer`, skipping leading whitespace if
+        // asked. Returns the state it ends in: goodbit with `id` set, eofbit
+        // alone when only whitespace was left, otherwise failbit (with eofbit
+        // if the literal was cut short) and NIL_UUID. A malformed literal is
+        // consumed up to its first wrong symbol.
+        template<typename C, typename T>
+        std::ios_base::iostate extract(std::basic_streambuf<C,T>& buffer, const bool skip, uuid& id)
         {
-            for(auto i = 0u; i < quartets_count; i += 2u)
+            using int_type = typename T::int_type;
+
+            int_type next = buffer.sgetc();
+            while(skip && !T::eq_int_type(next, T::eof()) && is_space(T::to_char_type(next))) next = buffer.snextc();
+            if(T::eq_int_type(next, T::eof()))
             {
-                const auto high = hex_to_quartet(static_cast<char>(input.peek()));
-                if(!high) break;
-                input.get();
-
-                const auto low = hex_to_quartet(static_cast<char>(input.peek()));
-                if(!low) break;
-                input.get();
-                
-                const octet temp = (static_cast<octet>(*high) << 4) 
-                                 |  static_cast<octet>(*low);
-                *byte++ = temp;
+                id = uuid{};
+                return std::ios_base::eofbit;
             }
 
-            if(end_byte <= byte) break;
+            // Fast path: the whole literal is already in the get area.
+            const C* const first = get_area<C,T>::next(buffer);
+            if(   get_area<C,T>::end(buffer) - first >= static_cast<std::ptrdiff_t>(UUID_STRING_LENGTH)
+               && decode_literal(first, id) )
+            {
+                get_area<C,T>::bump(buffer, static_cast<int>(UUID_STRING_LENGTH));
+                return std::ios_base::goodbit;
+            }
 
-            const C dash = input.peek();
-            if('-' != dash) break;
-            input.get();
+            C text[UUID_STRING_LENGTH] = {};
+            size_t index = 0u;
+            std::ios_base::iostate state = std::ios_base::goodbit;
+            while(index < UUID_STRING_LENGTH)
+            {
+                if(T::eq_int_type(next, T::eof()))
+                {
+                    state |= std::ios_base::eofbit;
+                    break;
+                }
+                const C symbol = T::to_char_type(next);
+                if(!fits_literal(index, symbol)) break;
+                text[index++] = symbol;
+                buffer.sbumpc();
+                if(index < UUID_STRING_LENGTH) next = buffer.sgetc();
+            }
+            if(UUID_STRING_LENGTH == index && decode_literal(text, id)) return state;
+            id = uuid{};
+            return state | std::ios_base::failbit;
         }
+
+        // Sets badbit after `buffer` threw, rethrowing if the stream asks for it.
+        template<typename C, typename T>
+        void stream_threw(std::basic_istream<C,T>& input)
+        {
+            try
+            {
+                input.setstate(std::ios_base::badbit);
+            }
+            catch(...)
+            {
+            }
+            if(input.exceptions() & std::ios_base::badbit) throw;
+        }
+
+    } // __internal
+
+    // Extracts a canonical literal, skipping leading whitespace when the
+    // stream skips it. Sets failbit and stores NIL_UUID if there is none.
+    template<typename C, typename T>
+    std::basic_istream<C,T>& parse(std::basic_istream<C,T>& input, rfc4122::uuid& id)
+    {
+        // Whitespace is skipped here: there is no ctype facet for char8_t and friends.
+        const typename std::basic_istream<C,T>::sentry sentry{input, true};
+        if(!sentry)
+        {
+            id = uuid{};
+            return input;
+        }
+        const __internal::meter timer{metered_operation::parse};
+        std::ios_base::iostate state = std::ios_base::goodbit;
+        try
+        {
+            state = __internal::extract(*input.rdbuf(), 0 != (input.flags() & std::ios_base::skipws), id);
+            if(std::ios_base::eofbit == state) state |= std::ios_base::failbit;
+        }
+        catch(...)
+        {
+            __internal::stream_threw(input);
+            return input;
+        }
+        timer.done(1u, 0u != (state & std::ios_base::failbit) ? 1u : 0u);
+        if(state) input.setstate(state);
         return input;
     }
 
+    // Extracts whitespace separated literals into `output` until the stream
+    // ends, which leaves eofbit alone, or until something else than a
+    // literal comes, which sets failbit. Returns the end of the output.
+    template<typename C, typename T, typename O>
+    O parse_all(std::basic_istream<C,T>& input, O output)
+    {
+        const typename std::basic_istream<C,T>::sentry sentry{input, true};
+        if(!sentry) return output;
+        const __internal::meter timer{metered_operation::parse};
+        std::ios_base::iostate state = std::ios_base::goodbit;
+        uint64_t count = 0u;
+        try
+        {
+            auto& buffer = *input.rdbuf();
+            uuid id{};
+            while(std::ios_base::goodbit == (state = __internal::extract(buffer, true, id)))
+            {
+                *output++ = id;
+                ++count;
+            }
+        }
+        catch(...)
+        {
+            __internal::stream_threw(input);
+            return output;
+        }
+        timer.done(count, 0u != (state & std::ios_base::failbit) ? 1u : 0u);
+        input.setstate(state);
+        return output;
+    }
+
 } // namespace rfc4122
 
 namespace std
@@ -601,29 +996,30 @@ using rfc4122::to_u32string;
 }
 
 
-constexpr rfc4122::uuid operator"" _uuid(const char* const text, const size_t length) noexcept
+// Checked at compile time: a malformed literal does not build.
+consteval rfc4122::uuid operator"" _uuid(const char* const text, const size_t length)
 {
-    return rfc4122::from_string(text, length);
+    return rfc4122::__internal::checked_literal(text, length);
 }
 
-constexpr rfc4122::uuid operator"" _uuid(const char8_t* const text, const size_t length) noexcept
+consteval rfc4122::uuid operator"" _uuid(const char8_t* const text, const size_t length)
 {
-    return rfc4122::from_string(text, length);
+    return rfc4122::__internal::checked_literal(text, length);
 }
 
-constexpr rfc4122::uuid operator"" _uuid(const wchar_t* const text, const size_t length) noexcept
+consteval rfc4122::uuid operator"" _uuid(const wchar_t* const text, const size_t length)
 {
-    return rfc4122::from_string(text, length);
+    return rfc4122::__internal::checked_literal(text, length);
 }
 
-constexpr rfc4122::uuid operator"" _uuid(const char16_t* const text, const size_t length) noexcept
+consteval rfc4122::uuid operator"" _uuid(const char16_t* const text, const size_t length)
 {
-    return rfc4122::from_string(text, length);
+    return rfc4122::__internal::checked_literal(text, length);
 }
 
-constexpr rfc4122::uuid operator"" _uuid(const char32_t* const text, const size_t length) noexcept
+consteval rfc4122::uuid operator"" _uuid(const char32_t* const text, const size_t length)
 {
-    return rfc4122::from_string(text, length);
+    return rfc4122::__internal::checked_literal(text, length);
 }
 
 template<typename C, typename T>
@@ -637,3 +1033,7 @@ std::basic_istream<C,T>& operator >> (std::basic_istream<C,T>& input, rfc4122::u
 {
     return rfc4122::parse(input, id);
 }
+
+template<>
+struct std::hash<rfc4122::uuid>: rfc4122::uuid_hash
+{};
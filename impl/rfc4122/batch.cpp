@@ -0,0 +1,324 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include <rfc4122/batch.h>
+
+#include "records.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RFC4122_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+using namespace rfc4122::__internal;
+using namespace rfc4122;
+
+namespace
+{
+
+    void to_literals_scalar(   const std::span<const uuid> ids
+                             , char* buffer
+                             , const std::optional<char> delimiter ) noexcept
+    {
+        for(const uuid& id: ids)
+        {
+            literal<char> text{};
+            to_literal(text, id);
+            std::memcpy(buffer, std::data(text), UUID_STRING_LENGTH);
+            buffer += UUID_STRING_LENGTH;
+            if(delimiter) *buffer++ = *delimiter;
+        }
+    }
+
+    bool from_literal_scalar(const char* const text, uuid& id) noexcept
+    {
+        uint8_t octets[sizeof(uuid)] = {};
+        auto symbol_index = 0u;
+        auto  octet_index = 0u;
+        for(auto quartets_count: PARTS_QUARTETS_COUNT)
+        {
+            for(auto i = 0u; i < quartets_count; i += 2u, symbol_index += 2u)
+            {
+                const std::optional<octet> temp = hexes_to_octet(text[symbol_index], text[symbol_index + 1u]);
+                if(!temp) return false;
+                octets[octet_index++] = *temp;
+            }
+            if(symbol_index >= UUID_STRING_LENGTH) break;
+            if('-' != text[symbol_index++]) return false;
+        }
+        std::memcpy(&id, octets, sizeof(id));
+        return true;
+    }
+
+    struct scalar_kernel
+    {
+        static constexpr bool pairs = false;
+        static constexpr ptrdiff_t length = UUID_STRING_LENGTH;
+
+        static bool decode(const char* const text, uuid& id) noexcept
+        {
+            return from_literal_scalar(text, id);
+        }
+    };
+
+#ifdef RFC4122_X86_KERNELS
+
+    // Every kernel below splits the 16 octets into nibbles, maps them to hex
+    // letters with one shuffle and then moves the 32 letters into the
+    // 8-4-4-4-12 layout:
+    //   head = letters[ 0..13] with dashes at  8 and 13 -> symbols[ 0..15]
+    //   tail = letters[14..29] with dashes at  2 and  7 -> symbols[16..31]
+    //   letters[28..31]                                  -> symbols[32..35]
+
+    __attribute__((target("ssse3")))
+    void to_literals_ssse3(   const std::span<const uuid> ids
+                            , char* buffer
+                            , const std::optional<char> delimiter ) noexcept
+    {
+        const __m128i letters      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HEX_LETTERS));
+        const __m128i low_mask     = _mm_set1_epi8(0x0F);
+        const __m128i head_shuffle = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, -1, 8, 9, 10, 11, -1, 12, 13);
+        const __m128i head_dashes  = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, '-', 0, 0, 0, 0, '-', 0, 0);
+        const __m128i tail_shuffle = _mm_setr_epi8(0, 1, -1, 2, 3, 4, 5, -1, 6, 7, 8, 9, 10, 11, 12, 13);
+        const __m128i tail_dashes  = _mm_setr_epi8(0, 0, '-', 0, 0, 0, 0, '-', 0, 0, 0, 0, 0, 0, 0, 0);
+
+        for(const uuid& id: ids)
+        {
+            const __m128i octets = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&id));
+            const __m128i high   = _mm_shuffle_epi8(letters, _mm_and_si128(_mm_srli_epi16(octets, 4), low_mask));
+            const __m128i low    = _mm_shuffle_epi8(letters, _mm_and_si128(octets, low_mask));
+            const __m128i first  = _mm_unpacklo_epi8(high, low);
+            const __m128i second = _mm_unpackhi_epi8(high, low);
+
+            const __m128i head = _mm_or_si128(_mm_shuffle_epi8(first, head_shuffle), head_dashes);
+            const __m128i tail = _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(second, first, 14), tail_shuffle), tail_dashes);
+            const uint32_t last = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(second, 12)));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer     ), head);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + 16), tail);
+            std::memcpy(buffer + 32, &last, sizeof(last));
+            buffer += UUID_STRING_LENGTH;
+            if(delimiter) *buffer++ = *delimiter;
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void to_literals_avx2(   const std::span<const uuid> ids
+                           , char* buffer
+                           , const std::optional<char> delimiter ) noexcept
+    {
+        const __m256i letters      = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(HEX_LETTERS)));
+        const __m256i low_mask     = _mm256_set1_epi8(0x0F);
+        const __m256i head_shuffle = _mm256_setr_epi8( 0, 1, 2, 3, 4, 5, 6, 7, -1, 8, 9, 10, 11, -1, 12, 13
+                                                     , 0, 1, 2, 3, 4, 5, 6, 7, -1, 8, 9, 10, 11, -1, 12, 13 );
+        const __m256i head_dashes  = _mm256_setr_epi8( 0, 0, 0, 0, 0, 0, 0, 0, '-', 0, 0, 0, 0, '-', 0, 0
+                                                     , 0, 0, 0, 0, 0, 0, 0, 0, '-', 0, 0, 0, 0, '-', 0, 0 );
+        const __m256i tail_shuffle = _mm256_setr_epi8( 0, 1, -1, 2, 3, 4, 5, -1, 6, 7, 8, 9, 10, 11, 12, 13
+                                                     , 0, 1, -1, 2, 3, 4, 5, -1, 6, 7, 8, 9, 10, 11, 12, 13 );
+        const __m256i tail_dashes  = _mm256_setr_epi8( 0, 0, '-', 0, 0, 0, 0, '-', 0, 0, 0, 0, 0, 0, 0, 0
+                                                     , 0, 0, '-', 0, 0, 0, 0, '-', 0, 0, 0, 0, 0, 0, 0, 0 );
+        const size_t stride = literals_size(1u, delimiter.has_value());
+
+        const size_t pairs = std::size(ids) / 2u;
+        const uuid* id = std::data(ids);
+        for(size_t i = 0; i < pairs; ++i, id += 2)
+        {
+            // Lanes never mix: the low lane formats id[0], the high lane id[1].
+            const __m256i octets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(id));
+            const __m256i high   = _mm256_shuffle_epi8(letters, _mm256_and_si256(_mm256_srli_epi16(octets, 4), low_mask));
+            const __m256i low    = _mm256_shuffle_epi8(letters, _mm256_and_si256(octets, low_mask));
+            const __m256i first  = _mm256_unpacklo_epi8(high, low);
+            const __m256i second = _mm256_unpackhi_epi8(high, low);
+
+            const __m256i head = _mm256_or_si256(_mm256_shuffle_epi8(first, head_shuffle), head_dashes);
+            const __m256i tail = _mm256_or_si256(_mm256_shuffle_epi8(_mm256_alignr_epi8(second, first, 14), tail_shuffle), tail_dashes);
+            const __m256i last = _mm256_srli_si256(second, 12);
+
+            const uint32_t last0 = static_cast<uint32_t>(_mm256_extract_epi32(last, 0));
+            const uint32_t last1 = static_cast<uint32_t>(_mm256_extract_epi32(last, 4));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer     ), _mm256_castsi256_si128(head));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + 16), _mm256_castsi256_si128(tail));
+            std::memcpy(buffer + 32, &last0, sizeof(last0));
+            if(delimiter) buffer[UUID_STRING_LENGTH] = *delimiter;
+            buffer += stride;
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer     ), _mm256_extracti128_si256(head, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + 16), _mm256_extracti128_si256(tail, 1));
+            std::memcpy(buffer + 32, &last1, sizeof(last1));
+            if(delimiter) buffer[UUID_STRING_LENGTH] = *delimiter;
+            buffer += stride;
+        }
+        to_literals_ssse3(ids.subspan(2u * pairs), buffer, delimiter);
+    }
+
+
+    // Decoding gathers the 32 hex symbols of a literal into two vectors:
+    //   first  = symbols[ 0..7, 9..12, 14..17]
+    //   second = symbols[19..22, 24..35]
+    // turns them into nibbles (rejecting anything but [0-9A-Fa-f]) and joins
+    // nibble pairs into octets with one multiply-add.
+
+    __attribute__((target("ssse3")))
+    inline __m128i hexes_to_nibbles(const __m128i hexes, int& valid) noexcept
+    {
+        const __m128i digit  = _mm_sub_epi8(hexes, _mm_set1_epi8('0'));
+        const __m128i letter = _mm_sub_epi8(_mm_or_si128(hexes, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        const __m128i is_digit  = _mm_cmpeq_epi8(_mm_min_epu8(digit , _mm_set1_epi8(9)), digit );
+        const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+        valid &= _mm_movemask_epi8(_mm_or_si128(is_digit, is_letter));
+        return _mm_or_si128(   _mm_and_si128(is_digit , digit)
+                             , _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))) );
+    }
+
+    struct ssse3_kernel
+    {
+        static constexpr bool pairs = false;
+        static constexpr ptrdiff_t length = UUID_STRING_LENGTH;
+
+        __attribute__((target("ssse3")))
+        static bool decode(const char* const text, uuid& id) noexcept
+        {
+            const __m128i dash = _mm_set1_epi8('-');
+            const __m128i in0  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text     ));
+            const __m128i in1  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 16));
+            uint32_t tail = 0u;
+            std::memcpy(&tail, text + 32, sizeof(tail));
+            const __m128i in2  = _mm_cvtsi32_si128(static_cast<int>(tail));
+
+            const int dashes0 = _mm_movemask_epi8(_mm_cmpeq_epi8(in0, dash));
+            const int dashes1 = _mm_movemask_epi8(_mm_cmpeq_epi8(in1, dash));
+            if(0x2100 != (dashes0 & 0x2100) || 0x0084 != (dashes1 & 0x0084)) return false;
+
+            const __m128i first  = _mm_or_si128(   _mm_shuffle_epi8(in0, _mm_setr_epi8( 0,  1,  2,  3,  4,  5,  6,  7,  9, 10, 11, 12, 14, 15, -1, -1))
+                                                 , _mm_shuffle_epi8(in1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  1)) );
+            const __m128i second = _mm_or_si128(   _mm_shuffle_epi8(in1, _mm_setr_epi8( 3,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1))
+                                                 , _mm_shuffle_epi8(in2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  1,  2,  3)) );
+            int valid = 0xFFFF;
+            const __m128i high = hexes_to_nibbles(first , valid);
+            const __m128i low  = hexes_to_nibbles(second, valid);
+            if(0xFFFF != valid) return false;
+
+            const __m128i weights = _mm_set1_epi16(0x0110);
+            const __m128i octets  = _mm_packus_epi16(_mm_maddubs_epi16(high, weights), _mm_maddubs_epi16(low, weights));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&id), octets);
+            return true;
+        }
+    };
+
+    __attribute__((target("avx2")))
+    inline __m256i hexes_to_nibbles(const __m256i hexes, uint32_t& valid) noexcept
+    {
+        const __m256i digit  = _mm256_sub_epi8(hexes, _mm256_set1_epi8('0'));
+        const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(hexes, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        const __m256i is_digit  = _mm256_cmpeq_epi8(_mm256_min_epu8(digit , _mm256_set1_epi8(9)), digit );
+        const __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+        valid &= static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)));
+        return _mm256_or_si256(   _mm256_and_si256(is_digit , digit)
+                                , _mm256_and_si256(is_letter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))) );
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i load_lanes(const char* const low, const char* const high) noexcept
+    {
+        return _mm256_inserti128_si256(   _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(low)))
+                                        , _mm_loadu_si128(reinterpret_cast<const __m128i*>(high)), 1 );
+    }
+
+    struct avx2_kernel: ssse3_kernel
+    {
+        static constexpr bool pairs = true;
+
+        // The low lane decodes the record at `text`, the high lane the one
+        // right after it; returns one validity bit per record.
+        __attribute__((target("avx2")))
+        static unsigned decode_pair(const char* const text, uuid* const id) noexcept
+        {
+            constexpr ptrdiff_t stride = UUID_STRING_LENGTH + 1u;
+
+            uint32_t tails[2] = {};
+            std::memcpy(&tails[0], text + 32         , sizeof(uint32_t));
+            std::memcpy(&tails[1], text + 32 + stride, sizeof(uint32_t));
+
+            const __m256i dash = _mm256_set1_epi8('-');
+            const __m256i in0  = load_lanes(text     , text + stride     );
+            const __m256i in1  = load_lanes(text + 16, text + stride + 16);
+            const __m256i in2  = _mm256_setr_epi32(static_cast<int>(tails[0]), 0, 0, 0, static_cast<int>(tails[1]), 0, 0, 0);
+
+            const uint32_t dashes0 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(in0, dash)));
+            const uint32_t dashes1 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(in1, dash)));
+
+            const __m256i first  = _mm256_or_si256(   _mm256_shuffle_epi8(in0, _mm256_setr_epi8( 0,  1,  2,  3,  4,  5,  6,  7,  9, 10, 11, 12, 14, 15, -1, -1
+                                                                                               ,  0,  1,  2,  3,  4,  5,  6,  7,  9, 10, 11, 12, 14, 15, -1, -1))
+                                                    , _mm256_shuffle_epi8(in1, _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  1
+                                                                                               , -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  1)) );
+            const __m256i second = _mm256_or_si256(   _mm256_shuffle_epi8(in1, _mm256_setr_epi8( 3,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1
+                                                                                               ,  3,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1))
+                                                    , _mm256_shuffle_epi8(in2, _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  1,  2,  3
+                                                                                               , -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  1,  2,  3)) );
+            uint32_t valid = 0xFFFFFFFFu;
+            const __m256i high = hexes_to_nibbles(first , valid);
+            const __m256i low  = hexes_to_nibbles(second, valid);
+
+            const __m256i weights = _mm256_set1_epi16(0x0110);
+            const __m256i octets  = _mm256_packus_epi16(_mm256_maddubs_epi16(high, weights), _mm256_maddubs_epi16(low, weights));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(id), octets);
+
+            const auto lane_valid = [&](const unsigned lane) noexcept -> unsigned
+            {
+                const unsigned shift = 16u * lane;
+                return    0xFFFFu == ((valid   >> shift) & 0xFFFFu)
+                       && 0x2100u == ((dashes0 >> shift) & 0x2100u)
+                       && 0x0084u == ((dashes1 >> shift) & 0x0084u) ? 1u : 0u;
+            };
+            return lane_valid(0u) | (lane_valid(1u) << 1u);
+        }
+    };
+
+#endif // RFC4122_X86_KERNELS
+
+} // namespace
+
+
+namespace rfc4122::__internal
+{
+
+    void to_literals(   const instruction_set kernel
+                      , const std::span<const uuid> ids
+                      , char* const buffer
+                      , const std::optional<char> delimiter ) noexcept
+    {
+#ifdef RFC4122_X86_KERNELS
+        switch(kernel)
+        {
+            case instruction_set::avx2 : return to_literals_avx2 (ids, buffer, delimiter);
+            case instruction_set::ssse3: return to_literals_ssse3(ids, buffer, delimiter);
+            default: break;
+        }
+#endif
+        to_literals_scalar(ids, buffer, delimiter);
+    }
+
+    literals_result from_literals(   const instruction_set kernel
+                                   , const std::string_view text
+                                   , const std::span<uuid> ids
+                                   , const std::span<uint64_t> validity
+                                   , const char delimiter ) noexcept
+    {
+#ifdef RFC4122_X86_KERNELS
+        switch(kernel)
+        {
+            case instruction_set::avx2 : return parse_records<avx2_kernel >(text, ids, validity, delimiter);
+            case instruction_set::ssse3: return parse_records<ssse3_kernel>(text, ids, validity, delimiter);
+            default: break;
+        }
+#endif
+        return parse_records<scalar_kernel>(text, ids, validity, delimiter);
+    }
+
+} // namespace rfc4122::__internal
@@ -0,0 +1,408 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include <rfc4122/algorithm.h>
+#include <rfc4122/column.h>
+
+using namespace rfc4122;
+
+namespace
+{
+
+    // Image layout: the header, the first id of each block, the payload
+    // offset of each block, then the payload followed by PADDING zero octets
+    // so that decoding may always load whole words. A block in the payload is
+    // one octet with the bit width of its differences, then the differences
+    // of its ids but the first, packed least significant bit first.
+    constexpr char MAGIC[8] = {'U', 'U', 'I', 'D', 'C', 'O', 'L', '1'};
+    constexpr size_t PADDING = 32u;
+
+    struct header
+    {
+        char magic[8];
+        uint64_t count;
+        uint64_t blocks;
+        uint64_t payload_size;
+        uint64_t fixed_high;
+        uint64_t fixed_low;
+        uint8_t runs[8][2];
+    };
+    static_assert(64u == sizeof(header));
+
+    struct u128
+    {
+        uint64_t high = 0u;
+        uint64_t low = 0u;
+    };
+
+    u128 operator + (const u128 left, const u128 right) noexcept
+    {
+        const uint64_t low = left.low + right.low;
+        return {left.high + right.high + (low < left.low), low};
+    }
+
+    u128 operator - (const u128 left, const u128 right) noexcept
+    {
+        return {left.high - right.high - (left.low < right.low), left.low - right.low};
+    }
+
+    u128 operator & (const u128 left, const u128 right) noexcept {return {left.high & right.high, left.low & right.low};}
+    u128 operator | (const u128 left, const u128 right) noexcept {return {left.high | right.high, left.low | right.low};}
+    u128 operator ~ (const u128 value) noexcept {return {~value.high, ~value.low};}
+
+    u128 operator << (const u128 value, const size_t shift) noexcept
+    {
+        if(0u == shift) return value;
+        if(shift >= 128u) return {};
+        if(shift >= 64u) return {value.low << (shift - 64u), 0u};
+        return {(value.high << shift) | (value.low >> (64u - shift)), value.low << shift};
+    }
+
+    u128 operator >> (const u128 value, const size_t shift) noexcept
+    {
+        if(0u == shift) return value;
+        if(shift >= 128u) return {};
+        if(shift >= 64u) return {0u, value.high >> (shift - 64u)};
+        return {value.high >> shift, (value.low >> shift) | (value.high << (64u - shift))};
+    }
+
+    u128 ones(const size_t count) noexcept
+    {
+        return count >= 128u ? ~u128{} : (u128{0u, 1u} << count) - u128{0u, 1u};
+    }
+
+    size_t bit_width(const u128 value) noexcept
+    {
+        return 0u != value.high ? 64u + std::bit_width(value.high) : std::bit_width(value.low);
+    }
+
+    bool test_bit(const u128 value, const size_t bit) noexcept
+    {
+        return 0u != ((bit >= 64u ? value.high >> (bit - 64u) : value.low >> bit) & 1u);
+    }
+
+    uint64_t load_little(const uint8_t* const bytes) noexcept
+    {
+        uint64_t value = 0u;
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        for(size_t i = 8u; i-- > 0u; ) value = (value << 8) | bytes[i];
+        return value;
+    }
+
+    // `width` bits from bit `bit` on; 17 octets from the first one are readable.
+    u128 read_bits(const uint8_t* const bytes, const size_t bit, const size_t width) noexcept
+    {
+        const uint8_t* const first = bytes + bit / 8u;
+        const size_t shift = bit % 8u;
+        u128 value = u128{load_little(first + 8u), load_little(first)} >> shift;
+        if(0u != shift) value.high |= static_cast<uint64_t>(first[16]) << (64u - shift);
+        return value & ones(width);
+    }
+
+    void write_bits(uint8_t* const bytes, const size_t bit, const u128 value) noexcept
+    {
+        uint8_t* const first = bytes + bit / 8u;
+        const size_t shift = bit % 8u;
+        const u128 shifted = value << shift;
+        for(size_t i = 0; i < 8u; ++i)
+        {
+            first[i]      |= static_cast<uint8_t>(shifted.low  >> (8u * i));
+            first[i + 8u] |= static_cast<uint8_t>(shifted.high >> (8u * i));
+        }
+        if(0u != shift) first[16] |= static_cast<uint8_t>(value.high >> (64u - shift));
+    }
+
+} // namespace
+
+
+namespace rfc4122
+{
+
+    uuid sorted_column::iterator::operator * () const noexcept
+    {
+        return column->expand(high, low);
+    }
+
+    sorted_column::iterator& sorted_column::iterator::operator ++ () noexcept
+    {
+        if(++position >= column->count) return *this;
+        if(0u == position % BLOCK_SIZE)
+        {
+            enter(position / BLOCK_SIZE);
+            return *this;
+        }
+        const u128 value = u128{high, low} + read_bits(block + 1u, bit, width);
+        bit += width;
+        high = value.high;
+        low  = value.low;
+        return *this;
+    }
+
+    void sorted_column::iterator::enter(const size_t index) noexcept
+    {
+        position = index * BLOCK_SIZE;
+        block    = column->payload + column->block_offset(index);
+        width    = block[0];
+        bit      = 0u;
+        std::tie(high, low) = column->compact(column->first_key(index));
+    }
+
+
+    sorted_column::sorted_column(const std::span<const uuid> ids)
+    {
+        std::vector<uuid> sorted(std::begin(ids), std::end(ids));
+        rfc4122::sort(sorted);
+        sorted.erase(std::unique(std::begin(sorted), std::end(sorted)), std::end(sorted));
+
+        const size_t total  = std::size(sorted);
+        const size_t chunks = (total + BLOCK_SIZE - 1u) / BLOCK_SIZE;
+        header head{{MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3], MAGIC[4], MAGIC[5], MAGIC[6], MAGIC[7]}, total, chunks, 0u, 0u, 0u, {}};
+
+        // Bits that differ anywhere, grouped in runs.
+        u128 varying{};
+        for(const auto& id: sorted) varying = varying | u128{id.high() ^ sorted[0].high(), id.low() ^ sorted[0].low()};
+        size_t stored = 0u;
+        for(size_t bit = 0; bit < 128u; ++bit)
+        {
+            if(!test_bit(varying, bit)) continue;
+            if(MAX_RUNS == stored)
+            {
+                // Out of runs, the last one stretches over the remaining gaps.
+                head.runs[MAX_RUNS - 1u][1] = static_cast<uint8_t>(bit_width(varying) - head.runs[MAX_RUNS - 1u][0]);
+                break;
+            }
+            size_t end = bit;
+            while(end < 128u && test_bit(varying, end)) ++end;
+            head.runs[stored][0] = static_cast<uint8_t>(bit);
+            head.runs[stored][1] = static_cast<uint8_t>(end - bit);
+            ++stored;
+            bit = end;
+        }
+        u128 kept{};
+        for(size_t run = 0; run < stored; ++run) kept = kept | (ones(head.runs[run][1]) << head.runs[run][0]);
+        const u128 fixed = total > 0u ? u128{sorted[0].high(), sorted[0].low()} & ~kept : u128{};
+        head.fixed_high = fixed.high;
+        head.fixed_low  = fixed.low;
+        std::memcpy(runs, head.runs, sizeof(runs));
+        runs_count = stored;
+
+        std::vector<uint8_t> payload_bytes;
+        std::vector<uint64_t> block_offsets(chunks);
+        std::vector<u128> deltas;
+        for(size_t block = 0; block < chunks; ++block)
+        {
+            const size_t first = block * BLOCK_SIZE;
+            const size_t last  = std::min(total, first + BLOCK_SIZE);
+            deltas.clear();
+            size_t width = 0u;
+            for(size_t i = first + 1u; i < last; ++i)
+            {
+                const auto [high, low] = compact(sorted[i]);
+                const auto [previous_high, previous_low] = compact(sorted[i - 1u]);
+                deltas.push_back(u128{high, low} - u128{previous_high, previous_low});
+                width = std::max(width, bit_width(deltas.back()));
+            }
+            block_offsets[block] = std::size(payload_bytes);
+            const size_t offset = std::size(payload_bytes);
+            payload_bytes.resize(offset + 1u + (std::size(deltas) * width + 7u) / 8u + 17u);
+            payload_bytes[offset] = static_cast<uint8_t>(width);
+            for(size_t i = 0; i < std::size(deltas); ++i) write_bits(std::data(payload_bytes) + offset + 1u, i * width, deltas[i]);
+            payload_bytes.resize(offset + 1u + (std::size(deltas) * width + 7u) / 8u);
+        }
+        head.payload_size = std::size(payload_bytes);
+
+        owned.resize(sizeof(header) + chunks * (sizeof(uuid) + sizeof(uint64_t)) + std::size(payload_bytes) + PADDING);
+        std::byte* out = std::data(owned);
+        std::memcpy(out, &head, sizeof(header));
+        out += sizeof(header);
+        for(size_t block = 0; block < chunks; ++block, out += sizeof(uuid)) std::memcpy(out, &sorted[block * BLOCK_SIZE], sizeof(uuid));
+        std::memcpy(out, std::data(block_offsets), chunks * sizeof(uint64_t));
+        out += chunks * sizeof(uint64_t);
+        std::memcpy(out, std::data(payload_bytes), std::size(payload_bytes));
+        attach(owned);
+    }
+
+    sorted_column::sorted_column(const std::filesystem::path& path)
+        : file{path}
+    {
+        if(!attach(file.bytes())) throw std::system_error(EINVAL, std::generic_category(), path.string());
+    }
+
+    sorted_column::sorted_column(sorted_column&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    sorted_column& sorted_column::operator = (sorted_column&& other) noexcept
+    {
+        if(this != &other)
+        {
+            // Heap buffers and mappings keep their addresses when moved.
+            owned      = std::move(other.owned);
+            file       = std::move(other.file);
+            image      = std::exchange(other.image, {});
+            count      = std::exchange(other.count, 0u);
+            blocks     = std::exchange(other.blocks, 0u);
+            keys       = std::exchange(other.keys, nullptr);
+            offsets    = std::exchange(other.offsets, nullptr);
+            payload    = std::exchange(other.payload, nullptr);
+            runs_count = std::exchange(other.runs_count, 0u);
+            fixed_high = other.fixed_high;
+            fixed_low  = other.fixed_low;
+            std::memcpy(runs, other.runs, sizeof(runs));
+        }
+        return *this;
+    }
+
+    bool sorted_column::attach(const std::span<const std::byte> bytes) noexcept
+    {
+        header head{};
+        if(std::size(bytes) < sizeof(header)) return false;
+        std::memcpy(&head, std::data(bytes), sizeof(header));
+        if(0 != std::memcmp(head.magic, MAGIC, sizeof(MAGIC))) return false;
+        if(head.blocks != (head.count + BLOCK_SIZE - 1u) / BLOCK_SIZE) return false;
+        if(head.blocks > std::size(bytes) || head.payload_size > std::size(bytes)) return false;
+        const uint64_t index_size = head.blocks * (sizeof(uuid) + sizeof(uint64_t));
+        if(std::size(bytes) != sizeof(header) + index_size + head.payload_size + PADDING) return false;
+
+        size_t stored = 0u;
+        size_t bits = 0u;
+        for(; stored < MAX_RUNS && 0u != head.runs[stored][1]; ++stored)
+        {
+            if(head.runs[stored][0] + head.runs[stored][1] > 128u) return false;
+            bits += head.runs[stored][1];
+        }
+        if(bits > 128u) return false;
+
+        image      = bytes;
+        count      = head.count;
+        blocks     = head.blocks;
+        keys       = std::data(bytes) + sizeof(header);
+        offsets    = keys + blocks * sizeof(uuid);
+        payload    = reinterpret_cast<const uint8_t*>(offsets + blocks * sizeof(uint64_t));
+        runs_count = stored;
+        fixed_high = head.fixed_high;
+        fixed_low  = head.fixed_low;
+        std::memcpy(runs, head.runs, sizeof(runs));
+        for(size_t block = 0; block < blocks; ++block)
+        {
+            const uint64_t offset = block_offset(block);
+            if(offset >= head.payload_size) return false;
+            const size_t width = payload[offset];
+            if(width > 128u) return false;
+            // Deltas that end within the payload leave whole word loads
+            // within PADDING past it.
+            const size_t deltas = std::min<size_t>(BLOCK_SIZE, count - block * BLOCK_SIZE) - 1u;
+            if((deltas * width + 7u) / 8u > head.payload_size - offset - 1u) return false;
+        }
+        return true;
+    }
+
+    uuid sorted_column::first_key(const size_t block) const noexcept
+    {
+        return uuid{keys + block * sizeof(uuid)};
+    }
+
+    uint64_t sorted_column::block_offset(const size_t block) const noexcept
+    {
+        uint64_t offset = 0u;
+        std::memcpy(&offset, offsets + block * sizeof(uint64_t), sizeof(offset));
+        return offset;
+    }
+
+    std::pair<uint64_t, uint64_t> sorted_column::compact(const uuid& id) const noexcept
+    {
+        const u128 value{id.high(), id.low()};
+        u128 packed{};
+        size_t position = 0u;
+        for(size_t run = 0; run < runs_count; ++run)
+        {
+            packed = packed | (((value >> runs[run][0]) & ones(runs[run][1])) << position);
+            position += runs[run][1];
+        }
+        return {packed.high, packed.low};
+    }
+
+    uuid sorted_column::expand(const uint64_t high, const uint64_t low) const noexcept
+    {
+        const u128 packed{high, low};
+        u128 value{fixed_high, fixed_low};
+        size_t position = 0u;
+        for(size_t run = 0; run < runs_count; ++run)
+        {
+            value = value | (((packed >> position) & ones(runs[run][1])) << runs[run][0]);
+            position += runs[run][1];
+        }
+        return {value.high, value.low};
+    }
+
+    sorted_column::iterator sorted_column::begin() const noexcept
+    {
+        iterator first;
+        first.column = this;
+        if(0u != count) first.enter(0u);
+        return first;
+    }
+
+    sorted_column::iterator sorted_column::end() const noexcept
+    {
+        iterator last;
+        last.column = this;
+        last.position = count;
+        return last;
+    }
+
+    sorted_column::iterator sorted_column::lower_bound(const uuid& key) const noexcept
+    {
+        // Blocks whose first id is not greater than the key.
+        size_t low = 0u, high = blocks;
+        while(low < high)
+        {
+            const size_t middle = low + (high - low) / 2u;
+            if(key < first_key(middle)) high = middle;
+            else                        low  = middle + 1u;
+        }
+        if(0u == low) return begin();
+
+        iterator found;
+        found.column = this;
+        found.enter(low - 1u);
+        const size_t block_end = std::min(count, low * BLOCK_SIZE);
+        const auto [key_high, key_low] = compact(key);
+        if(expand(key_high, key_low) != key)
+        {
+            while(found.position < block_end && *found < key) ++found;
+            return found;
+        }
+        // The key has the fixed bits of the column, compacted values order alike.
+        while(   found.position < block_end
+              && (found.high < key_high || (found.high == key_high && found.low < key_low)) ) ++found;
+        return found;
+    }
+
+    bool sorted_column::contains(const uuid& key) const noexcept
+    {
+        const auto found = lower_bound(key);
+        return found != end() && *found == key;
+    }
+
+    void sorted_column::save(const std::filesystem::path& path) const
+    {
+        file_writer writer{path};
+        writer.write(image);
+        writer.close();
+    }
+
+} // namespace rfc4122
@@ -0,0 +1,393 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <cstring>
+
+#include <rfc4122/encoding.h>
+
+#include "records.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RFC4122_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+using namespace rfc4122::__internal;
+using namespace rfc4122;
+
+namespace
+{
+
+    void encode_scalar(   const text_encoding encoding
+                        , const std::span<const uuid> ids
+                        , char* buffer
+                        , const std::optional<char> delimiter ) noexcept
+    {
+        for(const uuid& id: ids)
+        {
+            if(text_encoding::base64url == encoding)
+            {
+                base64url_literal<char> text{};
+                to_base64url(text, id);
+                std::memcpy(buffer, text, BASE64URL_LENGTH);
+            }
+            else
+            {
+                base32_literal<char> text{};
+                to_base32(text, id);
+                std::memcpy(buffer, text, BASE32_LENGTH);
+            }
+            buffer += encoded_length(encoding);
+            if(delimiter) *buffer++ = *delimiter;
+        }
+    }
+
+    struct base64url_scalar_kernel
+    {
+        static constexpr bool pairs = false;
+        static constexpr ptrdiff_t length = BASE64URL_LENGTH;
+
+        static bool decode(const char* const text, uuid& id) noexcept
+        {
+            return decode_base64url(text, id);
+        }
+    };
+
+    struct base32_scalar_kernel
+    {
+        static constexpr bool pairs = false;
+        static constexpr ptrdiff_t length = BASE32_LENGTH;
+
+        static bool decode(const char* const text, uuid& id) noexcept
+        {
+            return decode_base32(text, id);
+        }
+    };
+
+#ifdef RFC4122_X86_KERNELS
+
+    // base64url: octets are spread so every 32-bit lane holds one 3-octet
+    // group as [1, 0, 2, 1], two multiplies move its four sextets into the
+    // lane's bytes, and one shuffle maps them to letters. 16 octets make
+    // 5 such groups plus a last octet, handled as a group padded with zeros.
+
+    __attribute__((target("ssse3")))
+    inline __m128i base64url_letters(const __m128i spread) noexcept
+    {
+        const __m128i high    = _mm_mulhi_epu16(_mm_and_si128(spread, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        const __m128i low     = _mm_mullo_epi16(_mm_and_si128(spread, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        const __m128i sextets = _mm_or_si128(high, low);
+
+        // 0..25 -> 13, 26..51 -> 0, 52..63 -> 1..12, each picking the offset to its letter.
+        const __m128i offsets = _mm_setr_epi8( 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52
+                                             , '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0 );
+        const __m128i index   = _mm_or_si128(   _mm_subs_epu8(sextets, _mm_set1_epi8(51))
+                                              , _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), sextets), _mm_set1_epi8(13)) );
+        return _mm_add_epi8(sextets, _mm_shuffle_epi8(offsets, index));
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i base64url_letters(const __m256i spread) noexcept
+    {
+        const __m256i high    = _mm256_mulhi_epu16(_mm256_and_si256(spread, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+        const __m256i low     = _mm256_mullo_epi16(_mm256_and_si256(spread, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+        const __m256i sextets = _mm256_or_si256(high, low);
+
+        const __m256i offsets = _mm256_broadcastsi128_si256(_mm_setr_epi8( 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52
+                                                                         , '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0 ));
+        const __m256i index   = _mm256_or_si256(   _mm256_subs_epu8(sextets, _mm256_set1_epi8(51))
+                                                 , _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), sextets), _mm256_set1_epi8(13)) );
+        return _mm256_add_epi8(sextets, _mm256_shuffle_epi8(offsets, index));
+    }
+
+    // base32: symbol k >= 1 covers bits 5k-2 .. 5k+2 of the octet stream, so
+    // it sits in the big-endian 16-bit word of octets (5k-2)/8 and the next
+    // one. Shuffles build those words, a multiply-high shifts each right by
+    // 11 - (5k-2)%8 and the pattern repeats every 8 symbols (5 octets).
+    // Symbol 0 is the top 3 bits, the word (0, octet 0) shifted by 5.
+
+    __attribute__((target("ssse3")))
+    inline __m128i base32_quintets(const __m128i octets, const __m128i shuffle) noexcept
+    {
+        const __m128i shifts = _mm_setr_epi16(2048, 256, 32, 1024, 128, 4096, 512, 64);
+        return _mm_and_si128(_mm_mulhi_epu16(_mm_shuffle_epi8(octets, shuffle), shifts), _mm_set1_epi16(31));
+    }
+
+    __attribute__((target("ssse3")))
+    inline __m128i base32_letters(const __m128i quintets) noexcept
+    {
+        const __m128i low  = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(BASE32_LETTERS     )), quintets);
+        const __m128i high = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(BASE32_LETTERS + 16)), quintets);
+        const __m128i upper = _mm_cmpgt_epi8(quintets, _mm_set1_epi8(15));
+        return _mm_or_si128(_mm_and_si128(upper, high), _mm_andnot_si128(upper, low));
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i base32_quintets(const __m256i octets, const __m256i shuffle) noexcept
+    {
+        const __m256i shifts = _mm256_setr_epi16( 2048, 256, 32, 1024, 128, 4096, 512, 64
+                                                , 2048, 256, 32, 1024, 128, 4096, 512, 64 );
+        return _mm256_and_si256(_mm256_mulhi_epu16(_mm256_shuffle_epi8(octets, shuffle), shifts), _mm256_set1_epi16(31));
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i base32_letters(const __m256i quintets) noexcept
+    {
+        const __m256i low  = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(BASE32_LETTERS     ))), quintets);
+        const __m256i high = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(BASE32_LETTERS + 16))), quintets);
+        return _mm256_blendv_epi8(low, high, _mm256_cmpgt_epi8(quintets, _mm256_set1_epi8(15)));
+    }
+
+    // Stores one record; with `room` the tail store runs up to 10 bytes into
+    // the next record, which overwrites them.
+    __attribute__((target("ssse3")))
+    inline void store_record(char* const buffer, const __m128i head, const __m128i tail, const size_t length, const bool room) noexcept
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), head);
+        if(room)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + 16), tail);
+            return;
+        }
+        alignas(16) char last[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(last), tail);
+        std::memcpy(buffer + 16, last, length - 16u);
+    }
+
+    __attribute__((target("ssse3")))
+    void encode_ssse3(   const text_encoding encoding
+                       , const std::span<const uuid> ids
+                       , char* buffer
+                       , const std::optional<char> delimiter ) noexcept
+    {
+        const size_t length = encoded_length(encoding);
+        for(size_t i = 0; i < std::size(ids); ++i)
+        {
+            const __m128i octets = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&ids[i]));
+            __m128i head;
+            __m128i tail;
+            if(text_encoding::base64url == encoding)
+            {
+                head = base64url_letters(_mm_shuffle_epi8(octets, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10)));
+                tail = base64url_letters(_mm_shuffle_epi8(octets, _mm_setr_epi8(13, 12, 14, 13, -1, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)));
+            }
+            else
+            {
+                const __m128i q0 = base32_quintets(octets, _mm_setr_epi8( 0, -1,  1,  0,  2,  1,  2,  1,  3,  2,  3,  2,  4,  3,  5,  4));
+                const __m128i q1 = base32_quintets(octets, _mm_setr_epi8( 5,  4,  6,  5,  7,  6,  7,  6,  8,  7,  8,  7,  9,  8, 10,  9));
+                const __m128i q2 = base32_quintets(octets, _mm_setr_epi8(10,  9, 11, 10, 12, 11, 12, 11, 13, 12, 13, 12, 14, 13, 15, 14));
+                const __m128i q3 = base32_quintets(octets, _mm_setr_epi8(15, 14, -1, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+                head = base32_letters(_mm_packus_epi16(q0, q1));
+                tail = base32_letters(_mm_packus_epi16(q2, q3));
+            }
+            store_record(buffer, head, tail, length, i + 1u < std::size(ids));
+            buffer += length;
+            if(delimiter) *buffer++ = *delimiter;
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void encode_avx2(   const text_encoding encoding
+                      , const std::span<const uuid> ids
+                      , char* buffer
+                      , const std::optional<char> delimiter ) noexcept
+    {
+        const size_t length = encoded_length(encoding);
+        const size_t stride = encoded_size(encoding, 1u, delimiter.has_value());
+
+        const size_t pairs = std::size(ids) / 2u;
+        const uuid* id = std::data(ids);
+        for(size_t i = 0; i < pairs; ++i, id += 2)
+        {
+            // Lanes never mix: the low lane encodes id[0], the high lane id[1].
+            const __m256i octets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(id));
+            __m256i head;
+            __m256i tail;
+            if(text_encoding::base64url == encoding)
+            {
+                head = base64url_letters(_mm256_shuffle_epi8(octets, _mm256_setr_epi8( 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+                                                                                     , 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10 )));
+                tail = base64url_letters(_mm256_shuffle_epi8(octets, _mm256_setr_epi8( 13, 12, 14, 13, -1, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+                                                                                     , 13, 12, 14, 13, -1, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 )));
+            }
+            else
+            {
+                const __m256i q0 = base32_quintets(octets, _mm256_setr_epi8( 0, -1,  1,  0,  2,  1,  2,  1,  3,  2,  3,  2,  4,  3,  5,  4
+                                                                           , 0, -1,  1,  0,  2,  1,  2,  1,  3,  2,  3,  2,  4,  3,  5,  4 ));
+                const __m256i q1 = base32_quintets(octets, _mm256_setr_epi8( 5,  4,  6,  5,  7,  6,  7,  6,  8,  7,  8,  7,  9,  8, 10,  9
+                                                                           , 5,  4,  6,  5,  7,  6,  7,  6,  8,  7,  8,  7,  9,  8, 10,  9 ));
+                const __m256i q2 = base32_quintets(octets, _mm256_setr_epi8(10,  9, 11, 10, 12, 11, 12, 11, 13, 12, 13, 12, 14, 13, 15, 14
+                                                                           ,10,  9, 11, 10, 12, 11, 12, 11, 13, 12, 13, 12, 14, 13, 15, 14 ));
+                const __m256i q3 = base32_quintets(octets, _mm256_setr_epi8(15, 14, -1, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+                                                                           ,15, 14, -1, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 ));
+                head = base32_letters(_mm256_packus_epi16(q0, q1));
+                tail = base32_letters(_mm256_packus_epi16(q2, q3));
+            }
+            store_record(buffer, _mm256_castsi256_si128(head), _mm256_castsi256_si128(tail), length, true);
+            if(delimiter) buffer[length] = *delimiter;
+            buffer += stride;
+            store_record(buffer, _mm256_extracti128_si256(head, 1), _mm256_extracti128_si256(tail, 1), length, 2u * (i + 1u) < std::size(ids));
+            if(delimiter) buffer[length] = *delimiter;
+            buffer += stride;
+        }
+        encode_ssse3(encoding, ids.subspan(2u * pairs), buffer, delimiter);
+    }
+
+
+    // Decoding maps symbols to their values, rejecting anything outside the
+    // alphabet, and packs them back with multiply-adds: 4 sextets or 8
+    // quintets per lane, whose bytes are then shuffled out big-endian.
+
+    __attribute__((target("ssse3")))
+    inline __m128i in_range(const __m128i values, const char last) noexcept
+    {
+        return _mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(last)), values);
+    }
+
+    __attribute__((target("ssse3")))
+    inline __m128i base64url_sextets(const __m128i symbols, int& valid) noexcept
+    {
+        const __m128i upper = _mm_sub_epi8(symbols, _mm_set1_epi8('A'));
+        const __m128i lower = _mm_sub_epi8(symbols, _mm_set1_epi8('a'));
+        const __m128i digit = _mm_sub_epi8(symbols, _mm_set1_epi8('0'));
+        const __m128i is_upper = in_range(upper, 25);
+        const __m128i is_lower = in_range(lower, 25);
+        const __m128i is_digit = in_range(digit, 9);
+        const __m128i is_dash  = _mm_cmpeq_epi8(symbols, _mm_set1_epi8('-'));
+        const __m128i is_under = _mm_cmpeq_epi8(symbols, _mm_set1_epi8('_'));
+        valid &= _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(is_upper, is_lower), _mm_or_si128(_mm_or_si128(is_digit, is_dash), is_under)));
+        return _mm_or_si128(   _mm_or_si128(   _mm_and_si128(is_upper, upper)
+                                             , _mm_and_si128(is_lower, _mm_add_epi8(lower, _mm_set1_epi8(26))) )
+                             , _mm_or_si128(   _mm_and_si128(is_digit, _mm_add_epi8(digit, _mm_set1_epi8(52)))
+                                             , _mm_or_si128(   _mm_and_si128(is_dash , _mm_set1_epi8(62))
+                                                             , _mm_and_si128(is_under, _mm_set1_epi8(63)) ) ) );
+    }
+
+    // Each 32-bit lane of four sextets becomes the 24-bit group in its low bytes.
+    __attribute__((target("ssse3")))
+    inline __m128i join_sextets(const __m128i sextets) noexcept
+    {
+        return _mm_madd_epi16(_mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+    }
+
+    __attribute__((target("ssse3")))
+    inline __m128i base32_quintets(const __m128i symbols, int& valid) noexcept
+    {
+        const __m128i digit  = _mm_sub_epi8(symbols, _mm_set1_epi8('0'));
+        const __m128i letter = _mm_sub_epi8(_mm_or_si128(symbols, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        const __m128i is_digit  = in_range(digit , 9);
+        const __m128i is_letter = in_range(letter, 25);
+
+        const __m128i first  = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(BASE32_LETTER_VALUES)), letter);
+        const __m128i second = _mm_shuffle_epi8(_mm_setr_epi8(23, 24, 25, 26, -1, 27, 28, 29, 30, 31, -1, -1, -1, -1, -1, -1), letter);
+        const __m128i beyond = _mm_cmpgt_epi8(letter, _mm_set1_epi8(15));
+        const __m128i value  = _mm_or_si128(_mm_and_si128(beyond, second), _mm_andnot_si128(beyond, first));
+        const __m128i known  = _mm_andnot_si128(_mm_cmpeq_epi8(value, _mm_set1_epi8(-1)), is_letter);
+        valid &= _mm_movemask_epi8(_mm_or_si128(is_digit, known));
+        return _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_and_si128(known, value));
+    }
+
+    // Each 64-bit lane of eight quintets becomes the 40-bit group in its low bytes.
+    __attribute__((target("ssse3")))
+    inline __m128i join_quintets(const __m128i quintets) noexcept
+    {
+        const __m128i halves = _mm_madd_epi16(_mm_maddubs_epi16(quintets, _mm_set1_epi16(0x0120)), _mm_set1_epi32(0x00010400));
+        return _mm_or_si128(   _mm_slli_epi64(_mm_and_si128(halves, _mm_set1_epi64x(0xFFFFFFFF)), 20)
+                             , _mm_srli_epi64(halves, 32) );
+    }
+
+    struct base64url_ssse3_kernel
+    {
+        static constexpr bool pairs = false;
+        static constexpr ptrdiff_t length = BASE64URL_LENGTH;
+
+        // Symbols 0..15 make octets 0..11, symbols 16..21 (the end of a load
+        // at 6) make octets 12..15 and a byte that is zero when canonical.
+        __attribute__((target("ssse3")))
+        static bool decode(const char* const text, uuid& id) noexcept
+        {
+            int valid = 0xFFFF;
+            const __m128i head = join_sextets(base64url_sextets(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text    )), valid));
+            const __m128i tail = join_sextets(_mm_shuffle_epi8(   base64url_sextets(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 6)), valid)
+                                                                , _mm_setr_epi8(10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1) ));
+            const int zeros = _mm_movemask_epi8(_mm_cmpeq_epi8(tail, _mm_setzero_si128()));
+            if(0xFFFF != valid || 0 == (zeros & 0x20)) return false;
+
+            const __m128i octets = _mm_or_si128(   _mm_shuffle_epi8(head, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1))
+                                                 , _mm_shuffle_epi8(tail, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 1, 0, 6)) );
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&id), octets);
+            return true;
+        }
+    };
+
+    struct base32_ssse3_kernel
+    {
+        static constexpr bool pairs = false;
+        static constexpr ptrdiff_t length = BASE32_LENGTH;
+
+        // Six zero quintets in front make 32 of them, four 40-bit groups whose
+        // last 16 octets are the id; the first 4 are zero when symbol 0 is
+        // at most 7.
+        __attribute__((target("ssse3")))
+        static bool decode(const char* const text, uuid& id) noexcept
+        {
+            int valid = 0xFFFF;
+            const __m128i head = join_quintets(_mm_slli_si128(base32_quintets(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text     )), valid), 6));
+            const __m128i tail = join_quintets(               base32_quintets(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 10)), valid)    );
+            const int zeros = _mm_movemask_epi8(_mm_cmpeq_epi8(head, _mm_setzero_si128()));
+            if(0xFFFF != valid || 0x1E != (zeros & 0x1E)) return false;
+
+            const __m128i octets = _mm_or_si128(   _mm_shuffle_epi8(head, _mm_setr_epi8( 0, 12, 11, 10,  9,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1))
+                                                 , _mm_shuffle_epi8(tail, _mm_setr_epi8(-1, -1, -1, -1, -1, -1,  4,  3,  2,  1,  0, 12, 11, 10,  9,  8)) );
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&id), octets);
+            return true;
+        }
+    };
+
+#endif // RFC4122_X86_KERNELS
+
+} // namespace
+
+
+namespace rfc4122::__internal
+{
+
+    void encode_n(   const instruction_set kernel
+                   , const text_encoding encoding
+                   , const std::span<const uuid> ids
+                   , char* const buffer
+                   , const std::optional<char> delimiter ) noexcept
+    {
+#ifdef RFC4122_X86_KERNELS
+        switch(kernel)
+        {
+            case instruction_set::avx2 : return encode_avx2 (encoding, ids, buffer, delimiter);
+            case instruction_set::ssse3: return encode_ssse3(encoding, ids, buffer, delimiter);
+            default: break;
+        }
+#endif
+        encode_scalar(encoding, ids, buffer, delimiter);
+    }
+
+    literals_result decode_n(   const instruction_set kernel
+                              , const text_encoding encoding
+                              , const std::string_view text
+                              , const std::span<uuid> ids
+                              , const std::span<uint64_t> validity
+                              , const char delimiter ) noexcept
+    {
+        const bool base64url = text_encoding::base64url == encoding;
+#ifdef RFC4122_X86_KERNELS
+        // Records are short enough that the 16-symbol kernels keep up with the loop.
+        if(instruction_set::scalar != kernel)
+        {
+            return base64url ? parse_records<base64url_ssse3_kernel>(text, ids, validity, delimiter)
+                             : parse_records<base32_ssse3_kernel   >(text, ids, validity, delimiter);
+        }
+#endif
+        return base64url ? parse_records<base64url_scalar_kernel>(text, ids, validity, delimiter)
+                         : parse_records<base32_scalar_kernel   >(text, ids, validity, delimiter);
+    }
+
+} // namespace rfc4122::__internal
@@ -0,0 +1,225 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <bit>
+#include <cstring>
+
+#include <rfc4122/fields.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RFC4122_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+using namespace rfc4122::__internal;
+using namespace rfc4122;
+
+namespace
+{
+
+    // 100ns ticks in a millisecond, for Unix time ids.
+    constexpr int64_t TICKS_PER_MILLISECOND = 10'000;
+
+    uuid_time_point time_of(const uuid& id) noexcept
+    {
+        switch(id.version())
+        {
+            case version::time_based    : return uuid_time_point{gregorian_ticks{static_cast<int64_t>(id.timestamp()) - static_cast<int64_t>(GREGORIAN_TO_UNIX)}};
+            case version::reordered_time: return uuid_time_point{gregorian_ticks{static_cast<int64_t>(id.reordered_timestamp()) - static_cast<int64_t>(GREGORIAN_TO_UNIX)}};
+            case version::unix_time     : return uuid_time_point{gregorian_ticks{static_cast<int64_t>(id.unix_timestamp()) * TICKS_PER_MILLISECOND}};
+            default: return uuid_time_point::min();
+        }
+    }
+
+    void extract_fields_scalar(const std::span<const uuid> ids, const size_t first, const field_columns& columns) noexcept
+    {
+        for(size_t i = first; i < std::size(ids); ++i)
+        {
+            const uuid& id = ids[i];
+            if(!std::empty(columns.times          )) columns.times[i]           = time_of(id);
+            if(!std::empty(columns.clock_sequences)) columns.clock_sequences[i] = id.clock_sequence();
+            if(!std::empty(columns.nodes          )) columns.nodes[i]           = id.node();
+            if(!std::empty(columns.versions       )) columns.versions[i]        = id.version();
+            if(!std::empty(columns.variants       )) columns.variants[i]        = id.variant();
+        }
+    }
+
+    size_t convert_scalar(const std::span<uuid> ids, const size_t first, const version from, const version to) noexcept
+    {
+        size_t converted = 0u;
+        for(size_t i = first; i < std::size(ids); ++i)
+        {
+            uuid& id = ids[i];
+            if(from != id.version()) continue;
+            id = uuid{version::reordered_time == to ? reordered_high(id.high()) : time_based_high(id.high()), id.low()};
+            ++converted;
+        }
+        return converted;
+    }
+
+#ifdef RFC4122_X86_KERNELS
+
+    // One shuffle turns the octets of two ids into their (high, low) words:
+    // each 8-byte half is big-endian, so it is just reversed.
+    __attribute__((target("avx2")))
+    inline __m256i swap_halves(const __m256i octets) noexcept
+    {
+        return _mm256_shuffle_epi8(octets, _mm256_setr_epi8(   7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+                                                             , 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 ));
+    }
+
+    // Low byte of each 64-bit element, packed into 4 bytes.
+    __attribute__((target("avx2")))
+    inline void store_bytes(void* const target, const __m256i values) noexcept
+    {
+        const __m128i packed = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(values, _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0)));
+        const int bytes = _mm_cvtsi128_si32(_mm_shuffle_epi8(packed, _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)));
+        std::memcpy(target, &bytes, sizeof(bytes));
+    }
+
+    // Low 16 bits of each 64-bit element, packed into 8 bytes.
+    __attribute__((target("avx2")))
+    inline void store_shorts(void* const target, const __m256i values) noexcept
+    {
+        const __m128i packed = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(values, _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0)));
+        _mm_storel_epi64(static_cast<__m128i*>(target), _mm_shuffle_epi8(packed, _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1)));
+    }
+
+    // Times of four ids from their high words, as time_of() does.
+    __attribute__((target("avx2")))
+    inline __m256i times_of(const __m256i high, const __m256i versions) noexcept
+    {
+        const __m256i twelve_bits = _mm256_set1_epi64x(0x0FFF);
+        const __m256i epoch       = _mm256_set1_epi64x(static_cast<int64_t>(GREGORIAN_TO_UNIX));
+
+        const __m256i time_based = _mm256_or_si256(   _mm256_slli_epi64(_mm256_and_si256(high, twelve_bits), 48)
+                                                    , _mm256_or_si256(   _mm256_slli_epi64(_mm256_and_si256(_mm256_srli_epi64(high, 16), _mm256_set1_epi64x(0xFFFF)), 32)
+                                                                       , _mm256_srli_epi64(high, 32) ) );
+        const __m256i reordered  = _mm256_or_si256(_mm256_slli_epi64(_mm256_srli_epi64(high, 16), 12), _mm256_and_si256(high, twelve_bits));
+        // Milliseconds are under 2^48, so two 32x32 multiplies make the product.
+        const __m256i milliseconds = _mm256_srli_epi64(high, 16);
+        const __m256i scale        = _mm256_set1_epi64x(TICKS_PER_MILLISECOND);
+        const __m256i unix_time    = _mm256_add_epi64(   _mm256_mul_epu32(milliseconds, scale)
+                                                       , _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(milliseconds, 32), scale), 32) );
+
+        __m256i times = _mm256_set1_epi64x(uuid_time_point::min().time_since_epoch().count());
+        times = _mm256_blendv_epi8(times, _mm256_sub_epi64(time_based, epoch), _mm256_cmpeq_epi64(versions, _mm256_set1_epi64x(static_cast<int64_t>(version::time_based))));
+        times = _mm256_blendv_epi8(times, _mm256_sub_epi64(reordered , epoch), _mm256_cmpeq_epi64(versions, _mm256_set1_epi64x(static_cast<int64_t>(version::reordered_time))));
+        times = _mm256_blendv_epi8(times, unix_time                          , _mm256_cmpeq_epi64(versions, _mm256_set1_epi64x(static_cast<int64_t>(version::unix_time))));
+        return times;
+    }
+
+    // Four ids per round: two shuffles give their high and low words, and
+    // every field is a few shifts and masks of those.
+    __attribute__((target("avx2")))
+    void extract_fields_avx2(const std::span<const uuid> ids, const field_columns& columns) noexcept
+    {
+        static_assert(sizeof(uuid_time_point) == sizeof(int64_t));
+        static_assert(sizeof(rfc4122::version) == 1u && sizeof(rfc4122::variant) == 1u);
+
+        size_t i = 0u;
+        for(; i + 4u <= std::size(ids); i += 4u)
+        {
+            const __m256i first  = swap_halves(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&ids[i     ])));
+            const __m256i second = swap_halves(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&ids[i + 2u])));
+            const __m256i high   = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(first, second), 0xD8);
+            const __m256i low    = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(first, second), 0xD8);
+            const __m256i versions = _mm256_and_si256(_mm256_srli_epi64(high, 12), _mm256_set1_epi64x(0x0F));
+
+            if(!std::empty(columns.times))
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&columns.times[i]), times_of(high, versions));
+            }
+            if(!std::empty(columns.nodes))
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&columns.nodes[i]), _mm256_and_si256(low, _mm256_set1_epi64x(0xFFFFFFFFFFFF)));
+            }
+            if(!std::empty(columns.versions)) store_bytes(&columns.versions[i], versions);
+            if(!std::empty(columns.clock_sequences) || !std::empty(columns.variants))
+            {
+                // Octets 8-9; variant_mask() of octet 8 is 0x80, plus 0x40
+                // if its top bit is set, plus 0x20 if its top two are.
+                const __m256i part4 = _mm256_srli_epi64(low, 48);
+                const __m256i shifted = _mm256_srli_epi64(part4, 9);
+                const __m256i reserved = _mm256_or_si256(   _mm256_set1_epi64x(0x80)
+                                                          , _mm256_or_si256(   _mm256_and_si256(shifted, _mm256_set1_epi64x(0x40))
+                                                                             , _mm256_and_si256(_mm256_and_si256(shifted, _mm256_srli_epi64(part4, 10)), _mm256_set1_epi64x(0x20)) ) );
+                if(!std::empty(columns.variants)) store_bytes(&columns.variants[i], _mm256_and_si256(_mm256_srli_epi64(part4, 8), reserved));
+                if(!std::empty(columns.clock_sequences)) store_shorts(&columns.clock_sequences[i], _mm256_andnot_si256(_mm256_slli_epi64(reserved, 8), part4));
+            }
+        }
+        extract_fields_scalar(ids, i, columns);
+    }
+
+    // Two ids per round, rewritten only where the version matches.
+    __attribute__((target("avx2")))
+    size_t convert_avx2(const std::span<uuid> ids, const version from, const version to) noexcept
+    {
+        const __m256i high_words  = _mm256_setr_epi64x(-1, 0, -1, 0);
+        const __m256i twelve_bits = _mm256_set1_epi64x(0x0FFF);
+        const __m256i wanted      = _mm256_set1_epi64x(static_cast<int64_t>(from));
+
+        size_t converted = 0u;
+        size_t i = 0u;
+        for(; i + 2u <= std::size(ids); i += 2u)
+        {
+            __m256i* const pair = reinterpret_cast<__m256i*>(&ids[i]);
+            const __m256i words = swap_halves(_mm256_loadu_si256(pair));
+            const __m256i matches = _mm256_and_si256(high_words, _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_srli_epi64(words, 12), _mm256_set1_epi64x(0x0F)), wanted));
+            const int mask = _mm256_movemask_pd(_mm256_castsi256_pd(matches));
+            if(0 == mask) continue;
+
+            __m256i rewritten;
+            if(version::reordered_time == to)
+            {
+                // reordered_high()
+                rewritten = _mm256_or_si256(   _mm256_or_si256(   _mm256_slli_epi64(_mm256_and_si256(words, twelve_bits), 52)
+                                                                , _mm256_and_si256(_mm256_slli_epi64(words, 20), _mm256_set1_epi64x(0x000FFFF000000000)) )
+                                             , _mm256_or_si256(   _mm256_and_si256(_mm256_srli_epi64(words, 28), _mm256_set1_epi64x(0x0000000FFFFF0000))
+                                                                , _mm256_or_si256(   _mm256_set1_epi64x(static_cast<int64_t>(version::reordered_time) << 12)
+                                                                                   , _mm256_and_si256(_mm256_srli_epi64(words, 32), twelve_bits) ) ) );
+            }
+            else
+            {
+                // time_based_high()
+                const __m256i timestamp = _mm256_or_si256(_mm256_slli_epi64(_mm256_srli_epi64(words, 16), 12), _mm256_and_si256(words, twelve_bits));
+                rewritten = _mm256_or_si256(   _mm256_or_si256(   _mm256_slli_epi64(timestamp, 32)
+                                                                , _mm256_and_si256(_mm256_srli_epi64(timestamp, 16), _mm256_set1_epi64x(0xFFFF0000)) )
+                                             , _mm256_or_si256(   _mm256_set1_epi64x(static_cast<int64_t>(version::time_based) << 12)
+                                                                , _mm256_and_si256(_mm256_srli_epi64(timestamp, 48), twelve_bits) ) );
+            }
+            _mm256_storeu_si256(pair, swap_halves(_mm256_blendv_epi8(words, rewritten, matches)));
+            converted += static_cast<size_t>(std::popcount(static_cast<unsigned>(mask)));
+        }
+        return converted + convert_scalar(ids, i, from, to);
+    }
+
+#endif // RFC4122_X86_KERNELS
+
+} // namespace
+
+
+namespace rfc4122::__internal
+{
+
+    void extract_fields(const instruction_set kernel, const std::span<const uuid> ids, const field_columns& columns) noexcept
+    {
+#ifdef RFC4122_X86_KERNELS
+        if(instruction_set::avx2 == kernel) return extract_fields_avx2(ids, columns);
+#endif
+        extract_fields_scalar(ids, 0u, columns);
+    }
+
+    size_t convert_time_layout(   const instruction_set kernel
+                                , const std::span<uuid> ids
+                                , const version from
+                                , const version to ) noexcept
+    {
+#ifdef RFC4122_X86_KERNELS
+        if(instruction_set::avx2 == kernel) return convert_avx2(ids, from, to);
+#endif
+        return convert_scalar(ids, 0u, from, to);
+    }
+
+} // namespace rfc4122::__internal
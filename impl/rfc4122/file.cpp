@@ -0,0 +1,449 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <rfc4122/file.h>
+
+using namespace rfc4122;
+
+namespace
+{
+
+    [[noreturn]] void throw_errno(const int error, const std::filesystem::path& path)
+    {
+        throw std::system_error(error, std::generic_category(), path.string());
+    }
+
+    struct descriptor_guard
+    {
+        int descriptor;
+        ~descriptor_guard() {if(descriptor >= 0) ::close(descriptor);}
+    };
+
+    constexpr size_t BUFFER_ALIGNMENT = 4096u;
+
+    // Literal with its quotes and the comma after it, in a JSON array.
+    constexpr size_t JSON_STRIDE = UUID_STRING_LENGTH + 3u;
+
+    // Writes all of `buffers`, returning the calls made and errno or zero.
+    std::pair<uint64_t, int> write_all(const int descriptor, std::span<iovec> buffers) noexcept
+    {
+        uint64_t calls = 0u;
+        while(!std::empty(buffers))
+        {
+            const ssize_t written = ::writev(descriptor, std::data(buffers), static_cast<int>(std::min<size_t>(std::size(buffers), IOV_MAX)));
+            ++calls;
+            if(written < 0)
+            {
+                if(EINTR == errno) continue;
+                return {calls, errno};
+            }
+            for(size_t left = static_cast<size_t>(written); left > 0u; )
+            {
+                iovec& first = buffers.front();
+                const size_t taken = std::min(left, first.iov_len);
+                first.iov_base = static_cast<char*>(first.iov_base) + taken;
+                first.iov_len -= taken;
+                left -= taken;
+                if(0u == first.iov_len) buffers = buffers.subspan(1u);
+            }
+            while(!std::empty(buffers) && 0u == buffers.front().iov_len) buffers = buffers.subspan(1u);
+        }
+        return {calls, 0};
+    }
+
+} // namespace
+
+
+namespace rfc4122
+{
+
+    mapped_file::mapped_file(const std::filesystem::path& path)
+    {
+        const descriptor_guard guard{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+        if(guard.descriptor < 0) throw_errno(errno, path);
+
+        struct stat status{};
+        if(0 != ::fstat(guard.descriptor, &status)) throw_errno(errno, path);
+        if(0 == status.st_size) return;
+
+        const size_t length = static_cast<size_t>(status.st_size);
+        void* const mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, guard.descriptor, 0);
+        if(MAP_FAILED == mapping) throw_errno(errno, path);
+        ::madvise(mapping, length, MADV_WILLNEED);
+
+        address = static_cast<const std::byte*>(mapping);
+        size    = length;
+    }
+
+    mapped_file::mapped_file(mapped_file&& other) noexcept
+        : address{std::exchange(other.address, nullptr)}
+        , size   {std::exchange(other.size, 0u)}
+    {}
+
+    mapped_file& mapped_file::operator = (mapped_file&& other) noexcept
+    {
+        if(this != &other)
+        {
+            this->~mapped_file();
+            address = std::exchange(other.address, nullptr);
+            size    = std::exchange(other.size, 0u);
+        }
+        return *this;
+    }
+
+    mapped_file::~mapped_file()
+    {
+        if(address) ::munmap(const_cast<std::byte*>(address), size);
+    }
+
+
+    binary_reader::binary_reader(const std::filesystem::path& path)
+        : file{path}
+    {
+        if(0u != std::size(file.bytes()) % sizeof(uuid)) throw_errno(EINVAL, path);
+    }
+
+    std::span<const uuid> binary_reader::ids() const noexcept
+    {
+        const auto bytes = file.bytes();
+        return {reinterpret_cast<const uuid*>(std::data(bytes)), std::size(bytes) / sizeof(uuid)};
+    }
+
+
+    text_reader::text_reader(const std::filesystem::path& path, const char delimiter)
+        : file{path}
+        , delimiter{delimiter}
+    {}
+
+    std::string_view text_reader::text() const noexcept
+    {
+        const auto bytes = file.bytes();
+        return {reinterpret_cast<const char*>(std::data(bytes)), std::size(bytes)};
+    }
+
+    literals_result text_reader::read(const std::span<uuid> ids, const std::span<uint64_t> validity) noexcept
+    {
+        const auto result = from_literals(text().substr(offset), ids, validity, delimiter);
+        offset += result.consumed;
+        return result;
+    }
+
+
+    file_writer::file_writer(const std::filesystem::path& path, const size_t chunk_size)
+        : descriptor{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)}
+        , chunk_size{std::max(chunk_size, size_t{4096})}
+        , path{path}
+    {
+        if(descriptor < 0) throw_errno(errno, path);
+        chunk.reset(new char[this->chunk_size]);
+    }
+
+    file_writer::file_writer(file_writer&& other) noexcept
+        : descriptor{std::exchange(other.descriptor, -1)}
+        , chunk     {std::move(other.chunk)}
+        , chunk_size{std::exchange(other.chunk_size, 0u)}
+        , filled    {std::exchange(other.filled, 0u)}
+        , path      {std::move(other.path)}
+    {}
+
+    file_writer::~file_writer()
+    {
+        try
+        {
+            close();
+        }
+        catch(...)
+        {
+        }
+    }
+
+    void file_writer::write(std::span<const std::byte> bytes)
+    {
+        if(filled + std::size(bytes) <= chunk_size)
+        {
+            std::memcpy(chunk.get() + filled, std::data(bytes), std::size(bytes));
+            filled += std::size(bytes);
+            return;
+        }
+        flush();
+        if(std::size(bytes) >= chunk_size)
+        {
+            write_through(bytes);
+            return;
+        }
+        std::memcpy(chunk.get(), std::data(bytes), std::size(bytes));
+        filled = std::size(bytes);
+    }
+
+    void file_writer::flush()
+    {
+        const size_t used = std::exchange(filled, 0u);
+        write_through(std::as_bytes(std::span<const char>{chunk.get(), used}));
+    }
+
+    void file_writer::close()
+    {
+        if(descriptor < 0) return;
+        flush();
+        if(0 != ::close(std::exchange(descriptor, -1))) throw_errno(errno, path);
+    }
+
+    std::span<char> file_writer::reserve(const size_t at_least)
+    {
+        if(chunk_size - filled < at_least) flush();
+        return {chunk.get() + filled, chunk_size - filled};
+    }
+
+    void file_writer::write_through(std::span<const std::byte> bytes)
+    {
+        while(!std::empty(bytes))
+        {
+            const ssize_t written = ::write(descriptor, std::data(bytes), std::size(bytes));
+            if(written < 0)
+            {
+                if(EINTR == errno) continue;
+                throw_errno(errno, path);
+            }
+            bytes = bytes.subspan(static_cast<size_t>(written));
+        }
+    }
+
+
+    text_writer::text_writer(   const std::filesystem::path& path
+                              , const char delimiter
+                              , const size_t chunk_size )
+        : file_writer{path, chunk_size}
+        , delimiter{delimiter}
+    {}
+
+    void text_writer::write(std::span<const uuid> ids)
+    {
+        constexpr size_t stride = literals_size(1u, true);
+        while(!std::empty(ids))
+        {
+            const auto space   = reserve(stride);
+            const auto written = to_literals(ids, space, delimiter);
+            commit(written);
+            ids = ids.subspan(written / stride);
+        }
+    }
+
+
+
+    void async_text_writer::aligned_delete::operator () (char* const buffer) const noexcept
+    {
+        ::operator delete(buffer, std::align_val_t{BUFFER_ALIGNMENT});
+    }
+
+    async_text_writer::async_text_writer(const int descriptor, const async_writer_options& options)
+        : settings{   options.layout
+                    , (std::max(options.buffer_size, BUFFER_ALIGNMENT) + BUFFER_ALIGNMENT - 1u) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT
+                    , std::max(options.buffers, size_t{2}) }
+        , descriptor{descriptor}
+    {
+        for(size_t i = 0; i < settings.buffers; ++i)
+        {
+            buffers.emplace_back(static_cast<char*>(::operator new(settings.buffer_size, std::align_val_t{BUFFER_ALIGNMENT})));
+            if(i > 0u) free_buffers.push_back(i);
+        }
+        if(text_layout::json_array == settings.layout) append("[");
+        writer = std::thread{&async_text_writer::write_loop, this};
+    }
+
+    async_text_writer::~async_text_writer()
+    {
+        try
+        {
+            finish();
+        }
+        catch(...)
+        {
+        }
+        {
+            const std::lock_guard guard{lock};
+            stopping = true;
+        }
+        changed.notify_all();
+        writer.join();
+    }
+
+    void async_text_writer::write(std::span<const uuid> ids)
+    {
+        if(finished) throw std::logic_error("async_text_writer: write after finish");
+        const auto start = std::chrono::steady_clock::now();
+        const size_t count = std::size(ids);
+        while(!std::empty(ids))
+        {
+            size_t bytes = 0u;
+            const size_t formatted = format(ids, buffers[current].get() + used, settings.buffer_size - used, bytes);
+            if(0u == formatted)
+            {
+                submit();
+                continue;
+            }
+            used += bytes;
+            ids = ids.subspan(formatted);
+        }
+
+        const std::lock_guard guard{lock};
+        ids_count += count;
+        formatting_time += std::chrono::steady_clock::now() - start;
+        check();
+    }
+
+    // Fits as many records as `room` holds: each is followed by its
+    // separator, which a record of a later call writes in front of itself
+    // instead, so the last one is not committed.
+    size_t async_text_writer::format(const std::span<const uuid> ids, char* const out, const size_t room, size_t& bytes) noexcept
+    {
+        constexpr size_t stride = literals_size(1u, true);
+        const size_t lead = started && text_layout::lines != settings.layout ? 1u : 0u;
+        const size_t record = text_layout::json_array == settings.layout ? JSON_STRIDE : stride;
+        const size_t count = room > lead ? std::min(std::size(ids), (room - lead) / record) : 0u;
+        if(0u == count) return 0u;
+
+        char* const first = out + lead;
+        if(lead) *out = ',';
+        switch(settings.layout)
+        {
+            case text_layout::lines:
+                bytes = to_literals(ids.first(count), std::span<char>{first, count * stride}, '\n');
+                break;
+            case text_layout::csv:
+                bytes = lead + to_literals(ids.first(count), std::span<char>{first, count * stride}, ',') - 1u;
+                break;
+            case text_layout::json_array:
+            {
+                // Formatted as `literal"` at the end of the room, then moved
+                // forward into `"literal",`; no record overtakes its source.
+                char* const source = first + count * (JSON_STRIDE - stride);
+                to_literals(ids.first(count), std::span<char>{source, count * stride}, '"');
+                for(size_t i = 0; i < count; ++i)
+                {
+                    char* const target = first + i * JSON_STRIDE;
+                    target[0] = '"';
+                    std::memmove(target + 1, source + i * stride, stride);
+                    target[JSON_STRIDE - 1u] = ',';
+                }
+                bytes = lead + count * JSON_STRIDE - 1u;
+                break;
+            }
+        }
+        started = true;
+        return count;
+    }
+
+    void async_text_writer::append(const std::string_view text)
+    {
+        if(settings.buffer_size - used < std::size(text)) submit();
+        std::memcpy(buffers[current].get() + used, std::data(text), std::size(text));
+        used += std::size(text);
+    }
+
+    // Queues the current buffer, if anything is in it, and takes a free one.
+    void async_text_writer::submit()
+    {
+        std::unique_lock guard{lock};
+        if(0u == used) return;
+        full_buffers.emplace_back(current, used);
+        changed.notify_all();
+        if(std::empty(free_buffers))
+        {
+            ++stalls_count;
+            changed.wait(guard, [this] {return !std::empty(free_buffers);});
+        }
+        current = free_buffers.back();
+        free_buffers.pop_back();
+        used = 0u;
+        check();
+    }
+
+    void async_text_writer::flush()
+    {
+        submit();
+        std::unique_lock guard{lock};
+        changed.wait(guard, [this] {return std::empty(full_buffers) && 0u == in_flight;});
+        check();
+    }
+
+    void async_text_writer::finish()
+    {
+        if(finished) return;
+        finished = true;
+        switch(settings.layout)
+        {
+            case text_layout::lines     : break;
+            case text_layout::csv       : if(started) append("\n"); break;
+            case text_layout::json_array: append("]\n"); break;
+        }
+        flush();
+    }
+
+    void async_text_writer::check() const
+    {
+        if(0 != error) throw std::system_error(error, std::generic_category(), "async_text_writer");
+    }
+
+    async_writer_metrics async_text_writer::metrics() const noexcept
+    {
+        const std::lock_guard guard{lock};
+        return {ids_count, bytes_count, writes_count, stalls_count, formatting_time, writing_time};
+    }
+
+    // Takes every full buffer at once and writes them with one writev. After
+    // a failure the rest is dropped, as the caller is told anyway.
+    void async_text_writer::write_loop()
+    {
+        std::vector<iovec> pending;
+        std::vector<size_t> taken;
+        std::unique_lock guard{lock};
+        for(;;)
+        {
+            changed.wait(guard, [this] {return stopping || !std::empty(full_buffers);});
+            if(std::empty(full_buffers)) return;
+
+            pending.clear();
+            taken.clear();
+            size_t bytes = 0u;
+            for(const auto& [buffer, size]: full_buffers)
+            {
+                pending.push_back({buffers[buffer].get(), size});
+                taken.push_back(buffer);
+                bytes += size;
+            }
+            full_buffers.clear();
+            in_flight = std::size(taken);
+            const bool failed = 0 != error;
+            guard.unlock();
+
+            const auto start = std::chrono::steady_clock::now();
+            const auto [calls, failure] = failed ? std::pair<uint64_t, int>{0u, 0} : write_all(descriptor, pending);
+            const auto spent = std::chrono::steady_clock::now() - start;
+
+            guard.lock();
+            if(0 == error) error = failure;
+            if(0 == failure && !failed) bytes_count += bytes;
+            writes_count += calls;
+            writing_time += spent;
+            free_buffers.insert(std::end(free_buffers), std::begin(taken), std::end(taken));
+            in_flight = 0u;
+            changed.notify_all();
+        }
+    }
+
+} // namespace rfc4122
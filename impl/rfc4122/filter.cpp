@@ -0,0 +1,632 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include <rfc4122/batch.h>
+#include <rfc4122/filter.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RFC4122_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+using namespace rfc4122::__internal;
+using namespace rfc4122;
+
+namespace
+{
+
+    // Image layout: this header in the first cache line, then the Bloom
+    // blocks or the cuckoo buckets, in host byte order.
+    constexpr char BLOOM_MAGIC[8]  = {'U', 'U', 'I', 'D', 'B', 'L', 'M', '1'};
+    constexpr char CUCKOO_MAGIC[8] = {'U', 'U', 'I', 'D', 'C', 'K', 'O', '1'};
+
+    struct header
+    {
+        char magic[8];
+        uint64_t size;  // blocks, or log2 of the buckets
+        uint64_t count;
+        uint8_t keys;
+        uint8_t has_victim;
+        uint16_t victim_fingerprint;
+        uint32_t reserved;
+        uint64_t victim_bucket;
+        uint64_t padding[3];
+    };
+
+    static_assert(sizeof(header) == sizeof(cache_line));
+
+    // Ids tested together: their lines are all prefetched before the first
+    // one is looked at, so the misses overlap.
+    constexpr size_t WINDOW = 16u;
+
+    bool read_header(const std::span<const std::byte> bytes, const char (&magic)[8], header& head) noexcept
+    {
+        if(std::size(bytes) < sizeof(header)) return false;
+        std::memcpy(&head, std::data(bytes), sizeof(header));
+        return 0 == std::memcmp(head.magic, magic, sizeof(magic)) && head.keys <= static_cast<uint8_t>(filter_keys::any);
+    }
+
+    void write_image(   const std::filesystem::path& path
+                      , const header& head
+                      , const std::span<const std::byte> body )
+    {
+        file_writer writer{path};
+        writer.write(std::as_bytes(std::span{&head, 1u}));
+        writer.write(body);
+        writer.close();
+    }
+
+    void set_found(const std::span<uint64_t> found, const size_t index, const bool maybe) noexcept
+    {
+        found[index / 64u] |= static_cast<uint64_t>(maybe) << (index % 64u);
+    }
+
+    // Bloom filter.
+
+    // Share of absent ids a filter with `load` ids per block lets through.
+    // Ids spread over blocks by Poisson; in a block of j ids a given bit of
+    // a word is set with probability 1 - (31/32)^j, and all 8 must be.
+    double bloom_false_positive_rate(const double load) noexcept
+    {
+        double rate    = 0.0;
+        double poisson = std::exp(-load);
+        double clear   = 1.0;
+        const size_t terms = static_cast<size_t>(load + 12.0 * std::sqrt(load)) + 32u;
+        for(size_t j = 0; j < terms; ++j)
+        {
+            rate    += poisson * std::pow(1.0 - clear, 8);
+            poisson *= load / static_cast<double>(j + 1u);
+            clear   *= 31.0 / 32.0;
+        }
+        return rate;
+    }
+
+    size_t bloom_blocks(const size_t capacity, const double false_positive_rate) noexcept
+    {
+        const double target = std::clamp(false_positive_rate, 1e-12, 0.5);
+        double low  = 1e-3;
+        double high = 512.0;
+        for(int i = 0; i < 64; ++i)
+        {
+            const double middle = (low + high) / 2.0;
+            if(bloom_false_positive_rate(middle) <= target) low  = middle;
+            else                                            high = middle;
+        }
+        return std::max<size_t>(1u, static_cast<size_t>(std::ceil(static_cast<double>(capacity) / low)));
+    }
+
+    // The bit an id sets in `word` of its block, from 5 bits of the probe.
+    uint32_t bloom_bit(const uint64_t probe, const size_t word) noexcept
+    {
+        return uint32_t{1} << ((probe >> (5u * word)) & 31u);
+    }
+
+    struct bloom_view
+    {
+        const uint32_t* words;
+        size_t blocks;
+        filter_keys keys;
+    };
+
+    const uint32_t* bloom_block(const bloom_view& filter, const uint64_t index) noexcept
+    {
+        return filter.words + 8u * scale(index, filter.blocks);
+    }
+
+    struct bloom_scalar
+    {
+        static bool test(const uint32_t* const block, const uint64_t probe) noexcept
+        {
+            uint32_t missing = 0u;
+            for(size_t word = 0; word < 8u; ++word) missing |= bloom_bit(probe, word) & ~block[word];
+            return 0u == missing;
+        }
+    };
+
+    template<typename K>
+    [[gnu::always_inline]] inline size_t bloom_may_contain(   const bloom_view& filter
+                                                            , const std::span<const uuid> ids
+                                                            , const std::span<uint64_t> found ) noexcept
+    {
+        size_t count = 0u;
+        for(size_t first = 0; first < std::size(ids); first += WINDOW)
+        {
+            const size_t width = std::min(WINDOW, std::size(ids) - first);
+            const uint32_t* blocks[WINDOW];
+            uint64_t probes[WINDOW];
+            for(size_t i = 0; i < width; ++i)
+            {
+                const filter_key key = make_filter_key(ids[first + i], filter.keys);
+                blocks[i] = bloom_block(filter, key.index);
+                probes[i] = key.probe;
+                __builtin_prefetch(blocks[i]);
+            }
+            for(size_t i = 0; i < width; ++i)
+            {
+                const bool maybe = K::test(blocks[i], probes[i]);
+                set_found(found, first + i, maybe);
+                count += maybe;
+            }
+        }
+        return count;
+    }
+
+    // Cuckoo filter.
+
+    constexpr size_t MAX_KICKS = 500u;
+    constexpr uint64_t LANES = 0x0001000100010001u;
+
+    uint16_t fingerprint(const uint64_t probe) noexcept
+    {
+        const auto bits = static_cast<uint16_t>(probe >> 40);
+        return 0u == bits ? uint16_t{1} : bits;  // zero marks a free slot
+    }
+
+    uint64_t home_bucket(const uint64_t index, const size_t buckets_log2) noexcept
+    {
+        return index >> (64u - buckets_log2);
+    }
+
+    // Its own inverse, so either bucket of an id leads to the other one.
+    uint64_t other_bucket(const uint64_t bucket, const uint16_t print, const size_t buckets_log2) noexcept
+    {
+        return bucket ^ ((print * 0xc6a4a7935bd1e995u) >> (64u - buckets_log2));
+    }
+
+    uint16_t slot(const uint64_t bucket, const size_t index) noexcept
+    {
+        return static_cast<uint16_t>(bucket >> (16u * index));
+    }
+
+    void set_slot(uint64_t& bucket, const size_t index, const uint16_t print) noexcept
+    {
+        bucket = (bucket & ~(uint64_t{0xFFFF} << (16u * index))) | (uint64_t{print} << (16u * index));
+    }
+
+    // Nonzero when some slot of `bucket` holds `print`.
+    uint64_t bucket_holds(const uint64_t bucket, const uint16_t print) noexcept
+    {
+        const uint64_t x = bucket ^ (LANES * print);
+        return (x - LANES) & ~x & (LANES << 15);
+    }
+
+    bool place(uint64_t& bucket, const uint16_t print) noexcept
+    {
+        for(size_t index = 0; index < cuckoo_filter::BUCKET_SIZE; ++index)
+        {
+            if(0u != slot(bucket, index)) continue;
+            set_slot(bucket, index, print);
+            return true;
+        }
+        return false;
+    }
+
+    bool remove(uint64_t& bucket, const uint16_t print) noexcept
+    {
+        for(size_t index = 0; index < cuckoo_filter::BUCKET_SIZE; ++index)
+        {
+            if(print != slot(bucket, index)) continue;
+            set_slot(bucket, index, 0u);
+            return true;
+        }
+        return false;
+    }
+
+    struct cuckoo_view
+    {
+        const uint64_t* slots;
+        size_t buckets_log2;
+        filter_keys keys;
+        bool has_victim;
+        uint16_t victim_fingerprint;
+        uint64_t victim_bucket;
+
+        bool victim_is(const uint16_t print, const uint64_t first, const uint64_t second) const noexcept
+        {
+            return has_victim && victim_fingerprint == print && (victim_bucket == first || victim_bucket == second);
+        }
+    };
+
+    struct cuckoo_probe
+    {
+        uint64_t first;
+        uint64_t second;
+        uint16_t print;
+    };
+
+    cuckoo_probe cuckoo_locate(const cuckoo_view& filter, const uuid& id) noexcept
+    {
+        const filter_key key = make_filter_key(id, filter.keys);
+        const uint16_t print  = fingerprint(key.probe);
+        const uint64_t first  = home_bucket(key.index, filter.buckets_log2);
+        return {first, other_bucket(first, print, filter.buckets_log2), print};
+    }
+
+    struct cuckoo_scalar
+    {
+        // Bit i set when id i of the pair may be present.
+        static uint32_t test_pair(const cuckoo_view& filter, const cuckoo_probe& left, const cuckoo_probe& right) noexcept
+        {
+            const uint64_t* const slots = filter.slots;
+            const bool in_left  = 0u != (  bucket_holds(slots[left.first ], left.print)
+                                         | bucket_holds(slots[left.second], left.print) );
+            const bool in_right = 0u != (  bucket_holds(slots[right.first ], right.print)
+                                         | bucket_holds(slots[right.second], right.print) );
+            return static_cast<uint32_t>(in_left) | (static_cast<uint32_t>(in_right) << 1);
+        }
+    };
+
+    template<typename K>
+    [[gnu::always_inline]] inline size_t cuckoo_may_contain(   const cuckoo_view& filter
+                                                             , const std::span<const uuid> ids
+                                                             , const std::span<uint64_t> found ) noexcept
+    {
+        size_t count = 0u;
+        for(size_t first = 0; first < std::size(ids); first += WINDOW)
+        {
+            const size_t width = std::min(WINDOW, std::size(ids) - first);
+            cuckoo_probe probes[WINDOW + 1u];
+            for(size_t i = 0; i < width; ++i)
+            {
+                probes[i] = cuckoo_locate(filter, ids[first + i]);
+                __builtin_prefetch(filter.slots + probes[i].first);
+                __builtin_prefetch(filter.slots + probes[i].second);
+            }
+            probes[width] = probes[0];
+            for(size_t i = 0; i < width; i += 2u)
+            {
+                const uint32_t pair = K::test_pair(filter, probes[i], probes[i + 1u]);
+                for(size_t j = i; j < std::min(width, i + 2u); ++j)
+                {
+                    const cuckoo_probe& probe = probes[j];
+                    const bool maybe = 0u != (pair & (1u << (j - i))) || filter.victim_is(probe.print, probe.first, probe.second);
+                    set_found(found, first + j, maybe);
+                    count += maybe;
+                }
+            }
+        }
+        return count;
+    }
+
+#ifdef RFC4122_X86_KERNELS
+
+    struct bloom_avx2
+    {
+        // The eight bits of the probe as one 256-bit mask: words 0..5 take
+        // 5 bits each from the low 30 bits, words 6 and 7 from the next 10.
+        __attribute__((target("avx2")))
+        static bool test(const uint32_t* const block, const uint64_t probe) noexcept
+        {
+            const auto low  = static_cast<int>(static_cast<uint32_t>(probe));
+            const auto high = static_cast<int>(static_cast<uint32_t>(probe >> 30));
+            const __m256i values    = _mm256_setr_epi32(low, low, low, low, low, low, high, high);
+            const __m256i shifts    = _mm256_setr_epi32(0, 5, 10, 15, 20, 25, 0, 5);
+            const __m256i positions = _mm256_and_si256(_mm256_srlv_epi32(values, shifts), _mm256_set1_epi32(31));
+            const __m256i mask      = _mm256_sllv_epi32(_mm256_set1_epi32(1), positions);
+            return 0 != _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(block)), mask);
+        }
+    };
+
+    __attribute__((target("avx2")))
+    size_t bloom_may_contain_avx2(   const bloom_view& filter
+                                   , const std::span<const uuid> ids
+                                   , const std::span<uint64_t> found ) noexcept
+    {
+        return bloom_may_contain<bloom_avx2>(filter, ids, found);
+    }
+
+    struct cuckoo_avx2
+    {
+        // The four candidate buckets of two ids compared in one go, each
+        // against its own id's fingerprint.
+        __attribute__((target("avx2")))
+        static uint32_t test_pair(const cuckoo_view& filter, const cuckoo_probe& left, const cuckoo_probe& right) noexcept
+        {
+            const uint64_t* const slots = filter.slots;
+            const __m256i buckets = _mm256_setr_epi64x(   static_cast<long long>(slots[left.first  ])
+                                                        , static_cast<long long>(slots[left.second ])
+                                                        , static_cast<long long>(slots[right.first ])
+                                                        , static_cast<long long>(slots[right.second]) );
+            const __m256i prints  = _mm256_setr_m128i(   _mm_set1_epi16(static_cast<short>(left.print))
+                                                       , _mm_set1_epi16(static_cast<short>(right.print)) );
+            const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(buckets, prints)));
+            return static_cast<uint32_t>(0u != (mask & 0xFFFFu)) | (static_cast<uint32_t>(0u != (mask >> 16)) << 1);
+        }
+    };
+
+    __attribute__((target("avx2")))
+    size_t cuckoo_may_contain_avx2(   const cuckoo_view& filter
+                                    , const std::span<const uuid> ids
+                                    , const std::span<uint64_t> found ) noexcept
+    {
+        return cuckoo_may_contain<cuckoo_avx2>(filter, ids, found);
+    }
+
+#endif // RFC4122_X86_KERNELS
+
+} // namespace
+
+namespace rfc4122::__internal
+{
+
+    size_t may_contain_n(   const instruction_set kernel
+                          , const blocked_bloom_filter& filter
+                          , const std::span<const uuid> ids
+                          , const std::span<uint64_t> found ) noexcept
+    {
+        std::fill_n(std::begin(found), validity_size(std::size(ids)), uint64_t{0});
+        if(nullptr == filter.words) return 0u;
+
+        const bloom_view view{filter.words, filter.blocks_count, filter.key_source};
+#ifdef RFC4122_X86_KERNELS
+        if(instruction_set::avx2 == kernel) return bloom_may_contain_avx2(view, ids, found);
+#endif
+        (void)kernel;
+        return bloom_may_contain<bloom_scalar>(view, ids, found);
+    }
+
+    size_t may_contain_n(   const instruction_set kernel
+                          , const cuckoo_filter& filter
+                          , const std::span<const uuid> ids
+                          , const std::span<uint64_t> found ) noexcept
+    {
+        std::fill_n(std::begin(found), validity_size(std::size(ids)), uint64_t{0});
+        if(nullptr == filter.slots) return 0u;
+
+        const cuckoo_view view{   filter.slots
+                                , filter.buckets_log2
+                                , filter.key_source
+                                , filter.has_victim
+                                , filter.victim_fingerprint
+                                , filter.victim_bucket };
+#ifdef RFC4122_X86_KERNELS
+        if(instruction_set::avx2 == kernel) return cuckoo_may_contain_avx2(view, ids, found);
+#endif
+        (void)kernel;
+        return cuckoo_may_contain<cuckoo_scalar>(view, ids, found);
+    }
+
+} // namespace rfc4122::__internal
+
+namespace rfc4122
+{
+
+    blocked_bloom_filter::blocked_bloom_filter(   const size_t capacity
+                                                , const double false_positive_rate
+                                                , const filter_keys keys )
+        : blocks_count{bloom_blocks(capacity, false_positive_rate)}
+        , key_source{keys}
+    {
+        owned.resize(1u + (blocks_count * BLOCK_SIZE + sizeof(cache_line) - 1u) / sizeof(cache_line));
+        writable = reinterpret_cast<uint32_t*>(std::data(owned) + 1);
+        words    = writable;
+    }
+
+    blocked_bloom_filter::blocked_bloom_filter(const std::filesystem::path& path)
+        : file{path}
+    {
+        if(!attach(file.bytes())) throw std::system_error(EINVAL, std::generic_category(), path.string());
+    }
+
+    blocked_bloom_filter::blocked_bloom_filter(blocked_bloom_filter&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    blocked_bloom_filter& blocked_bloom_filter::operator = (blocked_bloom_filter&& other) noexcept
+    {
+        if(this != &other)
+        {
+            // Heap buffers and mappings keep their addresses when moved.
+            owned        = std::move(other.owned);
+            file         = std::move(other.file);
+            words        = std::exchange(other.words, nullptr);
+            writable     = std::exchange(other.writable, nullptr);
+            blocks_count = std::exchange(other.blocks_count, 0u);
+            inserted     = std::exchange(other.inserted, 0u);
+            key_source   = other.key_source;
+        }
+        return *this;
+    }
+
+    bool blocked_bloom_filter::attach(const std::span<const std::byte> bytes) noexcept
+    {
+        header head{};
+        if(!read_header(bytes, BLOOM_MAGIC, head)) return false;
+        if(0u == head.size || head.size > std::size(bytes) / BLOCK_SIZE) return false;
+        if(std::size(bytes) != sizeof(header) + head.size * BLOCK_SIZE) return false;
+
+        words        = reinterpret_cast<const uint32_t*>(std::data(bytes) + sizeof(header));
+        blocks_count = head.size;
+        inserted     = head.count;
+        key_source   = static_cast<filter_keys>(head.keys);
+        return true;
+    }
+
+    bool blocked_bloom_filter::insert(const uuid& id) noexcept
+    {
+        if(nullptr == writable) return false;
+        const filter_key key = make_filter_key(id, key_source);
+        uint32_t* const block = writable + 8u * scale(key.index, blocks_count);
+        for(size_t word = 0; word < 8u; ++word) block[word] |= bloom_bit(key.probe, word);
+        ++inserted;
+        return true;
+    }
+
+    bool blocked_bloom_filter::insert(const std::span<const uuid> ids) noexcept
+    {
+        if(nullptr == writable) return false;
+        for(const uuid& id: ids) insert(id);
+        return true;
+    }
+
+    bool blocked_bloom_filter::may_contain(const uuid& id) const noexcept
+    {
+        if(nullptr == words) return false;
+        const filter_key key = make_filter_key(id, key_source);
+        return bloom_scalar::test(bloom_block({words, blocks_count, key_source}, key.index), key.probe);
+    }
+
+    void blocked_bloom_filter::save(const std::filesystem::path& path) const
+    {
+        header head{};
+        std::memcpy(head.magic, BLOOM_MAGIC, sizeof(BLOOM_MAGIC));
+        head.size  = blocks_count;
+        head.count = inserted;
+        head.keys  = static_cast<uint8_t>(key_source);
+        write_image(path, head, std::as_bytes(std::span{words, 8u * blocks_count}));
+    }
+
+    cuckoo_filter::cuckoo_filter(const size_t capacity, const filter_keys keys)
+        : key_source{keys}
+    {
+        // Cuckoo tables fill to about 95% before inserts start failing.
+        const size_t wanted = static_cast<size_t>(std::ceil(static_cast<double>(capacity) / (0.95 * BUCKET_SIZE)));
+        buckets_log2 = static_cast<size_t>(std::countr_zero(std::bit_ceil(std::max<size_t>(2u, wanted))));
+        owned.resize(1u + (buckets() * sizeof(uint64_t) + sizeof(cache_line) - 1u) / sizeof(cache_line));
+        writable = reinterpret_cast<uint64_t*>(std::data(owned) + 1);
+        slots    = writable;
+    }
+
+    cuckoo_filter::cuckoo_filter(const std::filesystem::path& path)
+        : file{path}
+    {
+        if(!attach(file.bytes())) throw std::system_error(EINVAL, std::generic_category(), path.string());
+    }
+
+    cuckoo_filter::cuckoo_filter(cuckoo_filter&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    cuckoo_filter& cuckoo_filter::operator = (cuckoo_filter&& other) noexcept
+    {
+        if(this != &other)
+        {
+            owned              = std::move(other.owned);
+            file               = std::move(other.file);
+            slots              = std::exchange(other.slots, nullptr);
+            writable           = std::exchange(other.writable, nullptr);
+            buckets_log2       = std::exchange(other.buckets_log2, 0u);
+            stored             = std::exchange(other.stored, 0u);
+            key_source         = other.key_source;
+            has_victim         = std::exchange(other.has_victim, false);
+            victim_fingerprint = other.victim_fingerprint;
+            victim_bucket      = other.victim_bucket;
+            kick_state         = other.kick_state;
+        }
+        return *this;
+    }
+
+    bool cuckoo_filter::attach(const std::span<const std::byte> bytes) noexcept
+    {
+        header head{};
+        if(!read_header(bytes, CUCKOO_MAGIC, head)) return false;
+        if(head.size < 1u || head.size > 58u) return false;
+        if(std::size(bytes) != sizeof(header) + (uint64_t{1} << head.size) * sizeof(uint64_t)) return false;
+        if(head.has_victim > 1u || head.victim_bucket >> head.size) return false;
+
+        slots              = reinterpret_cast<const uint64_t*>(std::data(bytes) + sizeof(header));
+        buckets_log2       = head.size;
+        stored             = head.count;
+        key_source         = static_cast<filter_keys>(head.keys);
+        has_victim         = 1u == head.has_victim;
+        victim_fingerprint = head.victim_fingerprint;
+        victim_bucket      = head.victim_bucket;
+        return true;
+    }
+
+    bool cuckoo_filter::insert(const uuid& id) noexcept
+    {
+        if(nullptr == writable || has_victim) return false;
+        const filter_key key = make_filter_key(id, key_source);
+        ++stored;
+        settle(home_bucket(key.index, buckets_log2), fingerprint(key.probe));
+        return true;
+    }
+
+    void cuckoo_filter::settle(uint64_t bucket, uint16_t print) noexcept
+    {
+        if(place(writable[bucket], print)) return;
+        bucket = other_bucket(bucket, print, buckets_log2);
+        if(place(writable[bucket], print)) return;
+
+        // Evict a random resident to its other bucket until one fits.
+        for(size_t kick = 0; kick < MAX_KICKS; ++kick)
+        {
+            kick_state ^= kick_state << 13;
+            kick_state ^= kick_state >> 7;
+            kick_state ^= kick_state << 17;
+            const size_t index = kick_state % BUCKET_SIZE;
+            const uint16_t evicted = slot(writable[bucket], index);
+            set_slot(writable[bucket], index, print);
+            print  = evicted;
+            bucket = other_bucket(bucket, print, buckets_log2);
+            if(place(writable[bucket], print)) return;
+        }
+        has_victim         = true;
+        victim_fingerprint = print;
+        victim_bucket      = bucket;
+    }
+
+    bool cuckoo_filter::erase(const uuid& id) noexcept
+    {
+        if(nullptr == writable) return false;
+        const filter_key key = make_filter_key(id, key_source);
+        const uint16_t print  = fingerprint(key.probe);
+        const uint64_t first  = home_bucket(key.index, buckets_log2);
+        const uint64_t second = other_bucket(first, print, buckets_log2);
+        if(has_victim && victim_fingerprint == print && (victim_bucket == first || victim_bucket == second))
+        {
+            has_victim = false;
+        }
+        else if(remove(writable[first], print) || remove(writable[second], print))
+        {
+            // The freed slot may make room for the victim.
+            if(has_victim)
+            {
+                has_victim = false;
+                settle(victim_bucket, victim_fingerprint);
+            }
+        }
+        else
+        {
+            return false;
+        }
+        --stored;
+        return true;
+    }
+
+    bool cuckoo_filter::may_contain(const uuid& id) const noexcept
+    {
+        if(nullptr == slots) return false;
+        const filter_key key = make_filter_key(id, key_source);
+        const uint16_t print  = fingerprint(key.probe);
+        const uint64_t first  = home_bucket(key.index, buckets_log2);
+        const uint64_t second = other_bucket(first, print, buckets_log2);
+        return    0u != (bucket_holds(slots[first], print) | bucket_holds(slots[second], print))
+               || (has_victim && victim_fingerprint == print && (victim_bucket == first || victim_bucket == second));
+    }
+
+    void cuckoo_filter::save(const std::filesystem::path& path) const
+    {
+        header head{};
+        std::memcpy(head.magic, CUCKOO_MAGIC, sizeof(CUCKOO_MAGIC));
+        head.size               = buckets_log2;
+        head.count              = stored;
+        head.keys               = static_cast<uint8_t>(key_source);
+        head.has_victim         = has_victim ? 1u : 0u;
+        head.victim_fingerprint = victim_fingerprint;
+        head.victim_bucket      = victim_bucket;
+        write_image(path, head, std::as_bytes(std::span{slots, buckets()}));
+    }
+
+} // namespace rfc4122
@@ -0,0 +1,319 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <rfc4122/hash.h>
+
+using namespace rfc4122::__internal;
+
+namespace
+{
+
+    // Lanes are GCC vector extension types, so one definition of each
+    // compression function serves the scalar kernel (a single uint32_t), the
+    // 4-lane kernel (SSE2 registers) and the 8-lane kernel (AVX2 registers,
+    // once inlined into a function compiled for AVX2).
+    // The helpers below are always inlined, so x8 never crosses a call
+    // boundary compiled without AVX.
+#pragma GCC diagnostic ignored "-Wpsabi"
+    typedef uint32_t x4 __attribute__((vector_size(16)));
+    typedef uint32_t x8 __attribute__((vector_size(32)));
+
+    template<typename V>
+    constexpr size_t LANES = sizeof(V) / sizeof(uint32_t);
+
+    template<typename V>
+    [[gnu::always_inline]] inline uint32_t& lane(V& vector, const size_t index) noexcept
+    {
+        if constexpr (1u == LANES<V>)
+        {
+            static_cast<void>(index);
+            return vector;
+        }
+        else
+        {
+            return reinterpret_cast<uint32_t*>(&vector)[index];
+        }
+    }
+
+    template<unsigned S, typename V>
+    [[gnu::always_inline]] inline V rotl(const V x) noexcept
+    {
+        return (x << S) | (x >> (32u - S));
+    }
+
+    struct md5
+    {
+        static constexpr size_t WORDS = 4u;
+        static constexpr bool   BIG_ENDIAN_WORDS = false;
+        static constexpr uint32_t IV[WORDS] = {0x67452301u, 0xefcdab89u, 0x98badcfeu, 0x10325476u};
+
+        static constexpr uint32_t K[64] =
+        {
+              0xd76aa478u, 0xe8c7b756u, 0x242070dbu, 0xc1bdceeeu, 0xf57c0fafu, 0x4787c62au, 0xa8304613u, 0xfd469501u
+            , 0x698098d8u, 0x8b44f7afu, 0xffff5bb1u, 0x895cd7beu, 0x6b901122u, 0xfd987193u, 0xa679438eu, 0x49b40821u
+            , 0xf61e2562u, 0xc040b340u, 0x265e5a51u, 0xe9b6c7aau, 0xd62f105du, 0x02441453u, 0xd8a1e681u, 0xe7d3fbc8u
+            , 0x21e1cde6u, 0xc33707d6u, 0xf4d50d87u, 0x455a14edu, 0xa9e3e905u, 0xfcefa3f8u, 0x676f02d9u, 0x8d2a4c8au
+            , 0xfffa3942u, 0x8771f681u, 0x6d9d6122u, 0xfde5380cu, 0xa4beea44u, 0x4bdecfa9u, 0xf6bb4b60u, 0xbebfbc70u
+            , 0x289b7ec6u, 0xeaa127fau, 0xd4ef3085u, 0x04881d05u, 0xd9d4d039u, 0xe6db99e5u, 0x1fa27cf8u, 0xc4ac5665u
+            , 0xf4292244u, 0x432aff97u, 0xab9423a7u, 0xfc93a039u, 0x655b59c3u, 0x8f0ccc92u, 0xffeff47du, 0x85845dd1u
+            , 0x6fa87e4fu, 0xfe2ce6e0u, 0xa3014314u, 0x4e0811a1u, 0xf7537e82u, 0xbd3af235u, 0x2ad7d2bbu, 0xeb86d391u
+        };
+
+        template<unsigned I, typename V>
+        [[gnu::always_inline]] static inline void round(V& a, V& b, V& c, V& d, const V (&w)[16]) noexcept
+        {
+            constexpr unsigned S[4][4] = {{7, 12, 17, 22}, {5, 9, 14, 20}, {4, 11, 16, 23}, {6, 10, 15, 21}};
+            constexpr unsigned stage = I / 16u;
+            constexpr unsigned g = stage == 0u ?  I
+                                 : stage == 1u ? (5u * I + 1u) % 16u
+                                 : stage == 2u ? (3u * I + 5u) % 16u
+                                 :               (7u * I     ) % 16u;
+            V f;
+            if constexpr (stage == 0u) f = d ^ (b & (c ^ d));
+            if constexpr (stage == 1u) f = c ^ (d & (b ^ c));
+            if constexpr (stage == 2u) f = b ^ c ^ d;
+            if constexpr (stage == 3u) f = c ^ (b | ~d);
+            const V rotated = rotl<S[stage][I % 4u]>(a + f + K[I] + w[g]);
+            a = d;
+            d = c;
+            c = b;
+            b = b + rotated;
+        }
+
+        template<typename V, unsigned... I>
+        [[gnu::always_inline]] static inline void rounds(V& a, V& b, V& c, V& d, const V (&w)[16], std::integer_sequence<unsigned, I...>) noexcept
+        {
+            (round<I>(a, b, c, d, w), ...);
+        }
+
+        template<typename V>
+        [[gnu::always_inline]] static inline void compress(V (&state)[WORDS], const V (&w)[16]) noexcept
+        {
+            V a = state[0], b = state[1], c = state[2], d = state[3];
+            rounds(a, b, c, d, w, std::make_integer_sequence<unsigned, 64>{});
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+        }
+    };
+
+    struct sha1
+    {
+        static constexpr size_t WORDS = 5u;
+        static constexpr bool   BIG_ENDIAN_WORDS = true;
+        static constexpr uint32_t IV[WORDS] = {0x67452301u, 0xefcdab89u, 0x98badcfeu, 0x10325476u, 0xc3d2e1f0u};
+
+        template<unsigned T, typename V>
+        [[gnu::always_inline]] static inline void round(V& a, V& b, V& c, V& d, V& e, V (&w)[16]) noexcept
+        {
+            if constexpr (T >= 16u)
+            {
+                w[T % 16u] = rotl<1>(w[(T - 3u) % 16u] ^ w[(T - 8u) % 16u] ^ w[(T - 14u) % 16u] ^ w[T % 16u]);
+            }
+            V f;
+            uint32_t k = 0u;
+            if constexpr (T < 20u)      {f = d ^ (b & (c ^ d));          k = 0x5a827999u;}
+            else if constexpr (T < 40u) {f = b ^ c ^ d;                  k = 0x6ed9eba1u;}
+            else if constexpr (T < 60u) {f = (b & c) | (d & (b | c));    k = 0x8f1bbcdcu;}
+            else                        {f = b ^ c ^ d;                  k = 0xca62c1d6u;}
+            const V temp = rotl<5>(a) + f + e + k + w[T % 16u];
+            e = d;
+            d = c;
+            c = rotl<30>(b);
+            b = a;
+            a = temp;
+        }
+
+        template<typename V, unsigned... T>
+        [[gnu::always_inline]] static inline void rounds(V& a, V& b, V& c, V& d, V& e, V (&w)[16], std::integer_sequence<unsigned, T...>) noexcept
+        {
+            (round<T>(a, b, c, d, e, w), ...);
+        }
+
+        template<typename V>
+        [[gnu::always_inline]] static inline void compress(V (&state)[WORDS], const V (&block)[16]) noexcept
+        {
+            V w[16];
+            std::copy_n(block, 16, w);
+            V a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+            rounds(a, b, c, d, e, w, std::make_integer_sequence<unsigned, 80>{});
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+        }
+    };
+
+    // One message: the shared prefix, the message itself, the 0x80 marker,
+    // zero padding and the bit length in the last 8 octets of the last block.
+    struct padded_message
+    {
+        std::span<const std::byte> prefix;
+        std::string_view text;
+
+        uint64_t size() const noexcept {return std::size(prefix) + std::size(text);}
+        uint64_t blocks() const noexcept {return (size() + 8u) / 64u + 1u;}
+
+        template<bool BIG_ENDIAN_WORDS>
+        void block(const uint64_t index, uint8_t (&octets)[64]) const noexcept
+        {
+            std::memset(octets, 0, sizeof(octets));
+            const uint64_t first = 64u * index;
+            const auto copy = [&](const void* const source, const uint64_t offset, const uint64_t count) noexcept
+            {
+                const uint64_t from = std::max(first, offset);
+                const uint64_t to   = std::min(first + 64u, offset + count);
+                if(from < to) std::memcpy(octets + (from - first), static_cast<const uint8_t*>(source) + (from - offset), to - from);
+            };
+            copy(std::data(prefix), 0u, std::size(prefix));
+            copy(std::data(text), std::size(prefix), std::size(text));
+            const uint8_t marker = 0x80u;
+            copy(&marker, size(), 1u);
+            if(index + 1u == blocks())
+            {
+                const uint64_t bits = size() * 8u;
+                for(unsigned i = 0; i < 8u; ++i)
+                {
+                    octets[BIG_ENDIAN_WORDS ? 63u - i : 56u + i] = static_cast<uint8_t>(bits >> (8u * i));
+                }
+            }
+        }
+    };
+
+    // Keeps every lane busy: a lane that finishes its message takes the next
+    // one, idle lanes hash a zero block that nobody reads.
+    template<typename H, typename V>
+    [[gnu::always_inline]] inline void hash_lanes(   const std::span<const std::byte> prefix
+                                                   , const std::span<const std::string_view> messages
+                                                   , const std::span<digest> digests ) noexcept
+    {
+        constexpr size_t L    = LANES<V>;
+        constexpr size_t NONE = ~size_t{0};
+
+        struct job
+        {
+            size_t message = NONE;
+            uint64_t block = 0u;
+            uint64_t blocks = 0u;
+        } jobs[L];
+
+        V state[H::WORDS] = {};
+        size_t next = 0u;
+        size_t active = 0u;
+        const auto assign = [&](const size_t index) noexcept
+        {
+            jobs[index] = job{};
+            for(size_t word = 0; word < H::WORDS; ++word) lane(state[word], index) = H::IV[word];
+            if(next >= std::size(messages)) return;
+            jobs[index].message = next;
+            jobs[index].blocks  = padded_message{prefix, messages[next]}.blocks();
+            ++next;
+            ++active;
+        };
+        for(size_t index = 0; index < L; ++index) assign(index);
+
+        while(active > 0u)
+        {
+            V w[16] = {};
+            for(size_t index = 0; index < L; ++index)
+            {
+                if(NONE == jobs[index].message) continue;
+                uint8_t octets[64];
+                padded_message{prefix, messages[jobs[index].message]}.template block<H::BIG_ENDIAN_WORDS>(jobs[index].block, octets);
+                for(size_t word = 0; word < 16u; ++word)
+                {
+                    uint32_t value = 0u;
+                    std::memcpy(&value, octets + 4u * word, sizeof(value));
+                    lane(w[word], index) = H::BIG_ENDIAN_WORDS ? __builtin_bswap32(value) : value;
+                }
+            }
+
+            H::compress(state, w);
+
+            for(size_t index = 0; index < L; ++index)
+            {
+                if(NONE == jobs[index].message || ++jobs[index].block < jobs[index].blocks) continue;
+                digest& out = digests[jobs[index].message];
+                for(size_t word = 0; word < H::WORDS; ++word)
+                {
+                    const uint32_t value = lane(state[word], index);
+                    const uint32_t ordered = H::BIG_ENDIAN_WORDS ? __builtin_bswap32(value) : value;
+                    std::memcpy(std::data(out) + 4u * word, &ordered, sizeof(ordered));
+                }
+                --active;
+                assign(index);
+            }
+        }
+    }
+
+    template<typename H>
+    void hash_scalar(const std::span<const std::byte> prefix, const std::span<const std::string_view> messages, const std::span<digest> digests) noexcept
+    {
+        hash_lanes<H, uint32_t>(prefix, messages, digests);
+    }
+
+    template<typename H>
+    void hash_x4(const std::span<const std::byte> prefix, const std::span<const std::string_view> messages, const std::span<digest> digests) noexcept
+    {
+        hash_lanes<H, x4>(prefix, messages, digests);
+    }
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    template<typename H>
+    __attribute__((target("avx2")))
+    void hash_x8(const std::span<const std::byte> prefix, const std::span<const std::string_view> messages, const std::span<digest> digests) noexcept
+    {
+        hash_lanes<H, x8>(prefix, messages, digests);
+    }
+#else
+    template<typename H>
+    void hash_x8(const std::span<const std::byte> prefix, const std::span<const std::string_view> messages, const std::span<digest> digests) noexcept
+    {
+        hash_lanes<H, x8>(prefix, messages, digests);
+    }
+#endif
+
+    template<typename H>
+    void hash(   const instruction_set kernel
+               , const std::span<const std::byte> prefix
+               , const std::span<const std::string_view> messages
+               , const std::span<digest> digests ) noexcept
+    {
+        // A lone message gains nothing from extra lanes.
+        if(std::size(messages) <= 1u) return hash_scalar<H>(prefix, messages, digests);
+        switch(kernel)
+        {
+            case instruction_set::avx2 : return hash_x8<H>(prefix, messages, digests);
+            case instruction_set::ssse3: return hash_x4<H>(prefix, messages, digests);
+            default: return hash_scalar<H>(prefix, messages, digests);
+        }
+    }
+
+} // namespace
+
+
+namespace rfc4122::__internal
+{
+
+    void hash_n(   const instruction_set kernel
+                 , const hash_algorithm algorithm
+                 , const std::span<const std::byte> prefix
+                 , const std::span<const std::string_view> messages
+                 , const std::span<digest> digests ) noexcept
+    {
+        const auto count = std::min(std::size(messages), std::size(digests));
+        switch(algorithm)
+        {
+            case hash_algorithm::md5 : return hash<md5 >(kernel, prefix, messages.first(count), digests.first(count));
+            case hash_algorithm::sha1: return hash<sha1>(kernel, prefix, messages.first(count), digests.first(count));
+        }
+    }
+
+} // namespace rfc4122::__internal
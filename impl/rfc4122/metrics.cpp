@@ -0,0 +1,213 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+
+#include <rfc4122/metrics.h>
+
+using namespace rfc4122::__internal;
+using namespace rfc4122;
+
+namespace
+{
+
+    // Written by one thread only, so an increment is a plain load and store.
+    void bump(std::atomic<uint64_t>& counter, const uint64_t by) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    struct alignas(64) operation_counters
+    {
+        std::atomic<uint64_t> calls{0u};
+        std::atomic<uint64_t> ids{0u};
+        std::atomic<uint64_t> failures{0u};
+        std::atomic<uint64_t> latency_sum{0u};
+        std::atomic<uint64_t> latency[LATENCY_BUCKETS] = {};
+    };
+
+    // Counters of one thread, on cache lines of their own.
+    struct alignas(64) thread_counters
+    {
+        operation_counters operations[METERED_OPERATIONS];
+        alignas(64) std::atomic<uint64_t> clock_regressions{0u};
+    };
+
+    void add(metrics_snapshot& snapshot, const thread_counters& counters) noexcept
+    {
+        for(size_t operation = 0; operation < METERED_OPERATIONS; ++operation)
+        {
+            const operation_counters& from = counters.operations[operation];
+            operation_metrics& to = snapshot.operations[operation];
+            to.calls       += from.calls.load(std::memory_order_relaxed);
+            to.ids         += from.ids.load(std::memory_order_relaxed);
+            to.failures    += from.failures.load(std::memory_order_relaxed);
+            to.latency_sum += std::chrono::nanoseconds{from.latency_sum.load(std::memory_order_relaxed)};
+            for(size_t bucket = 0; bucket < LATENCY_BUCKETS; ++bucket)
+            {
+                to.latency[bucket] += from.latency[bucket].load(std::memory_order_relaxed);
+            }
+        }
+        snapshot.clock_regressions += counters.clock_regressions.load(std::memory_order_relaxed);
+    }
+
+    struct registration;
+
+    struct registry
+    {
+        std::mutex lock;
+        std::vector<const registration*> live;
+        metrics_snapshot finished; // totals of threads that have exited
+        uint64_t threads = 0u;
+
+        // Never destroyed: threads may still exit after static destructors ran.
+        static registry& instance()
+        {
+            static registry* const everyone = new registry;
+            return *everyone;
+        }
+    };
+
+    struct registration
+    {
+        thread_counters counters;
+        uint64_t thread = 0u;
+
+        registration()
+        {
+            auto& all = registry::instance();
+            const std::lock_guard guard{all.lock};
+            thread = all.threads++;
+            all.live.push_back(this);
+        }
+
+        ~registration()
+        {
+            auto& all = registry::instance();
+            const std::lock_guard guard{all.lock};
+            add(all.finished, counters);
+            std::erase(all.live, this);
+        }
+    };
+
+    thread_local registration local;
+
+    const char* const OPERATION_NAMES[METERED_OPERATIONS] = {"parse", "format", "generate"};
+
+    void append(std::string& text, const char* const format, auto... values)
+    {
+        char line[160];
+        const int length = std::snprintf(line, sizeof(line), format, values...);
+        text.append(line, static_cast<size_t>(std::clamp<int>(length, 0, sizeof(line) - 1)));
+    }
+
+    void append_counter(   std::string& text
+                         , const metrics_snapshot& snapshot
+                         , const char* const name
+                         , const char* const help
+                         , uint64_t operation_metrics::* const field )
+    {
+        append(text, "# HELP %s %s\n# TYPE %s counter\n", name, help, name);
+        for(size_t operation = 0; operation < METERED_OPERATIONS; ++operation)
+        {
+            append(text, "%s{operation=\"%s\"} %" PRIu64 "\n", name, OPERATION_NAMES[operation], snapshot.operations[operation].*field);
+        }
+    }
+
+} // namespace
+
+
+namespace rfc4122::__internal
+{
+
+    void record_operation(const metered_operation operation, const uint64_t ids, const uint64_t failures) noexcept
+    {
+        operation_counters& counters = local.counters.operations[static_cast<size_t>(operation)];
+        bump(counters.calls, 1u);
+        bump(counters.ids, ids);
+        if(0u != failures) bump(counters.failures, failures);
+    }
+
+    void record_latency(const metered_operation operation, const std::chrono::nanoseconds latency) noexcept
+    {
+        operation_counters& counters = local.counters.operations[static_cast<size_t>(operation)];
+        const uint64_t nanoseconds = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+        bump(counters.latency_sum, nanoseconds);
+        bump(counters.latency[std::min<size_t>(std::bit_width(nanoseconds), LATENCY_BUCKETS - 1u)], 1u);
+    }
+
+    void record_clock_regression() noexcept
+    {
+        bump(local.counters.clock_regressions, 1u);
+    }
+
+} // namespace rfc4122::__internal
+
+
+namespace rfc4122
+{
+
+    metrics_snapshot collect_metrics()
+    {
+        metrics_snapshot snapshot{};
+        if constexpr(!METRICS_ENABLED) return snapshot;
+
+        auto& all = registry::instance();
+        const std::lock_guard guard{all.lock};
+        snapshot.operations = all.finished.operations;
+        snapshot.clock_regressions = all.finished.clock_regressions;
+        snapshot.threads.reserve(std::size(all.live));
+        for(const registration* const thread: all.live)
+        {
+            add(snapshot, thread->counters);
+            const auto& generate = thread->counters.operations[static_cast<size_t>(metered_operation::generate)];
+            snapshot.threads.push_back({thread->thread, generate.ids.load(std::memory_order_relaxed)});
+        }
+        return snapshot;
+    }
+
+    std::string to_prometheus(const metrics_snapshot& snapshot)
+    {
+        std::string text;
+        append_counter(text, snapshot, "uuid_calls_total", "Calls of parse, format and generate functions.", &operation_metrics::calls);
+        append_counter(text, snapshot, "uuid_ids_total", "Ids parsed, formatted or generated.", &operation_metrics::ids);
+        append_counter(text, snapshot, "uuid_failures_total", "Malformed literals parsed as NIL_UUID.", &operation_metrics::failures);
+
+        text += "# HELP uuid_clock_regressions_total Wall clock readings behind an earlier one.\n"
+                "# TYPE uuid_clock_regressions_total counter\n";
+        append(text, "uuid_clock_regressions_total %" PRIu64 "\n", snapshot.clock_regressions);
+
+        text += "# HELP uuid_call_duration_seconds Time taken by one call, sampled.\n"
+                "# TYPE uuid_call_duration_seconds histogram\n";
+        for(size_t operation = 0; operation < METERED_OPERATIONS; ++operation)
+        {
+            const operation_metrics& metrics = snapshot.operations[operation];
+            const char* const name = OPERATION_NAMES[operation];
+            uint64_t cumulative = 0u;
+            for(size_t bucket = 0; bucket + 1u < LATENCY_BUCKETS; ++bucket)
+            {
+                cumulative += metrics.latency[bucket];
+                append(text, "uuid_call_duration_seconds_bucket{operation=\"%s\",le=\"%g\"} %" PRIu64 "\n", name, static_cast<double>(uint64_t{1} << bucket) * 1e-9, cumulative);
+            }
+            cumulative += metrics.latency[LATENCY_BUCKETS - 1u];
+            append(text, "uuid_call_duration_seconds_bucket{operation=\"%s\",le=\"+Inf\"} %" PRIu64 "\n", name, cumulative);
+            append(text, "uuid_call_duration_seconds_sum{operation=\"%s\"} %.9f\n", name, std::chrono::duration<double>(metrics.latency_sum).count());
+            append(text, "uuid_call_duration_seconds_count{operation=\"%s\"} %" PRIu64 "\n", name, cumulative);
+        }
+
+        text += "# HELP uuid_thread_generated_ids_total Ids generated by each live thread.\n"
+                "# TYPE uuid_thread_generated_ids_total counter\n";
+        for(const auto& thread: snapshot.threads)
+        {
+            append(text, "uuid_thread_generated_ids_total{thread=\"%" PRIu64 "\"} %" PRIu64 "\n", thread.thread, thread.ids);
+        }
+        return text;
+    }
+
+} // namespace rfc4122
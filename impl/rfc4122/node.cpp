@@ -0,0 +1,167 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <tuple>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <rfc4122/node.h>
+
+using namespace rfc4122::__internal;
+using namespace rfc4122;
+
+namespace
+{
+
+    constexpr uint64_t NODE_MASK = 0xFFFFFFFFFFFFu;
+    constexpr uint64_t MULTICAST = 0x010000000000u;
+    constexpr uint64_t LOCAL     = 0x020000000000u;
+
+    // Name space of the sha1 digest that stands for the machine id.
+    constexpr uuid MACHINE_ID_NAMESPACE = "4c8d1e2a-7f35-4b0e-9d6a-5e21c3f08b47"_uuid;
+
+    std::optional<std::string> first_line(const std::filesystem::path& file)
+    {
+        std::ifstream input{file};
+        std::string line;
+        if(!std::getline(input, line)) return std::nullopt;
+        return line;
+    }
+
+    // "aa:bb:cc:dd:ee:ff"
+    std::optional<uint64_t> parse_mac(const std::string& text) noexcept
+    {
+        if(17u != std::size(text)) return std::nullopt;
+        uint64_t node = 0u;
+        for(size_t octet = 0; octet < 6u; ++octet)
+        {
+            const char* const digits = std::data(text) + octet * 3u;
+            const auto value = hexes_to_octet(digits[0], digits[1]);
+            if(!value || (octet < 5u && ':' != digits[2])) return std::nullopt;
+            node = (node << 8) | static_cast<uint64_t>(*value);
+        }
+        return node;
+    }
+
+    // Packed as (valid, source, node), so one atomic word holds it all.
+    constexpr uint64_t VALID = uint64_t{1} << 63;
+    constexpr unsigned SOURCE_SHIFT = 48u;
+
+    std::atomic<uint64_t> cached_node{0u};
+
+    constexpr uint64_t pack(const host_node_id& id) noexcept
+    {
+        return VALID | (uint64_t{static_cast<uint8_t>(id.source)} << SOURCE_SHIFT) | id.node;
+    }
+
+    constexpr host_node_id unpack(const uint64_t packed) noexcept
+    {
+        return {packed & NODE_MASK, static_cast<node_source>((packed >> SOURCE_SHIFT) & 0xFFu)};
+    }
+
+    uint64_t random_node() noexcept
+    {
+        try
+        {
+            return generate_uuid().node() | MULTICAST;
+        }
+        catch(...)
+        {
+            const auto now = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+            return (fold_multiply(now, static_cast<uint64_t>(::getpid()) ^ 0x9E3779B97F4A7C15u) & NODE_MASK) | MULTICAST;
+        }
+    }
+
+    host_node_id discover() noexcept
+    {
+        if(const auto node = interface_node("/sys/class/net")) return {*node, node_source::interface};
+        if(const auto node = machine_id_node("/etc/machine-id")) return {*node, node_source::machine_id};
+        return {random_node(), node_source::random};
+    }
+
+    // The child after fork() must not share a random node with its parent;
+    // an address or a machine id is the same in both.
+    void forget_random_node() noexcept
+    {
+        if(node_source::random == unpack(cached_node.load(std::memory_order_relaxed)).source)
+        {
+            cached_node.store(0u, std::memory_order_relaxed);
+        }
+    }
+
+    [[maybe_unused]] const int fork_handler = ::pthread_atfork(nullptr, nullptr, forget_random_node);
+
+} // namespace
+
+
+namespace rfc4122::__internal
+{
+
+    std::optional<uint64_t> interface_node(const std::filesystem::path& directory) noexcept
+    {
+        try
+        {
+            // (no device behind it, name, node) of the best interface so far.
+            std::optional<std::tuple<bool, std::string, uint64_t>> best;
+            for(const auto& entry: std::filesystem::directory_iterator{directory})
+            {
+                const auto text = first_line(entry.path() / "address");
+                const auto node = text ? parse_mac(*text) : std::nullopt;
+                if(!node || 0u == *node || 0u != (*node & (MULTICAST | LOCAL))) continue;
+
+                std::error_code error;
+                std::tuple candidate{!std::filesystem::exists(entry.path() / "device", error), entry.path().filename().string(), *node};
+                if(!best || candidate < *best) best = std::move(candidate);
+            }
+            if(best) return std::get<2>(*best);
+        }
+        catch(...)
+        {
+        }
+        return std::nullopt;
+    }
+
+    std::optional<uint64_t> machine_id_node(const std::filesystem::path& file) noexcept
+    {
+        try
+        {
+            const auto text = first_line(file);
+            if(!text || 32u != std::size(*text)) return std::nullopt;
+            for(const char symbol: *text)
+            {
+                if(!hex_to_quartet(symbol)) return std::nullopt;
+            }
+            return generate_sha1_uuid(MACHINE_ID_NAMESPACE, *text).node() | MULTICAST;
+        }
+        catch(...)
+        {
+            return std::nullopt;
+        }
+    }
+
+} // namespace rfc4122::__internal
+
+
+namespace rfc4122
+{
+
+    host_node_id host_node() noexcept
+    {
+        uint64_t packed = cached_node.load(std::memory_order_acquire);
+        if(0u != packed) return unpack(packed);
+
+        // Racing threads find the same address or machine id; of random
+        // nodes the first one stored wins.
+        const uint64_t found = pack(discover());
+        return cached_node.compare_exchange_strong(packed, found, std::memory_order_acq_rel, std::memory_order_acquire)
+             ? unpack(found)
+             : unpack(packed);
+    }
+
+} // namespace rfc4122
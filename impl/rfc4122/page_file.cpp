@@ -0,0 +1,216 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <system_error>
+
+#include <rfc4122/page_file.h>
+
+using namespace rfc4122::__internal;
+using namespace rfc4122;
+
+namespace
+{
+
+    // File layout: this header, the ids, the page_stats of every page, then
+    // the footer. Both ends are 64 octets, so the ids and the statistics are
+    // aligned in the mapping.
+    constexpr char HEADER_MAGIC[8] = {'U', 'U', 'I', 'D', 'P', 'G', 'F', '1'};
+    constexpr char FOOTER_MAGIC[8] = {'U', 'U', 'I', 'D', 'P', 'G', 'E', '1'};
+
+    // page_stats::flags and footer::flags.
+    constexpr uint64_t SORTED = 1u;
+
+    // Far above any sensible page, low enough that page offsets never overflow.
+    constexpr uint64_t MAX_PAGE_SIZE = uint64_t{1} << 32;
+
+    struct header
+    {
+        char magic[8];
+        uint64_t page_size;
+        uint64_t reserved[6];
+    };
+
+    struct footer
+    {
+        char magic[8];
+        uint64_t count;
+        uint64_t page_size;
+        uint64_t pages;
+        uint64_t flags;
+        uint64_t reserved[3];
+    };
+
+    static_assert(64u == sizeof(header) && 64u == sizeof(footer));
+
+    page_stats statistics_of(const std::span<const uuid> ids)
+    {
+        page_stats stats{};
+        stats.min = *std::min_element(std::begin(ids), std::end(ids));
+        stats.max = *std::max_element(std::begin(ids), std::end(ids));
+        stats.first_time = std::numeric_limits<int64_t>::max();
+        stats.last_time  = std::numeric_limits<int64_t>::min();
+        stats.flags = std::is_sorted(std::begin(ids), std::end(ids)) ? SORTED : 0u;
+
+        std::vector<uuid_time_point> times(std::size(ids));
+        extract_fields(ids, {.times = times, .clock_sequences = {}, .nodes = {}, .versions = {}, .variants = {}});
+        for(const auto time: times)
+        {
+            if(uuid_time_point::min() == time) continue;
+            stats.first_time = std::min(stats.first_time, time.time_since_epoch().count());
+            stats.last_time  = std::max(stats.last_time , time.time_since_epoch().count());
+        }
+        return stats;
+    }
+
+} // namespace
+
+
+namespace rfc4122
+{
+
+    page_file_writer::page_file_writer(const std::filesystem::path& path, const size_t page_size)
+        : ids_per_page{std::clamp<size_t>(page_size, 1u, MAX_PAGE_SIZE)}
+        , output{path}
+    {
+        page.reserve(ids_per_page);
+        header head{};
+        std::memcpy(head.magic, HEADER_MAGIC, sizeof(HEADER_MAGIC));
+        head.page_size = ids_per_page;
+        output.write(std::as_bytes(std::span{&head, 1u}));
+    }
+
+    void page_file_writer::write(std::span<const uuid> ids)
+    {
+        while(!std::empty(ids))
+        {
+            const size_t taken = std::min(std::size(ids), ids_per_page - std::size(page));
+            page.insert(std::end(page), std::begin(ids), std::begin(ids) + taken);
+            ids = ids.subspan(taken);
+            if(std::size(page) == ids_per_page) write_page();
+        }
+    }
+
+    void page_file_writer::write_page()
+    {
+        if(std::empty(page)) return;
+        const page_stats stats = statistics_of(page);
+        sorted = sorted && 0u != (stats.flags & SORTED) && (std::empty(index) || !(stats.min < index.back().max));
+        index.push_back(stats);
+        count += std::size(page);
+        output.write(std::as_bytes(std::span<const uuid>{page}));
+        page.clear();
+    }
+
+    void page_file_writer::close()
+    {
+        if(closed) return;
+        write_page();
+        output.write(std::as_bytes(std::span<const page_stats>{index}));
+
+        footer tail{};
+        std::memcpy(tail.magic, FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+        tail.count     = count;
+        tail.page_size = ids_per_page;
+        tail.pages     = std::size(index);
+        tail.flags     = sorted ? SORTED : 0u;
+        output.write(std::as_bytes(std::span{&tail, 1u}));
+        output.close();
+        closed = true;
+    }
+
+
+    page_file::page_file(const std::filesystem::path& path)
+        : file{path}
+    {
+        const auto bytes = file.bytes();
+        header head{};
+        footer tail{};
+        const auto invalid = [&]
+        {
+            if(std::size(bytes) < sizeof(header) + sizeof(footer)) return true;
+            std::memcpy(&head, std::data(bytes), sizeof(header));
+            std::memcpy(&tail, std::data(bytes) + std::size(bytes) - sizeof(footer), sizeof(footer));
+            if(   0 != std::memcmp(head.magic, HEADER_MAGIC, sizeof(HEADER_MAGIC))
+               || 0 != std::memcmp(tail.magic, FOOTER_MAGIC, sizeof(FOOTER_MAGIC))
+               || 0u == tail.page_size || tail.page_size > MAX_PAGE_SIZE || head.page_size != tail.page_size
+               || tail.pages != (tail.count + tail.page_size - 1u) / tail.page_size )
+            {
+                return true;
+            }
+            const uint64_t body = std::size(bytes) - sizeof(header) - sizeof(footer);
+            return    tail.count > body / sizeof(uuid)
+                   || tail.pages > body / sizeof(page_stats)
+                   || body != tail.count * sizeof(uuid) + tail.pages * sizeof(page_stats);
+        }();
+        if(invalid) throw std::system_error(EINVAL, std::generic_category(), path.string());
+
+        const std::byte* const ids = std::data(bytes) + sizeof(header);
+        all   = {reinterpret_cast<const uuid*>(ids), tail.count};
+        index = {reinterpret_cast<const page_stats*>(ids + tail.count * sizeof(uuid)), tail.pages};
+        ids_per_page = tail.page_size;
+        ordered = 0u != (tail.flags & SORTED);
+    }
+
+    page_info page_file::page(const size_t page) const noexcept
+    {
+        const page_stats& stats = index[page];
+        return {   all.subspan(page * ids_per_page, std::min(ids_per_page, size() - page * ids_per_page))
+                 , stats.min
+                 , stats.max
+                 , uuid_time_point{gregorian_ticks{stats.first_time}}
+                 , uuid_time_point{gregorian_ticks{stats.last_time}}
+                 , 0u != (stats.flags & SORTED) };
+    }
+
+    // Neighbouring pages that pass come back as one span.
+    template<typename P>
+    std::vector<std::span<const uuid>> page_file::select_pages(const P& overlaps) const
+    {
+        std::vector<std::span<const uuid>> runs;
+        for(size_t page = 0; page < pages(); )
+        {
+            if(!overlaps(index[page]))
+            {
+                ++page;
+                continue;
+            }
+            const size_t first = page;
+            while(page < pages() && overlaps(index[page])) ++page;
+            const size_t begin = first * ids_per_page;
+            runs.push_back(all.subspan(begin, std::min(page * ids_per_page, size()) - begin));
+        }
+        return runs;
+    }
+
+    std::vector<std::span<const uuid>> page_file::select(const uuid& low, const uuid& high) const
+    {
+        auto runs = select_pages([&](const page_stats& stats) {return !(stats.max < low) && !(high < stats.min);});
+        if(ordered)
+        {
+            for(auto& run: runs)
+            {
+                const auto first = std::lower_bound(std::begin(run), std::end(run), low);
+                const auto last  = std::upper_bound(first, std::end(run), high);
+                run = run.subspan(static_cast<size_t>(first - std::begin(run)), static_cast<size_t>(last - first));
+            }
+            std::erase_if(runs, [](const auto& run) {return std::empty(run);});
+        }
+        return runs;
+    }
+
+    std::vector<std::span<const uuid>> page_file::select_time(const uuid_time_point from, const uuid_time_point to) const
+    {
+        const int64_t first = from.time_since_epoch().count();
+        const int64_t last  = to.time_since_epoch().count();
+        return select_pages([&](const page_stats& stats)
+        {
+            return stats.first_time <= stats.last_time && stats.first_time <= last && first <= stats.last_time;
+        });
+    }
+
+} // namespace rfc4122
@@ -0,0 +1,159 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <rfc4122/pool.h>
+
+using namespace rfc4122;
+
+namespace
+{
+
+    // Ids generated per call, small enough that waiting pops are fed soon.
+    constexpr size_t REFILL_BATCH = 256u;
+
+    using generator = void (*)(std::span<uuid>);
+
+    generator generator_of(const rfc4122::version kind)
+    {
+        switch(kind)
+        {
+            case rfc4122::version::random        : return generate_n;
+            case rfc4122::version::time_based    : return generate_time_based_n;
+            case rfc4122::version::reordered_time: return generate_reordered_time_n;
+            case rfc4122::version::unix_time     : return generate_unix_time_n;
+            default: throw std::invalid_argument("id_pool: no generator for this version");
+        }
+    }
+
+    // Pushes as many of `ids` as fit, returns how many did.
+    size_t push(__internal::mpmc_ring<uuid>& ring, const std::span<const uuid> ids) noexcept
+    {
+        size_t pushed = 0u;
+        while(pushed < std::size(ids) && ring.try_push(ids[pushed])) ++pushed;
+        return pushed;
+    }
+
+} // namespace
+
+namespace rfc4122
+{
+
+    id_pool::id_pool(const id_pool_options& options)
+        : settings{options}
+        , generate{generator_of(options.version)}
+        , ring{options.capacity}
+        , lowest_size{ring.capacity()}
+    {
+        // A full ring would always be low, the refill thread would never sleep.
+        if(settings.low_watermark >= ring.capacity()) throw std::invalid_argument("id_pool: low_watermark must be below the capacity");
+
+        uuid batch[REFILL_BATCH];
+        for(size_t left = ring.capacity(); left > 0u; )
+        {
+            const std::span<uuid> ids{batch, std::min(left, REFILL_BATCH)};
+            generate(ids);
+            left -= push(ring, ids);
+        }
+        refiller = std::thread{&id_pool::refill_loop, this};
+    }
+
+    id_pool::~id_pool()
+    {
+        stopping.store(true);
+        wake_refiller();
+        refiller.join();
+    }
+
+    void id_pool::refill_loop()
+    {
+        uuid batch[REFILL_BATCH];
+        for(;;)
+        {
+            const uint32_t seen = refill_requests.load();
+            if(stopping.load()) return;
+
+            // Cleared before the size is read, so a pop that finds the ring
+            // low from here on asks again. Drained pops ask regardless.
+            refill_pending.store(false);
+            const size_t size = ring.size();
+            if(size > settings.low_watermark)
+            {
+                refill_requests.wait(seen);
+                continue;
+            }
+
+            lowest_size.store(std::min(lowest_size.load(std::memory_order_relaxed), size), std::memory_order_relaxed);
+            refills.fetch_add(1u, std::memory_order_relaxed);
+            // The only producer, so the room it sees can only grow.
+            for(size_t room = ring.capacity() - size; room > 0u && !stopping.load(std::memory_order_relaxed); )
+            {
+                const std::span<uuid> ids{batch, std::min(REFILL_BATCH, room)};
+                generate(ids);
+                push(ring, ids);
+                refilled.fetch_add(1u);
+                if(0u != waiters.load()) refilled.notify_all();
+                room = ring.capacity() - ring.size();
+            }
+        }
+    }
+
+    void id_pool::wake_refiller() noexcept
+    {
+        refill_requests.fetch_add(1u);
+        refill_requests.notify_one();
+    }
+
+    bool id_pool::try_pop(uuid& id) noexcept
+    {
+        if(!ring.try_pop(id))
+        {
+            wake_refiller();
+            return false;
+        }
+        if(ring.size() <= settings.low_watermark && !refill_pending.load(std::memory_order_relaxed) && !refill_pending.exchange(true))
+        {
+            wake_refiller();
+        }
+        return true;
+    }
+
+    uuid id_pool::pop()
+    {
+        uuid id{};
+        if(try_pop(id)) return id;
+        drained.fetch_add(1u, std::memory_order_relaxed);
+
+        if(drained_policy::generate == settings.when_drained)
+        {
+            fallbacks.fetch_add(1u, std::memory_order_relaxed);
+            generate({&id, 1u});
+            return id;
+        }
+
+        waiters.fetch_add(1u);
+        for(;;)
+        {
+            const uint32_t seen = refilled.load();
+            if(try_pop(id)) break;
+            refilled.wait(seen);
+        }
+        waiters.fetch_sub(1u);
+        return id;
+    }
+
+    id_pool_metrics id_pool::metrics() const noexcept
+    {
+        return {   ring.size()
+                 , lowest_size.load(std::memory_order_relaxed)
+                 , ring.popped()
+                 , ring.pushed() - ring.capacity()
+                 , refills.load(std::memory_order_relaxed)
+                 , drained.load(std::memory_order_relaxed)
+                 , fallbacks.load(std::memory_order_relaxed) };
+    }
+
+} // namespace rfc4122
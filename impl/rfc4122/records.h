@@ -0,0 +1,82 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include <rfc4122/batch.h>
+
+
+
+namespace rfc4122::__internal
+{
+
+    // Record loop shared by every text decoder. Records that are exactly
+    // K::length long are decoded by the kernel, kernels with `pairs` also
+    // decode two such adjacent records at once; anything else is invalid.
+    template<typename K>
+    literals_result parse_records(   const std::string_view text
+                                   , const std::span<uuid> ids
+                                   , const std::span<uint64_t> validity
+                                   , const char delimiter ) noexcept
+    {
+        constexpr ptrdiff_t record = K::length;
+        constexpr ptrdiff_t stride = K::length + 1;
+
+        const size_t capacity = std::min(std::size(ids), 64u * std::size(validity));
+        std::fill_n(std::data(validity), validity_size(capacity), uint64_t{0});
+
+        const char* symbol = std::data(text);
+        const char* const end = symbol + std::size(text);
+        size_t index = 0u;
+        size_t valid = 0u;
+        while(index < capacity && symbol < end)
+        {
+            if constexpr (K::pairs)
+            {
+                if(    index + 1u < capacity 
+                    && end - symbol >= 2 * stride
+                    && delimiter == symbol[record]
+                    && delimiter == symbol[record + stride] )
+                {
+                    const unsigned mask = K::decode_pair(symbol, &ids[index]);
+                    if(0u == (mask & 1u)) ids[index     ] = uuid{};
+                    if(0u == (mask & 2u)) ids[index + 1u] = uuid{};
+                    // The second record may start the next word.
+                    validity[ index       / 64u] |= uint64_t{mask & 1u} << ( index       % 64u);
+                    validity[(index + 1u) / 64u] |= uint64_t{mask >> 1} << ((index + 1u) % 64u);
+                    valid  += std::popcount(mask);
+                    index  += 2u;
+                    symbol += 2 * stride;
+                    continue;
+                }
+            }
+
+            const char* last = end - symbol > record && delimiter == symbol[record] 
+                             ? symbol + record 
+                             : std::find(symbol, end, delimiter);
+            const char* const next = last == end ? end : last + 1;
+            if(last > symbol && '\r' == last[-1] && '\r' != delimiter) --last;
+
+            if(record == last - symbol && K::decode(symbol, ids[index]))
+            {
+                validity[index / 64u] |= uint64_t{1} << (index % 64u);
+                ++valid;
+            }
+            else
+            {
+                ids[index] = uuid{};
+            }
+            ++index;
+            symbol = next;
+        }
+        return literals_result{index, index - valid, static_cast<size_t>(symbol - std::data(text))};
+    }
+
+} // namespace rfc4122::__internal
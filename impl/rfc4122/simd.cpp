@@ -0,0 +1,34 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <rfc4122/simd.h>
+
+using namespace rfc4122::__internal;
+
+namespace
+{
+
+    instruction_set detect() noexcept
+    {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2" )) return instruction_set::avx2;
+        if(__builtin_cpu_supports("ssse3")) return instruction_set::ssse3;
+#endif
+        return instruction_set::scalar;
+    }
+
+} // namespace
+
+
+namespace rfc4122::__internal
+{
+
+    instruction_set detected_instruction_set() noexcept
+    {
+        static const instruction_set detected = detect();
+        return detected;
+    }
+
+} // namespace rfc4122::__internal
@@ -0,0 +1,204 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <rfc4122/algorithm.h>
+
+using namespace rfc4122;
+
+namespace
+{
+
+    constexpr size_t RADIX = 256u;
+    constexpr size_t OCTETS = sizeof(uuid);
+
+    // Below this std::sort wins, the radix passes cost more than they save.
+    constexpr size_t SMALL_INPUT = size_t{1} << 12;
+
+    // Buckets this small are finished with std::sort.
+    constexpr size_t SMALL_BUCKET = 64u;
+
+    // Least work per thread worth the thread.
+    constexpr size_t THREAD_INPUT = size_t{1} << 16;
+
+    using histogram = std::array<size_t, RADIX>;
+
+    uint8_t octet(const uuid& id, const size_t index) noexcept
+    {
+        return reinterpret_cast<const uint8_t*>(&id)[index];
+    }
+
+    // Runs function(0..threads-1), the calling thread takes part 0. Parts
+    // without a thread of their own run on the calling thread.
+    template<typename F>
+    void parallel(const unsigned threads, const F& function)
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for(unsigned part = 1u; part < threads; ++part)
+        {
+            try
+            {
+                workers.emplace_back(function, part);
+            }
+            catch(const std::system_error&)
+            {
+                function(part);
+            }
+        }
+        function(0u);
+        for(auto& worker: workers) worker.join();
+    }
+
+    // Sorts [first, last) by octets from `index` on. The ids are in `source`,
+    // the result goes to `sorted`; `source` and `spare` are scratch and one of
+    // them may be `sorted` itself. All three are indexed alike.
+    void sort_bucket(   uuid* const sorted
+                      , uuid* source
+                      , uuid* spare
+                      , const size_t first
+                      , const size_t last
+                      , size_t index ) noexcept
+    {
+        const size_t size = last - first;
+        histogram counts{};
+        for(; index < OCTETS; ++index)
+        {
+            if(size < SMALL_BUCKET) break;
+            counts.fill(0u);
+            for(size_t i = first; i < last; ++i) ++counts[octet(source[i], index)];
+            // An octet the whole bucket shares orders nothing, no pass for it.
+            if(size != *std::max_element(std::begin(counts), std::end(counts))) break;
+        }
+        if(index == OCTETS || size < SMALL_BUCKET)
+        {
+            if(source != sorted) std::memcpy(sorted + first, source + first, size * sizeof(uuid));
+            std::sort(sorted + first, sorted + last);
+            return;
+        }
+
+        histogram next{};
+        size_t offset = first;
+        for(size_t digit = 0; digit < RADIX; ++digit)
+        {
+            next[digit] = offset;
+            offset += counts[digit];
+        }
+        for(size_t i = first; i < last; ++i) spare[next[octet(source[i], index)]++] = source[i];
+
+        size_t begin = first;
+        for(size_t digit = 0; digit < RADIX; ++digit)
+        {
+            if(0u != counts[digit]) sort_bucket(sorted, spare, source, begin, begin + counts[digit], index + 1u);
+            begin += counts[digit];
+        }
+    }
+
+    void radix_sort(const std::span<uuid> ids, const unsigned threads)
+    {
+        const size_t size = std::size(ids);
+        const auto first = [&](const unsigned part) noexcept {return size * part / threads;};
+
+        // Leading octets all ids share, v7 time prefixes for one, found from
+        // the bits that differ from the first id.
+        std::vector<std::array<uint64_t, 2>> differences(threads);
+        parallel(threads, [&](const unsigned part) noexcept
+        {
+            uint64_t high = 0u, low = 0u;
+            for(size_t i = first(part); i < first(part + 1u); ++i)
+            {
+                high |= ids[i].high() ^ ids[0].high();
+                low  |= ids[i].low()  ^ ids[0].low();
+            }
+            differences[part] = {high, low};
+        });
+        uint64_t high = 0u, low = 0u;
+        for(const auto& difference: differences)
+        {
+            high |= difference[0];
+            low  |= difference[1];
+        }
+        if(0u == (high | low)) return;
+        const size_t index = 0u != high ? std::countl_zero(high) / 8u : 8u + std::countl_zero(low) / 8u;
+
+        // The first pass splits the array between all threads...
+        // Raw storage, uuid is trivially copyable and need not be zeroed first.
+        const std::unique_ptr<std::byte[]> storage{new std::byte[size * sizeof(uuid)]};
+        uuid* const buffer = reinterpret_cast<uuid*>(storage.get());
+        std::vector<histogram> counts(threads);
+        parallel(threads, [&](const unsigned part) noexcept
+        {
+            auto& local = counts[part];
+            local.fill(0u);
+            for(size_t i = first(part); i < first(part + 1u); ++i) ++local[octet(ids[i], index)];
+        });
+        std::vector<histogram> offsets(threads);
+        histogram bucket_first{};
+        size_t offset = 0u;
+        for(size_t digit = 0; digit < RADIX; ++digit)
+        {
+            bucket_first[digit] = offset;
+            for(unsigned part = 0; part < threads; ++part)
+            {
+                offsets[part][digit] = offset;
+                offset += counts[part][digit];
+            }
+        }
+        parallel(threads, [&](const unsigned part) noexcept
+        {
+            auto& next = offsets[part];
+            for(size_t i = first(part); i < first(part + 1u); ++i) buffer[next[octet(ids[i], index)]++] = ids[i];
+        });
+
+        // ... then each thread takes whole buckets, largest first.
+        std::array<size_t, RADIX> order;
+        for(size_t digit = 0; digit < RADIX; ++digit) order[digit] = digit;
+        const auto bucket_size = [&](const size_t digit) noexcept
+        {
+            return (digit + 1u < RADIX ? bucket_first[digit + 1u] : size) - bucket_first[digit];
+        };
+        std::sort(std::begin(order), std::end(order), [&](const size_t left, const size_t right) noexcept
+        {
+            return bucket_size(left) > bucket_size(right);
+        });
+        std::atomic<size_t> taken{0u};
+        parallel(threads, [&](const unsigned) noexcept
+        {
+            for(size_t next = taken++; next < RADIX; next = taken++)
+            {
+                const size_t digit = order[next];
+                if(0u == bucket_size(digit)) continue;
+                sort_bucket(std::data(ids), buffer, std::data(ids), bucket_first[digit], bucket_first[digit] + bucket_size(digit), index + 1u);
+            }
+        });
+    }
+
+} // namespace
+
+
+namespace rfc4122
+{
+
+    void sort(const std::span<uuid> ids, unsigned threads)
+    {
+        if(std::size(ids) < SMALL_INPUT)
+        {
+            std::sort(std::begin(ids), std::end(ids));
+            return;
+        }
+        if(0u == threads) threads = std::max(std::thread::hardware_concurrency(), 1u);
+        threads = static_cast<unsigned>(std::clamp<size_t>(std::size(ids) / THREAD_INPUT, 1u, threads));
+        radix_sort(ids, threads);
+    }
+
+} // namespace rfc4122
@@ -2,7 +2,21 @@
 // Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
 //
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <system_error>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/random.h>
+#include <unistd.h>
+
 #include <rfc4122/uuid.h>
+#include <rfc4122/hash.h>
+#include <rfc4122/node.h>
 
 using namespace rfc4122::__internal;
 using namespace rfc4122;
@@ -10,7 +24,319 @@ using namespace rfc4122;
 namespace
 {
 
+    void fill_from_urandom(std::byte* bytes, size_t size)
+    {
+        const int descriptor = ::open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+        if(descriptor < 0) throw std::system_error(errno, std::generic_category(), "/dev/urandom");
+        while(size > 0u)
+        {
+            const ssize_t count = ::read(descriptor, bytes, size);
+            if(count <= 0)
+            {
+                if(count < 0 && EINTR == errno) continue;
+                const int error = count < 0 ? errno : EIO;
+                ::close(descriptor);
+                throw std::system_error(error, std::generic_category(), "/dev/urandom");
+            }
+            bytes += count;
+            size  -= static_cast<size_t>(count);
+        }
+        ::close(descriptor);
+    }
+
+    void fill_random(std::byte* bytes, size_t size)
+    {
+        while(size > 0u)
+        {
+            const ssize_t count = ::getrandom(bytes, size, 0);
+            if(count < 0)
+            {
+                if(EINTR == errno) continue;
+                if(ENOSYS == errno) return fill_from_urandom(bytes, size);
+                throw std::system_error(errno, std::generic_category(), "getrandom");
+            }
+            bytes += count;
+            size  -= static_cast<size_t>(count);
+        }
+    }
+
+    // Counts fork() calls in the child. State copied from the parent, which
+    // goes on using it too, is dropped when this moves on: buffered entropy,
+    // reserved ticks and the clock sequence.
+    std::atomic<uint64_t> forks{0u};
+
+    void count_fork() noexcept
+    {
+        forks.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    [[maybe_unused]] const int fork_handler = ::pthread_atfork(nullptr, nullptr, count_fork);
+
+    // Per-thread buffer of operating system entropy, one syscall per refill.
+    class entropy_pool
+    {
+    public:
+        static constexpr size_t CAPACITY = 4096u;
+
+        void take(std::byte* bytes, size_t size)
+        {
+            const uint64_t current = forks.load(std::memory_order_relaxed);
+            if(current != generation)
+            {
+                generation = current;
+                offset = CAPACITY;
+            }
+            if(size >= CAPACITY)
+            {
+                fill_random(bytes, size);
+                return;
+            }
+            if(CAPACITY - offset < size)
+            {
+                fill_random(pool, CAPACITY);
+                offset = 0u;
+            }
+            std::memcpy(bytes, pool + offset, size);
+            offset += size;
+        }
+
+    private:
+        alignas(64) std::byte pool[CAPACITY];
+        size_t offset = CAPACITY;
+        uint64_t generation = 0u;
+    };
+
+    thread_local entropy_pool entropy;
+
+    uuid random_uuid(const std::byte* const random) noexcept
+    {
+        uint64_t words[2] = {};
+        std::memcpy(words, random, sizeof(words));
+        return uuid
+        {
+              words[0] & 0x0FFFFFFFFFFFFFFFu
+            , variant::rfc4122
+            , version::random
+            , static_cast<uint16_t>(words[1])
+            , words[1] >> 16
+        };
+    }
+
+    uint64_t gregorian_now() noexcept
+    {
+        const auto since_unix = std::chrono::system_clock::now().time_since_epoch();
+        return GREGORIAN_TO_UNIX + static_cast<uint64_t>(std::chrono::duration_cast<gregorian_ticks>(since_unix).count());
+    }
+
+    // Unix time ticks are milliseconds followed by the counter that orders
+    // ids generated within the same millisecond.
+    constexpr unsigned UNIX_TIME_COUNTER_BITS = 12u;
+
+    uint64_t unix_time_now() noexcept
+    {
+        const auto since_unix = std::chrono::system_clock::now().time_since_epoch();
+        const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(since_unix).count();
+        return static_cast<uint64_t>(milliseconds) << UNIX_TIME_COUNTER_BITS;
+    }
+
+    template<typename T>
+    T random_value()
+    {
+        T value{};
+        entropy.take(reinterpret_cast<std::byte*>(&value), sizeof(value));
+        return value;
+    }
+
+    struct tick_range
+    {
+        uint64_t next = 0u;
+        uint64_t end  = 0u;
+    };
+
+    // Process-wide allocator of strictly increasing ticks. Threads reserve
+    // runs of consecutive ticks with one compare-and-swap and hand them out
+    // locally, so the shared counter is touched once per RUN ids at most.
+    class monotonic_ticks
+    {
+    public:
+        static constexpr uint64_t RUN = 32u;
+
+        // Returns `count` unused ticks, none of them older than `now` when
+        // there is no contention.
+        tick_range reserve(const uint64_t now, const uint64_t count) noexcept
+        {
+            uint64_t last = last_tick.load(std::memory_order_relaxed);
+            uint64_t start = 0u;
+            do
+            {
+                start = std::max(now, last);
+            }
+            while(!last_tick.compare_exchange_weak(last, start + count, std::memory_order_relaxed));
+            return {start, start + count};
+        }
+
+    private:
+        alignas(64) std::atomic<uint64_t> last_tick{0u};
+    };
+
+    // 100ns Gregorian ticks shared by time-based and reordered time ids.
+    class gregorian_clock
+    {
+    public:
+        tick_range reserve(const uint64_t count)
+        {
+            reseed_after_fork();
+            // Loaded before the clock is read: a clock that is newer than
+            // every earlier reading can never look like a regression.
+            uint64_t observed = last_clock.load(std::memory_order_acquire);
+            const uint64_t now = gregorian_now();
+            if(now < observed)
+            {
+                sequence.fetch_add(1u, std::memory_order_relaxed);
+                if constexpr(METRICS_ENABLED) record_clock_regression();
+            }
+            else
+            {
+                last_clock.compare_exchange_strong(observed, now, std::memory_order_release, std::memory_order_relaxed);
+            }
+            return ticks.reserve(now, count);
+        }
+
+        uint16_t clock_sequence() const noexcept
+        {
+            return sequence.load(std::memory_order_relaxed);
+        }
+
+        uint64_t node() const noexcept
+        {
+            return host.load(std::memory_order_relaxed);
+        }
+
+        static gregorian_clock& instance()
+        {
+            static gregorian_clock clock;
+            return clock;
+        }
+
+    private:
+        gregorian_clock()
+            : sequence{random_value<uint16_t>()}
+            , host{host_node().node}
+            , generation{forks.load(std::memory_order_relaxed)}
+        {}
+
+        // A child shares the parent's node unless it is random, and may be
+        // handed ticks the parent hands out too: a clock sequence of its own
+        // keeps their ids apart.
+        void reseed_after_fork()
+        {
+            uint64_t seen = generation.load(std::memory_order_relaxed);
+            const uint64_t current = forks.load(std::memory_order_relaxed);
+            if(seen == current || !generation.compare_exchange_strong(seen, current, std::memory_order_relaxed)) return;
+
+            const uint16_t step = static_cast<uint16_t>(1u + random_value<uint16_t>() % 0x3FFFu);
+            sequence.fetch_add(step, std::memory_order_relaxed);
+            host.store(host_node().node, std::memory_order_relaxed);
+        }
 
+        monotonic_ticks ticks;
+        alignas(64) std::atomic<uint64_t> last_clock{0u};
+        alignas(64) std::atomic<uint16_t> sequence;
+        std::atomic<uint64_t> host;
+        std::atomic<uint64_t> generation;
+    };
+
+    monotonic_ticks unix_time_clock;
+
+    thread_local tick_range gregorian_run;
+    thread_local uint64_t gregorian_run_forks = 0u;
+    thread_local tick_range unix_time_run;
+
+    // A run that the wall clock has passed is dropped, so that ids stay
+    // close to the time they are generated at; so is one from before fork().
+    uint64_t next_gregorian_tick()
+    {
+        const uint64_t current = forks.load(std::memory_order_relaxed);
+        if(   gregorian_run.next >= gregorian_run.end || gregorian_now() >= gregorian_run.end
+           || gregorian_run_forks != current )
+        {
+            gregorian_run = gregorian_clock::instance().reserve(monotonic_ticks::RUN);
+            gregorian_run_forks = current;
+        }
+        return gregorian_run.next++;
+    }
+
+    uint64_t next_unix_time_tick() noexcept
+    {
+        const uint64_t now = unix_time_now();
+        if(unix_time_run.next >= unix_time_run.end || now >= unix_time_run.end)
+        {
+            unix_time_run = unix_time_clock.reserve(now, monotonic_ticks::RUN);
+        }
+        return unix_time_run.next++;
+    }
+
+    uuid time_based_uuid(const uint64_t tick, const gregorian_clock& clock) noexcept
+    {
+        return uuid{tick, variant::rfc4122, version::time_based, clock.clock_sequence(), clock.node()};
+    }
+
+    uuid reordered_time_uuid(const uint64_t tick, const gregorian_clock& clock) noexcept
+    {
+        return uuid
+        {
+              static_cast<uint32_t>(tick >> 28)
+            , static_cast<uint16_t>(tick >> 12)
+            , static_cast<uint16_t>((static_cast<uint16_t>(version::reordered_time) << 12) | (tick & 0x0FFFu))
+            , static_cast<uint16_t>(0x8000u | (clock.clock_sequence() & 0x3FFFu))
+            , clock.node()
+        };
+    }
+
+    uuid unix_time_uuid(const uint64_t tick, const uint64_t random) noexcept
+    {
+        const uint64_t milliseconds = tick >> UNIX_TIME_COUNTER_BITS;
+        return uuid
+        {
+              static_cast<uint32_t>(milliseconds >> 16)
+            , static_cast<uint16_t>(milliseconds)
+            , static_cast<uint16_t>((static_cast<uint16_t>(version::unix_time) << 12) | (tick & 0x0FFFu))
+            , static_cast<uint16_t>(0x8000u | (random & 0x3FFFu))
+            , random >> 16
+        };
+    }
+
+    uuid name_based_uuid(digest octets, const version kind) noexcept
+    {
+        octets[6] = static_cast<uint8_t>((0x0Fu & octets[6]) | (static_cast<uint8_t>(kind) << 4));
+        octets[8] = static_cast<uint8_t>((0x3Fu & octets[8]) | static_cast<uint8_t>(variant::rfc4122));
+        return uuid{reinterpret_cast<const std::byte*>(std::data(octets))};
+    }
+
+    void generate_name_based_n(   const hash_algorithm algorithm
+                                , const version kind
+                                , const uuid& name_space
+                                , std::span<const std::string_view> names
+                                , std::span<uuid> ids ) noexcept
+    {
+        constexpr size_t BATCH = 64u;
+
+        const meter timer{metered_operation::generate};
+        const auto kernel = detected_instruction_set();
+        const auto prefix = std::as_bytes(std::span{&name_space, 1u});
+        digest digests[BATCH];
+        names = names.first(std::min(std::size(names), std::size(ids)));
+        for(size_t first = 0u; first < std::size(names); first += BATCH)
+        {
+            const auto batch = names.subspan(first, std::min(BATCH, std::size(names) - first));
+            hash_n(kernel, algorithm, prefix, batch, digests);
+            for(size_t i = 0; i < std::size(batch); ++i)
+            {
+                ids[first + i] = name_based_uuid(digests[i], kind);
+            }
+        }
+        timer.done(std::size(names));
+    }
 
 } // namespace
 
@@ -18,5 +344,147 @@ namespace
 namespace rfc4122
 {
 
-} // namespace rfc4122
+    uint64_t process_hash_seed() noexcept
+    {
+        static const uint64_t seed = []() noexcept
+        {
+            uint64_t value = 0u;
+            try
+            {
+                fill_random(reinterpret_cast<std::byte*>(&value), sizeof(value));
+            }
+            catch(...)
+            {
+                value = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+            }
+            return value;
+        }();
+        return seed;
+    }
+
+    uuid generate_uuid()
+    {
+        const meter timer{metered_operation::generate};
+        std::byte random[sizeof(uuid)];
+        entropy.take(random, sizeof(random));
+        const uuid id = random_uuid(random);
+        timer.done();
+        return id;
+    }
+
+    void generate_n(const std::span<uuid> ids)
+    {
+        constexpr size_t BATCH = entropy_pool::CAPACITY / sizeof(uuid);
 
+        const meter timer{metered_operation::generate};
+        std::byte random[BATCH * sizeof(uuid)];
+        for(size_t first = 0u; first < std::size(ids); first += BATCH)
+        {
+            const auto batch = ids.subspan(first, std::min(BATCH, std::size(ids) - first));
+            entropy.take(random, std::size(batch) * sizeof(uuid));
+            const std::byte* bits = random;
+            for(uuid& id: batch)
+            {
+                id = random_uuid(bits);
+                bits += sizeof(uuid);
+            }
+        }
+        timer.done(std::size(ids));
+    }
+
+    uuid generate_time_based_uuid()
+    {
+        const meter timer{metered_operation::generate};
+        const uint64_t tick = next_gregorian_tick();
+        const uuid id = time_based_uuid(tick, gregorian_clock::instance());
+        timer.done();
+        return id;
+    }
+
+    void generate_time_based_n(const std::span<uuid> ids)
+    {
+        const meter timer{metered_operation::generate};
+        auto& clock = gregorian_clock::instance();
+        auto range = clock.reserve(std::size(ids));
+        for(uuid& id: ids)
+        {
+            id = time_based_uuid(range.next++, clock);
+        }
+        timer.done(std::size(ids));
+    }
+
+    uuid generate_reordered_time_uuid()
+    {
+        const meter timer{metered_operation::generate};
+        const uint64_t tick = next_gregorian_tick();
+        const uuid id = reordered_time_uuid(tick, gregorian_clock::instance());
+        timer.done();
+        return id;
+    }
+
+    void generate_reordered_time_n(const std::span<uuid> ids)
+    {
+        const meter timer{metered_operation::generate};
+        auto& clock = gregorian_clock::instance();
+        auto range = clock.reserve(std::size(ids));
+        for(uuid& id: ids)
+        {
+            id = reordered_time_uuid(range.next++, clock);
+        }
+        timer.done(std::size(ids));
+    }
+
+    uuid generate_unix_time_uuid()
+    {
+        const meter timer{metered_operation::generate};
+        const uint64_t tick = next_unix_time_tick();
+        const uuid id = unix_time_uuid(tick, random_value<uint64_t>());
+        timer.done();
+        return id;
+    }
+
+    void generate_unix_time_n(const std::span<uuid> ids)
+    {
+        constexpr size_t BATCH = entropy_pool::CAPACITY / sizeof(uint64_t);
+
+        const meter timer{metered_operation::generate};
+        auto range = unix_time_clock.reserve(unix_time_now(), std::size(ids));
+        uint64_t random[BATCH];
+        for(size_t first = 0u; first < std::size(ids); first += BATCH)
+        {
+            const auto batch = ids.subspan(first, std::min(BATCH, std::size(ids) - first));
+            entropy.take(reinterpret_cast<std::byte*>(random), std::size(batch) * sizeof(uint64_t));
+            const uint64_t* bits = random;
+            for(uuid& id: batch)
+            {
+                id = unix_time_uuid(range.next++, *bits++);
+            }
+        }
+        timer.done(std::size(ids));
+    }
+
+    uuid generate_md5_uuid(const uuid& name_space, const std::string_view name) noexcept
+    {
+        uuid id{};
+        generate_md5_n(name_space, std::span{&name, 1u}, std::span{&id, 1u});
+        return id;
+    }
+
+    uuid generate_sha1_uuid(const uuid& name_space, const std::string_view name) noexcept
+    {
+        uuid id{};
+        generate_sha1_n(name_space, std::span{&name, 1u}, std::span{&id, 1u});
+        return id;
+    }
+
+    void generate_md5_n(const uuid& name_space, const std::span<const std::string_view> names, const std::span<uuid> ids) noexcept
+    {
+        generate_name_based_n(hash_algorithm::md5, version::md5_name, name_space, names, ids);
+    }
+
+    void generate_sha1_n(const uuid& name_space, const std::span<const std::string_view> names, const std::span<uuid> ids) noexcept
+    {
+        generate_name_based_n(hash_algorithm::sha1, version::sha1_name, name_space, names, ids);
+    }
+
+} // namespace rfc4122
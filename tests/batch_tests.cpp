@@ -0,0 +1,180 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rfc4122/batch.h>
+#include "random_ids.h"
+
+
+
+namespace
+{
+
+std::string expected_literals(const std::vector<rfc4122::uuid>& ids, const std::string& delimiter)
+{
+    std::string expected;
+    for(const auto& id: ids)
+    {
+        expected += rfc4122::to_string(id) + delimiter;
+    }
+    return expected;
+}
+
+} // namespace
+
+TEST(Batch, to_literals_kernels)
+{
+    using namespace rfc4122::__internal;
+
+    const instruction_set kernels[] = {instruction_set::scalar, instruction_set::ssse3, instruction_set::avx2};
+    for(const auto kernel: kernels)
+    {
+        if(detected_instruction_set() < kernel) continue;
+        for(const size_t count: {0u, 1u, 2u, 3u, 17u, 256u})
+        {
+            const auto ids = random_ids(count);
+            {
+                std::string actual(rfc4122::literals_size(count, false), '?');
+                to_literals(kernel, ids, std::data(actual), std::nullopt);
+                EXPECT_EQ(expected_literals(ids, ""), actual);
+            }
+            {
+                std::string actual(rfc4122::literals_size(count, true), '?');
+                to_literals(kernel, ids, std::data(actual), '\n');
+                EXPECT_EQ(expected_literals(ids, "\n"), actual);
+            }
+        }
+    }
+}
+
+TEST(Batch, to_literals)
+{
+    const auto ids = random_ids(5);
+    {
+        std::string actual(rfc4122::literals_size(std::size(ids), true), '?');
+        const auto written = rfc4122::to_literals(ids, std::span<char>{actual}, ',');
+        EXPECT_EQ(std::size(actual), written);
+        EXPECT_EQ(expected_literals(ids, ","), actual);
+    }
+    {
+        // Only whole literals are written into a short buffer.
+        std::string actual(rfc4122::literals_size(2, false) + 7, '?');
+        const auto written = rfc4122::to_literals(ids, std::span<char>{actual});
+        EXPECT_EQ(rfc4122::literals_size(2, false), written);
+        EXPECT_EQ(expected_literals({ids[0], ids[1]}, "") + "???????", actual);
+    }
+    {
+        std::u32string actual(rfc4122::literals_size(std::size(ids), true), U'?');
+        rfc4122::to_literals(ids, std::span<char32_t>{actual}, U'\n');
+        std::u32string expected;
+        for(const auto& id: ids) expected += rfc4122::to_u32string(id) + U'\n';
+        EXPECT_EQ(expected, actual);
+    }
+}
+
+TEST(Batch, from_literals_kernels)
+{
+    using namespace rfc4122::__internal;
+
+    const auto ids = random_ids(203);
+    std::vector<bool> expected_valid(std::size(ids), true);
+    std::string text;
+    for(size_t i = 0; i < std::size(ids); ++i)
+    {
+        std::string line = rfc4122::to_string(ids[i]);
+        switch(i % 11)
+        {
+            case 1: line[5] = 'g'; expected_valid[i] = false; break;
+            case 3: line[23] = 'f'; expected_valid[i] = false; break;
+            case 4: line.pop_back(); expected_valid[i] = false; break;
+            case 6: for(auto& symbol: line) symbol = static_cast<char>(std::toupper(symbol)); break;
+            case 7: line += '\r'; break;
+            case 9: line[35] = '/'; expected_valid[i] = false; break;
+            default: break;
+        }
+        text += line;
+        if(i + 1 < std::size(ids)) text += '\n';
+    }
+
+    const instruction_set kernels[] = {instruction_set::scalar, instruction_set::ssse3, instruction_set::avx2};
+    for(const auto kernel: kernels)
+    {
+        if(detected_instruction_set() < kernel) continue;
+
+        std::vector<rfc4122::uuid> actual(std::size(ids), "ffffffff-ffff-ffff-ffff-ffffffffffff"_uuid);
+        std::vector<uint64_t> validity(rfc4122::validity_size(std::size(ids)), ~uint64_t{0});
+        const auto result = from_literals(kernel, text, actual, validity, '\n');
+        EXPECT_EQ(std::size(ids), result.count);
+        EXPECT_EQ(std::size(text), result.consumed);
+        EXPECT_EQ(static_cast<size_t>(std::count(std::begin(expected_valid), std::end(expected_valid), false)), result.invalid);
+        for(size_t i = 0; i < std::size(ids); ++i)
+        {
+            const bool valid = 0u != (validity[i / 64] & (uint64_t{1} << (i % 64)));
+            EXPECT_EQ(expected_valid[i], valid) << i;
+            EXPECT_EQ(rfc4122::to_string(expected_valid[i] ? ids[i] : rfc4122::NIL_UUID), rfc4122::to_string(actual[i])) << i;
+        }
+    }
+}
+
+// One bad record first, so that every pair of good ones after it straddles
+// two validity words once.
+TEST(Batch, from_literals_pair_across_words)
+{
+    using namespace rfc4122::__internal;
+
+    const auto ids = random_ids(131);
+    std::string text = "not an id\n";
+    for(size_t i = 1; i < std::size(ids); ++i) text += rfc4122::to_string(ids[i]) + "\n";
+
+    const instruction_set kernels[] = {instruction_set::scalar, instruction_set::ssse3, instruction_set::avx2};
+    for(const auto kernel: kernels)
+    {
+        if(detected_instruction_set() < kernel) continue;
+
+        std::vector<rfc4122::uuid> actual(std::size(ids));
+        std::vector<uint64_t> validity(rfc4122::validity_size(std::size(ids)));
+        const auto result = from_literals(kernel, text, actual, validity, '\n');
+        EXPECT_EQ(std::size(ids), result.count);
+        EXPECT_EQ(1u, result.invalid);
+        EXPECT_EQ(~uint64_t{1}, validity[0]);
+        EXPECT_EQ(~uint64_t{0}, validity[1]);
+        EXPECT_EQ(0b111u, validity[2]);
+    }
+}
+
+TEST(Batch, from_literals)
+{
+    const auto ids = random_ids(100);
+    std::string text;
+    for(const auto& id: ids) text += rfc4122::to_string(id) + "\n";
+
+    {
+        // Parsing resumes from `consumed` once ids are full.
+        std::vector<rfc4122::uuid> actual(64);
+        std::vector<uint64_t> validity(1);
+        const auto first = rfc4122::from_literals(text, actual, validity);
+        EXPECT_EQ(64u, first.count);
+        EXPECT_EQ(0u, first.invalid);
+        EXPECT_EQ(64u * (rfc4122::UUID_STRING_LENGTH + 1u), first.consumed);
+        EXPECT_EQ(~uint64_t{0}, validity[0]);
+
+        const auto second = rfc4122::from_literals(std::string_view{text}.substr(first.consumed), actual, validity);
+        EXPECT_EQ(36u, second.count);
+        EXPECT_EQ(std::size(text), first.consumed + second.consumed);
+        EXPECT_EQ(rfc4122::to_string(ids[99]), rfc4122::to_string(actual[35]));
+    }
+    {
+        std::vector<rfc4122::uuid> actual(3);
+        std::vector<uint64_t> validity(1);
+        const auto result = rfc4122::from_literals("\n" + rfc4122::to_string(ids[0]) + "\n\n", actual, validity);
+        EXPECT_EQ(3u, result.count);
+        EXPECT_EQ(2u, result.invalid);
+        EXPECT_EQ(0b010u, validity[0]);
+    }
+}
@@ -0,0 +1,120 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <rfc4122/column.h>
+
+
+
+namespace
+{
+
+void expect_same(const std::vector<rfc4122::uuid>& expected, const rfc4122::sorted_column& column)
+{
+    ASSERT_EQ(std::size(expected), std::size(column));
+    EXPECT_TRUE(std::equal(std::begin(expected), std::end(expected), std::begin(column), std::end(column)));
+    for(size_t i = 0; i < std::size(expected); i += 7u)
+    {
+        EXPECT_TRUE(column.contains(expected[i]));
+        EXPECT_EQ(expected[i], *column.lower_bound(expected[i]));
+    }
+}
+
+} // namespace
+
+TEST(Column, round_trip)
+{
+    // Random ids give long deltas, v7 ids short ones, duplicates none.
+    std::vector<rfc4122::uuid> ids(10000);
+    rfc4122::generate_n(std::span{ids}.first(5000));
+    rfc4122::generate_unix_time_n(std::span{ids}.subspan(5000));
+    ids.push_back(ids[17]);
+    ids.push_back(rfc4122::NIL_UUID);
+    ids.push_back({~uint64_t{0}, ~uint64_t{0}});
+
+    const rfc4122::sorted_column column{ids};
+    std::sort(std::begin(ids), std::end(ids));
+    ids.erase(std::unique(std::begin(ids), std::end(ids)), std::end(ids));
+    expect_same(ids, column);
+    EXPECT_GT(std::size(ids) * sizeof(rfc4122::uuid), std::size(column.bytes()));
+
+    std::vector<rfc4122::uuid> absent(1000);
+    rfc4122::generate_n(absent);
+    for(const auto& id: absent)
+    {
+        EXPECT_FALSE(column.contains(id));
+        const auto expected = std::lower_bound(std::begin(ids), std::end(ids), id);
+        const auto found = column.lower_bound(id);
+        ASSERT_EQ(std::end(ids) == expected, column.end() == found);
+        if(std::end(ids) != expected)
+        {
+            EXPECT_EQ(*expected, *found);
+        }
+    }
+
+    const auto path = std::filesystem::temp_directory_path() / ("rfc4122_" + std::to_string(::getpid()) + "column");
+    column.save(path);
+    {
+        rfc4122::sorted_column mapped{path};
+        expect_same(ids, mapped);
+        const rfc4122::sorted_column moved{std::move(mapped)};
+        expect_same(ids, moved);
+    }
+    std::ofstream{path, std::ios::app} << "x";
+    EXPECT_THROW(rfc4122::sorted_column{path}, std::system_error);
+    std::filesystem::remove(path);
+
+    const rfc4122::sorted_column none{std::span<const rfc4122::uuid>{}};
+    EXPECT_TRUE(none.empty());
+    EXPECT_TRUE(none.begin() == none.end());
+    EXPECT_FALSE(none.contains(rfc4122::NIL_UUID));
+}
+
+TEST(Column, scattered_bits)
+{
+    // Ids that differ in every other bit only, more runs of varying bits
+    // than the header keeps.
+    std::vector<rfc4122::uuid> ids;
+    for(uint64_t i = 0; i < 5000u; ++i)
+    {
+        uint64_t spread = 0u;
+        for(size_t bit = 0; bit < 16u; ++bit) spread |= ((i >> bit) & 1u) << (2u * bit);
+        ids.push_back({0x0123456789abcdefu ^ (spread << 7), 0xfedcba9876543210u ^ spread});
+    }
+    const rfc4122::sorted_column column{ids};
+    std::sort(std::begin(ids), std::end(ids));
+    expect_same(ids, column);
+    EXPECT_FALSE(column.contains({0x0123456789abcdefu, 0xfedcba9876543211u}));
+}
+
+TEST(Column, block_past_payload)
+{
+    std::vector<rfc4122::uuid> ids;
+    for(uint64_t i = 0; i < 1000u; ++i) ids.push_back({0u, i});
+    const rfc4122::sorted_column column{ids};
+    std::vector<char> image(std::size(column.bytes()));
+    std::memcpy(std::data(image), std::data(column.bytes()), std::size(image));
+
+    // The last block claims deltas of 128 bits, far more than the payload holds.
+    const size_t blocks = (std::size(ids) + rfc4122::sorted_column::BLOCK_SIZE - 1u) / rfc4122::sorted_column::BLOCK_SIZE;
+    // A 64-octet header, the first id of each block, then the offsets.
+    const size_t index = 64u + blocks * sizeof(rfc4122::uuid);
+    uint64_t last = 0u;
+    std::memcpy(&last, std::data(image) + index + (blocks - 1u) * sizeof(uint64_t), sizeof(last));
+    image[index + blocks * sizeof(uint64_t) + last] = static_cast<char>(128);
+
+    const auto path = std::filesystem::temp_directory_path() / ("rfc4122_" + std::to_string(::getpid()) + "column_past");
+    std::ofstream{path, std::ios::binary}.write(std::data(image), static_cast<std::streamsize>(std::size(image)));
+    EXPECT_THROW(rfc4122::sorted_column{path}, std::system_error);
+    std::filesystem::remove(path);
+}
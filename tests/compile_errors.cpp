@@ -0,0 +1,16 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+// Built by CTest with one of the macros below defined; each must fail to
+// compile, naming the function that explains why.
+
+#include <rfc4122/static_set.h>
+
+#if defined(UUID_MALFORMED_LITERAL)
+constexpr auto typo = "6ba7b810-9dad-11d1-80b4-00c04fd430cg"_uuid;
+#elif defined(UUID_SHORT_LITERAL)
+constexpr auto typo = u8"6ba7b810-9dad-11d1-80b4-00c04fd430c"_uuid;
+#elif defined(UUID_DUPLICATE_ID)
+constexpr rfc4122::static_uuid_set twice{{rfc4122::NAMESPACE_DNS, rfc4122::NAMESPACE_URL, rfc4122::NAMESPACE_DNS}};
+#endif
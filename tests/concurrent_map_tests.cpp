@@ -0,0 +1,141 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rfc4122/concurrent_map.h>
+
+
+
+TEST(ConcurrentMap, matches_unordered_map)
+{
+    std::vector<rfc4122::uuid> keys(5000);
+    rfc4122::generate_time_based_n(keys);
+
+    std::mt19937_64 random{42u};
+    rfc4122::concurrent_uuid_map<uint64_t> map{4};
+    std::unordered_map<rfc4122::uuid, uint64_t> expected;
+    EXPECT_EQ(4u, map.shards_count());
+    for(uint64_t i = 0; i < 100000u; ++i)
+    {
+        const auto& key = keys[random() % std::size(keys)];
+        switch(random() % 5u)
+        {
+            case 0:
+                EXPECT_EQ(expected.try_emplace(key, i).second, map.insert(key, i));
+                break;
+            case 1:
+                EXPECT_EQ(expected.insert_or_assign(key, i).second, map.insert_or_assign(key, i));
+                break;
+            case 2:
+                EXPECT_EQ(expected.erase(key) > 0u, map.erase(key));
+                break;
+            case 3:
+            {
+                const auto found = expected.find(key);
+                EXPECT_EQ(found != std::end(expected), map.update(key, [](uint64_t& value) {value += 7u;}));
+                if(found != std::end(expected)) found->second += 7u;
+                break;
+            }
+            default:
+            {
+                const auto found = expected.find(key);
+                const auto value = map.find(key);
+                ASSERT_EQ(found != std::end(expected), value.has_value());
+                if(value)
+                {
+                    EXPECT_EQ(found->second, *value);
+                }
+            }
+        }
+    }
+    EXPECT_EQ(std::size(expected), map.size());
+
+    size_t visited = 0u;
+    map.for_each([&](const rfc4122::uuid& key, const uint64_t value)
+    {
+        ++visited;
+        EXPECT_EQ(expected.at(key), value);
+    });
+    EXPECT_EQ(std::size(expected), visited);
+}
+
+TEST(ConcurrentMap, bits_hash)
+{
+    std::vector<rfc4122::uuid> keys(20000);
+    rfc4122::generate_n(keys);
+
+    rfc4122::concurrent_uuid_map<uint32_t, rfc4122::uuid_bits_hash> map{16};
+    for(uint32_t i = 0; i < std::size(keys); ++i) EXPECT_TRUE(map.insert(keys[i], i));
+    for(uint32_t i = 0; i < std::size(keys); i += 2) EXPECT_TRUE(map.erase(keys[i]));
+    EXPECT_EQ(std::size(keys) / 2u, map.size());
+    for(uint32_t i = 0; i < std::size(keys); ++i)
+    {
+        const auto value = map.find(keys[i]);
+        EXPECT_EQ(0u != i % 2u, value.has_value());
+        if(value)
+        {
+            EXPECT_EQ(i, *value);
+        }
+    }
+}
+
+// Writers keep every value equal to twice the low word of its key, so any
+// torn or stale-table read that slips through shows up as a mismatch.
+TEST(ConcurrentMap, readers_and_writers)
+{
+    struct entry
+    {
+        uint64_t half;
+        uint64_t twice;
+    };
+
+    std::vector<rfc4122::uuid> keys(4096);
+    rfc4122::generate_n(keys);
+    rfc4122::concurrent_uuid_map<entry> map{8};
+    for(size_t i = 0; i < std::size(keys); i += 2) map.insert(keys[i], {keys[i].low(), 2u * keys[i].low()});
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> torn{0u};
+    std::vector<std::thread> threads;
+    for(int reader = 0; reader < 3; ++reader)
+    {
+        threads.emplace_back([&, reader]
+        {
+            std::mt19937_64 random(reader);
+            while(!stop.load(std::memory_order_relaxed))
+            {
+                const auto& key = keys[random() % std::size(keys)];
+                const auto value = map.find(key);
+                if(value && (value->half != key.low() || value->twice != 2u * key.low())) torn.fetch_add(1u);
+            }
+        });
+    }
+    for(int writer = 0; writer < 2; ++writer)
+    {
+        threads.emplace_back([&, writer]
+        {
+            std::mt19937_64 random(100 + writer);
+            for(int i = 0; i < 200000; ++i)
+            {
+                const auto& key = keys[random() % std::size(keys)];
+                if(0u == random() % 2u) map.insert_or_assign(key, {key.low(), 2u * key.low()});
+                else                    map.erase(key);
+            }
+        });
+    }
+    for(size_t i = 3; i < std::size(threads); ++i) threads[i].join();
+    stop.store(true);
+    for(size_t i = 0; i < 3; ++i) threads[i].join();
+    EXPECT_EQ(0u, torn.load());
+
+    size_t visited = 0u;
+    map.for_each([&](const rfc4122::uuid&, const entry&) {++visited;});
+    EXPECT_EQ(visited, map.size());
+}
@@ -0,0 +1,191 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rfc4122/encoding.h>
+#include "random_ids.h"
+
+
+
+namespace
+{
+
+template<typename S>
+S widen(const std::string& text)
+{
+    return S(std::begin(text), std::end(text));
+}
+
+template<typename S>
+void expect_round_trip(const rfc4122::uuid& id)
+{
+    const auto base64url = rfc4122::to_base64url<S>(id);
+    const auto base32    = rfc4122::to_base32<S>(id);
+    EXPECT_EQ(widen<S>(rfc4122::to_base64url(id)), base64url);
+    EXPECT_EQ(widen<S>(rfc4122::to_base32(id)), base32);
+    EXPECT_EQ(rfc4122::to_string(id), rfc4122::to_string(rfc4122::from_base64url(std::data(base64url), std::size(base64url))));
+    EXPECT_EQ(rfc4122::to_string(id), rfc4122::to_string(rfc4122::from_base32(std::data(base32), std::size(base32))));
+}
+
+} // namespace
+
+TEST(Encoding, known_values)
+{
+    using namespace rfc4122;
+
+    EXPECT_EQ("AAAAAAAAAAAAAAAAAAAAAA", to_base64url(NIL_UUID));
+    EXPECT_EQ("00000000000000000000000000", to_base32(NIL_UUID));
+
+    const auto max = "ffffffff-ffff-ffff-ffff-ffffffffffff"_uuid;
+    EXPECT_EQ("_____________________w", to_base64url(max));
+    EXPECT_EQ("7ZZZZZZZZZZZZZZZZZZZZZZZZZ", to_base32(max));
+
+    // RFC 4122 example id: 6ba7b810 9dad 11d1 80b4 00c04fd430c8.
+    EXPECT_EQ("a6e4EJ2tEdGAtADAT9QwyA", to_base64url(NAMESPACE_DNS));
+    EXPECT_EQ("3BMYW117DD278R1D00R17X8C68", to_base32(NAMESPACE_DNS));
+    EXPECT_EQ(to_string(NAMESPACE_DNS), to_string(from_base32(std::u8string_view{u8"3bmyw117dd278r1d00r17x8c68"})));
+    EXPECT_EQ(to_string(NAMESPACE_DNS), to_string(from_base32(std::string_view{"3BMYWIL7DD278R1DO0R17X8C68"})));
+
+    constexpr auto decoded = from_base64url("a6e4EJ2tEdGAtADAT9QwyA", BASE64URL_LENGTH);
+    static_assert(decoded == NAMESPACE_DNS);
+}
+
+TEST(Encoding, round_trip)
+{
+    for(const auto& id: random_ids(100))
+    {
+        expect_round_trip<std::string   >(id);
+        expect_round_trip<std::u8string >(id);
+        expect_round_trip<std::wstring  >(id);
+        expect_round_trip<std::u16string>(id);
+        expect_round_trip<std::u32string>(id);
+    }
+}
+
+TEST(Encoding, order)
+{
+    auto ids = random_ids(100);
+    std::sort(std::begin(ids), std::end(ids));
+    for(size_t i = 1; i < std::size(ids); ++i)
+    {
+        EXPECT_LT(rfc4122::to_base32(ids[i - 1]), rfc4122::to_base32(ids[i]));
+    }
+}
+
+TEST(Encoding, invalid)
+{
+    using namespace rfc4122;
+
+    const std::string base64url = to_base64url(NAMESPACE_DNS);
+    const std::string base32    = to_base32(NAMESPACE_DNS);
+    EXPECT_TRUE(NIL_UUID == from_base64url(std::string_view{base64url}.substr(1)));
+    EXPECT_TRUE(NIL_UUID == from_base64url(std::string_view{base64url + "A"}));
+    EXPECT_TRUE(NIL_UUID == from_base64url(std::string_view{"a6e4EJ2tEdGAtADAT9Qwy+"}));
+    EXPECT_TRUE(NIL_UUID == from_base64url(std::string_view{"a6e4EJ2tEdGAtADAT9QwyB"}));
+    EXPECT_TRUE(NIL_UUID == from_base32(std::string_view{base32}.substr(1)));
+    EXPECT_TRUE(NIL_UUID == from_base32(std::string_view{"8BMYW117DD278R1D00R17X8C68"}));
+    EXPECT_TRUE(NIL_UUID == from_base32(std::string_view{"3BMYW117DD278R1D00R17X8CU8"}));
+    EXPECT_TRUE(NIL_UUID == from_base32(std::u32string_view{U"3BMYW117DD278R1D00R17X8C6ĸ"}));
+}
+
+TEST(Encoding, encode_n_kernels)
+{
+    using namespace rfc4122;
+    using namespace rfc4122::__internal;
+
+    const instruction_set kernels[] = {instruction_set::scalar, instruction_set::ssse3, instruction_set::avx2};
+    for(const auto encoding: {text_encoding::base64url, text_encoding::base32})
+    {
+        for(const auto kernel: kernels)
+        {
+            if(detected_instruction_set() < kernel) continue;
+            for(const size_t count: {0u, 1u, 2u, 3u, 17u, 256u})
+            {
+                const auto ids = random_ids(count);
+                std::string expected;
+                for(const auto& id: ids)
+                {
+                    expected += text_encoding::base64url == encoding ? to_base64url(id) : to_base32(id);
+                    expected += '\n';
+                }
+
+                std::string actual(encoded_size(encoding, count, true), '?');
+                __internal::encode_n(kernel, encoding, ids, std::data(actual), '\n');
+                EXPECT_EQ(expected, actual);
+
+                expected.erase(std::remove(std::begin(expected), std::end(expected), '\n'), std::end(expected));
+                actual.assign(encoded_size(encoding, count, false), '?');
+                __internal::encode_n(kernel, encoding, ids, std::data(actual), std::nullopt);
+                EXPECT_EQ(expected, actual);
+            }
+        }
+    }
+}
+
+TEST(Encoding, encode_n)
+{
+    using namespace rfc4122;
+
+    const auto ids = random_ids(5);
+    std::u16string actual(encoded_size(text_encoding::base32, std::size(ids), true) + 3, u'?');
+    const auto written = encode_n(text_encoding::base32, ids, std::span<char16_t>{actual}, u',');
+    EXPECT_EQ(encoded_size(text_encoding::base32, std::size(ids), true), written);
+    std::u16string expected;
+    for(const auto& id: ids) expected += to_base32<std::u16string>(id) + u',';
+    EXPECT_EQ(expected + u"???", actual);
+}
+
+TEST(Encoding, decode_n_kernels)
+{
+    using namespace rfc4122;
+    using namespace rfc4122::__internal;
+
+    const auto ids = random_ids(203);
+    const instruction_set kernels[] = {instruction_set::scalar, instruction_set::ssse3, instruction_set::avx2};
+    for(const auto encoding: {text_encoding::base64url, text_encoding::base32})
+    {
+        std::vector<bool> expected_valid(std::size(ids), true);
+        std::string text;
+        for(size_t i = 0; i < std::size(ids); ++i)
+        {
+            std::string line = text_encoding::base64url == encoding ? to_base64url(ids[i]) : to_base32(ids[i]);
+            switch(i % 11)
+            {
+                case 1: line[5] = '='; expected_valid[i] = false; break;
+                case 3: line[0] = text_encoding::base64url == encoding ? '+' : '8'; expected_valid[i] = false; break;
+                case 4: line.pop_back(); expected_valid[i] = false; break;
+                case 5: line.back() = text_encoding::base64url == encoding ? 'B' : 'U'; expected_valid[i] = false; break;
+                case 6: if(text_encoding::base32 == encoding) for(auto& symbol: line) symbol = static_cast<char>(std::tolower(symbol)); break;
+                case 7: line += '\r'; break;
+                case 9: line[17] = '\0'; expected_valid[i] = false; break;
+                default: break;
+            }
+            text += line;
+            if(i + 1 < std::size(ids)) text += '\n';
+        }
+
+        for(const auto kernel: kernels)
+        {
+            if(detected_instruction_set() < kernel) continue;
+
+            std::vector<uuid> actual(std::size(ids), "ffffffff-ffff-ffff-ffff-ffffffffffff"_uuid);
+            std::vector<uint64_t> validity(validity_size(std::size(ids)), ~uint64_t{0});
+            const auto result = __internal::decode_n(kernel, encoding, text, actual, validity, '\n');
+            EXPECT_EQ(std::size(ids), result.count);
+            EXPECT_EQ(std::size(text), result.consumed);
+            EXPECT_EQ(static_cast<size_t>(std::count(std::begin(expected_valid), std::end(expected_valid), false)), result.invalid);
+            for(size_t i = 0; i < std::size(ids); ++i)
+            {
+                const bool valid = 0u != (validity[i / 64] & (uint64_t{1} << (i % 64)));
+                EXPECT_EQ(expected_valid[i], valid) << i;
+                EXPECT_EQ(to_string(expected_valid[i] ? ids[i] : NIL_UUID), to_string(actual[i])) << i;
+            }
+        }
+    }
+}
@@ -0,0 +1,138 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rfc4122/fields.h>
+
+
+
+namespace
+{
+
+using rfc4122::__internal::instruction_set;
+using rfc4122::__internal::detected_instruction_set;
+
+// Every version, and random octets for all variants and odd versions.
+std::vector<rfc4122::uuid> mixed_ids(const size_t count)
+{
+    std::vector<rfc4122::uuid> ids(count);
+    std::mt19937_64 random{count};
+    for(size_t i = 0; i < count; ++i)
+    {
+        switch(i % 5u)
+        {
+            case 0 : ids[i] = rfc4122::generate_time_based_uuid(); break;
+            case 1 : ids[i] = rfc4122::generate_reordered_time_uuid(); break;
+            case 2 : ids[i] = rfc4122::generate_unix_time_uuid(); break;
+            case 3 : ids[i] = rfc4122::generate_uuid(); break;
+            default:
+            {
+                const uint64_t high = random();
+                ids[i] = rfc4122::uuid{high, random()};
+            }
+        }
+    }
+    return ids;
+}
+
+} // namespace
+
+TEST(Fields, extract)
+{
+    for(const size_t count: {0u, 1u, 3u, 4u, 7u, 1000u})
+    {
+        const auto ids = mixed_ids(count);
+        for(const auto kernel: {instruction_set::scalar, instruction_set::avx2})
+        {
+            if(detected_instruction_set() < kernel) continue;
+            std::vector<rfc4122::uuid_time_point> times(count);
+            std::vector<uint16_t> clock_sequences(count);
+            std::vector<uint64_t> nodes(count);
+            std::vector<rfc4122::version> versions(count);
+            std::vector<rfc4122::variant> variants(count);
+            rfc4122::__internal::extract_fields(kernel, ids, {times, clock_sequences, nodes, versions, variants});
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const auto& id = ids[i];
+                const auto time = rfc4122::to_time_point(id);
+                if(time)
+                {
+                    EXPECT_EQ(*time, std::chrono::time_point_cast<std::chrono::system_clock::duration>(times[i]));
+                }
+                else     EXPECT_EQ(rfc4122::uuid_time_point::min(), times[i]);
+                EXPECT_EQ(id.clock_sequence(), clock_sequences[i]);
+                EXPECT_EQ(id.node(), nodes[i]);
+                EXPECT_EQ(id.version(), versions[i]);
+                EXPECT_EQ(id.variant(), variants[i]);
+            }
+        }
+    }
+}
+
+TEST(Fields, extract_some)
+{
+    const auto ids = mixed_ids(9);
+    std::vector<uint64_t> nodes(std::size(ids));
+    rfc4122::extract_fields(ids, {.times = {}, .clock_sequences = {}, .nodes = nodes, .versions = {}, .variants = {}});
+    for(size_t i = 0; i < std::size(ids); ++i) EXPECT_EQ(ids[i].node(), nodes[i]);
+}
+
+TEST(Fields, reordered_time)
+{
+    const auto id = rfc4122::generate_time_based_uuid();
+    const auto reordered = rfc4122::to_reordered_time(id);
+    EXPECT_EQ(rfc4122::version::reordered_time, reordered.version());
+    EXPECT_EQ(id.timestamp(), reordered.reordered_timestamp());
+    EXPECT_EQ(id.clock_sequence(), reordered.clock_sequence());
+    EXPECT_EQ(id.node(), reordered.node());
+    EXPECT_EQ(id.variant(), reordered.variant());
+    EXPECT_EQ(rfc4122::to_time_point(id), rfc4122::to_time_point(reordered));
+    EXPECT_TRUE(id == rfc4122::to_time_based(reordered));
+
+    const auto random = rfc4122::generate_uuid();
+    EXPECT_TRUE(random == rfc4122::to_reordered_time(random));
+    EXPECT_TRUE(random == rfc4122::to_time_based(random));
+
+    static_assert(rfc4122::version::reordered_time == rfc4122::to_reordered_time("c232ab00-9414-11ec-b3c8-9f6bdeced846"_uuid).version());
+}
+
+TEST(Fields, convert_n)
+{
+    for(const size_t count: {0u, 1u, 2u, 5u, 1000u})
+    {
+        const auto ids = mixed_ids(count);
+        for(const auto kernel: {instruction_set::scalar, instruction_set::avx2})
+        {
+            if(detected_instruction_set() < kernel) continue;
+            auto converted = ids;
+            const auto time_based = static_cast<size_t>(std::count_if(std::begin(ids), std::end(ids), [](const auto& id) {return rfc4122::version::time_based == id.version();}));
+            EXPECT_EQ(time_based, rfc4122::__internal::convert_time_layout(kernel, converted, rfc4122::version::time_based, rfc4122::version::reordered_time));
+            for(size_t i = 0; i < count; ++i) EXPECT_TRUE(rfc4122::to_reordered_time(ids[i]) == converted[i]);
+
+            const auto reordered = static_cast<size_t>(std::count_if(std::begin(converted), std::end(converted), [](const auto& id) {return rfc4122::version::reordered_time == id.version();}));
+            EXPECT_EQ(reordered, rfc4122::__internal::convert_time_layout(kernel, converted, rfc4122::version::reordered_time, rfc4122::version::time_based));
+            for(size_t i = 0; i < count; ++i) EXPECT_TRUE(rfc4122::to_time_based(rfc4122::to_reordered_time(ids[i])) == converted[i]);
+        }
+    }
+}
+
+// Converted ids sort by time, which time-based ones do not.
+TEST(Fields, converted_sort_by_time)
+{
+    std::vector<rfc4122::uuid> ids(2000);
+    rfc4122::generate_time_based_n(ids);
+    std::shuffle(std::begin(ids), std::end(ids), std::mt19937_64{7u});
+    EXPECT_EQ(std::size(ids), rfc4122::to_reordered_time_n(ids));
+    std::sort(std::begin(ids), std::end(ids));
+    EXPECT_TRUE(std::is_sorted(std::begin(ids), std::end(ids), [](const auto& left, const auto& right)
+    {
+        return left.reordered_timestamp() < right.reordered_timestamp();
+    }));
+}
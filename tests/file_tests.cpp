@@ -0,0 +1,164 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <rfc4122/file.h>
+#include "random_ids.h"
+
+
+
+namespace
+{
+
+std::filesystem::path temp_path(const char* const name)
+{
+    return std::filesystem::temp_directory_path() / (std::string{"rfc4122_"} + std::to_string(::getpid()) + name);
+}
+
+std::string read_all(const std::filesystem::path& path)
+{
+    std::ifstream input{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+}
+
+// What async_text_writer should produce for `ids` in `layout`.
+std::string expected_text(const std::vector<rfc4122::uuid>& ids, const rfc4122::text_layout layout)
+{
+    std::string text = rfc4122::text_layout::json_array == layout ? "[" : "";
+    for(size_t i = 0; i < std::size(ids); ++i)
+    {
+        switch(layout)
+        {
+            case rfc4122::text_layout::lines     : text += rfc4122::to_string(ids[i]) + "\n"; break;
+            case rfc4122::text_layout::csv       : text += (i ? "," : "") + rfc4122::to_string(ids[i]); break;
+            case rfc4122::text_layout::json_array: text += (i ? ",\"" : "\"") + rfc4122::to_string(ids[i]) + "\""; break;
+        }
+    }
+    if(rfc4122::text_layout::csv == layout && !std::empty(ids)) text += "\n";
+    if(rfc4122::text_layout::json_array == layout) text += "]\n";
+    return text;
+}
+
+} // namespace
+
+TEST(File, binary)
+{
+    const auto path = temp_path("binary");
+    const auto ids  = random_ids(10000);
+    {
+        rfc4122::binary_writer writer{path, 4096};
+        writer.write(std::span{ids}.first(3));
+        writer.write(std::span{ids}.subspan(3));
+        writer.close();
+    }
+    EXPECT_EQ(sizeof(rfc4122::uuid) * std::size(ids), std::filesystem::file_size(path));
+    {
+        const rfc4122::binary_reader reader{path};
+        const auto mapped = reader.ids();
+        ASSERT_EQ(std::size(ids), std::size(mapped));
+        EXPECT_EQ(0, std::memcmp(std::data(ids), std::data(mapped), std::size(ids) * sizeof(rfc4122::uuid)));
+    }
+    {
+        std::ofstream{path, std::ios::app} << "x";
+        EXPECT_THROW(rfc4122::binary_reader{path}, std::system_error);
+    }
+    std::filesystem::remove(path);
+    EXPECT_THROW(rfc4122::binary_reader{path}, std::system_error);
+}
+
+TEST(File, text)
+{
+    const auto path = temp_path("text");
+    const auto ids  = random_ids(1000);
+    {
+        rfc4122::text_writer writer{path};
+        writer.write(ids);
+    }
+    EXPECT_EQ(rfc4122::literals_size(std::size(ids), true), std::filesystem::file_size(path));
+
+    rfc4122::text_reader reader{path};
+    std::vector<rfc4122::uuid> actual;
+    std::vector<rfc4122::uuid> chunk(300);
+    std::vector<uint64_t> validity(rfc4122::validity_size(std::size(chunk)));
+    while(!reader.eof())
+    {
+        const auto result = reader.read(chunk, validity);
+        EXPECT_EQ(0u, result.invalid);
+        actual.insert(std::end(actual), std::begin(chunk), std::begin(chunk) + result.count);
+    }
+    ASSERT_EQ(std::size(ids), std::size(actual));
+    EXPECT_EQ(0, std::memcmp(std::data(ids), std::data(actual), std::size(ids) * sizeof(rfc4122::uuid)));
+    std::filesystem::remove(path);
+}
+
+TEST(File, empty)
+{
+    const auto path = temp_path("empty");
+    rfc4122::binary_writer{path}.close();
+    EXPECT_TRUE(std::empty(rfc4122::binary_reader{path}.ids()));
+    EXPECT_TRUE(rfc4122::text_reader{path}.eof());
+    std::filesystem::remove(path);
+}
+
+TEST(File, async_text_writer)
+{
+    using rfc4122::text_layout;
+
+    const auto path = temp_path("async");
+    for(const auto layout: {text_layout::lines, text_layout::csv, text_layout::json_array})
+    {
+        for(const size_t count: {0u, 1u, 3000u})
+        {
+            const auto ids = random_ids(count);
+            const int descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            ASSERT_LE(0, descriptor);
+            {
+                // Small buffers and odd spans, so records land on buffer edges.
+                rfc4122::async_text_writer writer{descriptor, {.layout = layout, .buffer_size = 4096, .buffers = 3}};
+                for(size_t first = 0; first < count; first += 7u)
+                {
+                    writer.write(std::span{ids}.subspan(first, std::min<size_t>(7u, count - first)));
+                }
+                writer.finish();
+
+                const auto metrics = writer.metrics();
+                EXPECT_EQ(count, metrics.ids);
+                EXPECT_EQ(expected_text(ids, layout).size(), metrics.bytes);
+                EXPECT_EQ(0u == metrics.bytes, 0u == metrics.writes);
+            }
+            ::close(descriptor);
+            EXPECT_EQ(expected_text(ids, layout), read_all(path));
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(File, async_text_writer_error)
+{
+    const auto path = temp_path("async_error");
+    rfc4122::binary_writer{path}.close();
+    const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    ASSERT_LE(0, descriptor);
+    {
+        rfc4122::async_text_writer writer{descriptor};
+        writer.write(random_ids(10));
+        EXPECT_THROW(writer.flush(), std::system_error);
+        EXPECT_THROW(writer.write(random_ids(10)), std::system_error);
+        EXPECT_EQ(0u, writer.metrics().bytes);
+    }
+    ::close(descriptor);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,181 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <rfc4122/batch.h>
+#include <rfc4122/filter.h>
+
+
+
+namespace
+{
+
+std::vector<rfc4122::uuid> ids(const size_t count, const bool time_based)
+{
+    std::vector<rfc4122::uuid> generated(count);
+    if(time_based) rfc4122::generate_time_based_n(generated);
+    else           rfc4122::generate_n(generated);
+    return generated;
+}
+
+template<typename F>
+double false_positive_rate(const F& filter, const size_t probes)
+{
+    size_t positives = 0u;
+    for(const auto& id: ids(probes, false)) positives += filter.may_contain(id);
+    return static_cast<double>(positives) / static_cast<double>(probes);
+}
+
+template<typename F>
+void expect_kernels_agree(const F& filter, const std::vector<rfc4122::uuid>& keys)
+{
+    using namespace rfc4122::__internal;
+
+    std::vector<uint64_t> expected(rfc4122::validity_size(std::size(keys)));
+    size_t expected_count = 0u;
+    for(size_t i = 0; i < std::size(keys); ++i)
+    {
+        const bool maybe = filter.may_contain(keys[i]);
+        expected[i / 64] |= uint64_t{maybe} << (i % 64);
+        expected_count += maybe;
+    }
+    for(const auto kernel: {instruction_set::scalar, instruction_set::ssse3, instruction_set::avx2})
+    {
+        if(detected_instruction_set() < kernel) continue;
+        std::vector<uint64_t> found(std::size(expected), ~uint64_t{0});
+        EXPECT_EQ(expected_count, may_contain_n(kernel, filter, keys, found));
+        EXPECT_EQ(expected, found);
+    }
+}
+
+std::filesystem::path temp_path(const char* const name)
+{
+    return std::filesystem::temp_directory_path() / ("rfc4122_" + std::to_string(::getpid()) + name);
+}
+
+} // namespace
+
+TEST(Filter, bloom)
+{
+    for(const auto keys: {rfc4122::filter_keys::random, rfc4122::filter_keys::any})
+    {
+        for(const double rate: {0.05, 0.01, 0.001})
+        {
+            rfc4122::blocked_bloom_filter filter{20000, rate, keys};
+            const auto inserted = ids(20000, rfc4122::filter_keys::any == keys);
+            EXPECT_TRUE(filter.insert(inserted));
+            EXPECT_EQ(std::size(inserted), filter.size());
+            for(const auto& id: inserted) EXPECT_TRUE(filter.may_contain(id));
+
+            const double measured = false_positive_rate(filter, 200000);
+            EXPECT_LT(measured, 1.5 * rate) << rate;
+            EXPECT_GT(measured, 0.5 * rate) << rate;
+        }
+    }
+}
+
+TEST(Filter, bloom_batch)
+{
+    rfc4122::blocked_bloom_filter filter{1000, 0.05, rfc4122::filter_keys::random};
+    auto keys = ids(1001, false);
+    filter.insert(std::span{keys}.first(500));
+    expect_kernels_agree(filter, keys);
+
+    std::vector<uint64_t> found(rfc4122::validity_size(std::size(keys)));
+    EXPECT_GE(filter.may_contain(keys, found), 500u);
+    EXPECT_EQ(~uint64_t{0}, found[0]);
+}
+
+TEST(Filter, cuckoo)
+{
+    for(const auto keys: {rfc4122::filter_keys::random, rfc4122::filter_keys::any})
+    {
+        rfc4122::cuckoo_filter filter{20000, keys};
+        const auto inserted = ids(20000, rfc4122::filter_keys::any == keys);
+        for(const auto& id: inserted) EXPECT_TRUE(filter.insert(id));
+        EXPECT_EQ(std::size(inserted), filter.size());
+        for(const auto& id: inserted) EXPECT_TRUE(filter.may_contain(id));
+        EXPECT_LT(false_positive_rate(filter, 200000), 4e-4);
+
+        // Twice inserted, twice erased.
+        EXPECT_TRUE(filter.insert(inserted[0]));
+        for(size_t i = 0; i < std::size(inserted); i += 2) EXPECT_TRUE(filter.erase(inserted[i]));
+        EXPECT_TRUE(filter.may_contain(inserted[0]));
+        EXPECT_TRUE(filter.erase(inserted[0]));
+        for(size_t i = 1; i < std::size(inserted); i += 2) EXPECT_TRUE(filter.may_contain(inserted[i]));
+        size_t left = 0u;
+        for(size_t i = 0; i < std::size(inserted); i += 2) left += filter.may_contain(inserted[i]);
+        EXPECT_LT(left, 10u);
+        EXPECT_EQ(std::size(inserted) / 2u, filter.size());
+    }
+}
+
+TEST(Filter, cuckoo_full)
+{
+    rfc4122::cuckoo_filter filter{1000, rfc4122::filter_keys::random};
+    const auto inserted = ids(4 * filter.buckets() + 1, false);
+    size_t accepted = 0u;
+    while(accepted < std::size(inserted) && filter.insert(inserted[accepted])) ++accepted;
+    EXPECT_LT(accepted, std::size(inserted));
+    EXPECT_GT(accepted, 9u * std::size(inserted) / 10u);
+    for(size_t i = 0; i < accepted; ++i) EXPECT_TRUE(filter.may_contain(inserted[i])) << i;
+    expect_kernels_agree(filter, inserted);
+
+    // Room again once some are gone.
+    for(size_t i = 0; i < accepted; i += 8) EXPECT_TRUE(filter.erase(inserted[i]));
+    EXPECT_TRUE(filter.insert(inserted[0]));
+    // The last one that was not erased.
+    const size_t kept = 0u != (accepted - 1u) % 8u ? accepted - 1u : accepted - 2u;
+    EXPECT_TRUE(filter.may_contain(inserted[kept]));
+}
+
+TEST(Filter, save)
+{
+    const auto inserted = ids(5000, false);
+    rfc4122::blocked_bloom_filter bloom{5000, 0.01, rfc4122::filter_keys::random};
+    rfc4122::cuckoo_filter cuckoo{5000};
+    bloom.insert(inserted);
+    for(const auto& id: inserted) cuckoo.insert(id);
+
+    const auto bloom_path  = temp_path("bloom");
+    const auto cuckoo_path = temp_path("cuckoo");
+    bloom.save(bloom_path);
+    cuckoo.save(cuckoo_path);
+    {
+        const rfc4122::blocked_bloom_filter mapped_bloom{bloom_path};
+        rfc4122::cuckoo_filter mapped_cuckoo{cuckoo_path};
+        EXPECT_EQ(bloom.blocks(), mapped_bloom.blocks());
+        EXPECT_EQ(std::size(inserted), mapped_bloom.size());
+        EXPECT_EQ(std::size(inserted), mapped_cuckoo.size());
+        EXPECT_TRUE(rfc4122::filter_keys::random == mapped_bloom.keys());
+        EXPECT_TRUE(rfc4122::filter_keys::any == mapped_cuckoo.keys());
+        for(const auto& id: inserted)
+        {
+            EXPECT_TRUE(mapped_bloom.may_contain(id));
+            EXPECT_TRUE(mapped_cuckoo.may_contain(id));
+        }
+        const auto probes = ids(1000, false);
+        for(const auto& id: probes)
+        {
+            EXPECT_EQ(bloom.may_contain(id), mapped_bloom.may_contain(id));
+            EXPECT_EQ(cuckoo.may_contain(id), mapped_cuckoo.may_contain(id));
+        }
+        expect_kernels_agree(mapped_bloom, probes);
+        EXPECT_FALSE(mapped_cuckoo.insert(probes[0]));
+        EXPECT_FALSE(mapped_cuckoo.erase(inserted[0]));
+    }
+
+    std::ofstream{bloom_path, std::ios::app} << "x";
+    EXPECT_THROW(rfc4122::blocked_bloom_filter{bloom_path}, std::system_error);
+    EXPECT_THROW(rfc4122::cuckoo_filter{bloom_path}, std::system_error);
+    std::filesystem::remove(bloom_path);
+    std::filesystem::remove(cuckoo_path);
+}
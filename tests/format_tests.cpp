@@ -0,0 +1,143 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+#include <rfc4122/format.h>
+
+
+
+namespace
+{
+
+std::string formatted(const rfc4122::uuid& id, const rfc4122::literal_format format)
+{
+    char buffer[rfc4122::MAX_FORMATTED_LENGTH];
+    const auto end = rfc4122::format_to(buffer, id, format);
+    EXPECT_EQ(rfc4122::formatted_size(format), static_cast<size_t>(end - buffer));
+    return {buffer, end};
+}
+
+} // namespace
+
+TEST(Format, format_to)
+{
+    using namespace rfc4122;
+
+    const auto id = "6ba7b810-9dad-11d1-80b4-00c04fd430c8"_uuid;
+    EXPECT_EQ(to_string(id), formatted(id, {}));
+    EXPECT_EQ("6BA7B810-9DAD-11D1-80B4-00C04FD430C8", formatted(id, {.upper_case = true}));
+    EXPECT_EQ("6ba7b8109dad11d180b400c04fd430c8", formatted(id, {.hyphens = false}));
+    EXPECT_EQ("{6ba7b810-9dad-11d1-80b4-00c04fd430c8}", formatted(id, {.wrap = enclosure::braces}));
+    EXPECT_EQ("urn:uuid:6ba7b810-9dad-11d1-80b4-00c04fd430c8", formatted(id, {.wrap = enclosure::urn}));
+    EXPECT_EQ("{6BA7B8109DAD11D180B400C04FD430C8}", formatted(id, {true, false, enclosure::braces}));
+
+    char32_t wide[UUID_STRING_LENGTH];
+    format_to(wide, id);
+    EXPECT_EQ(to_u32string(id), std::u32string(wide, UUID_STRING_LENGTH));
+}
+
+TEST(Format, to_chars)
+{
+    using namespace rfc4122;
+
+    const auto id = "6ba7b810-9dad-11d1-80b4-00c04fd430c8"_uuid;
+    char buffer[64] = {};
+    const auto fits = to_chars(std::begin(buffer), std::end(buffer), id);
+    EXPECT_EQ(std::errc{}, fits.ec);
+    EXPECT_EQ(to_string(id), std::string_view(buffer, fits.ptr - buffer));
+
+    char small[UUID_STRING_LENGTH] = {};
+    const auto too_small = to_chars(std::begin(small), std::end(small), id, {.wrap = enclosure::braces});
+    EXPECT_EQ(std::errc::value_too_large, too_small.ec);
+    EXPECT_EQ(std::end(small), too_small.ptr);
+    EXPECT_EQ('\0', small[0]);
+}
+
+TEST(Format, parse_format)
+{
+    using namespace rfc4122;
+
+    const auto parse = [](const std::string_view spec, literal_format& format)
+    {
+        return static_cast<size_t>(parse_format(std::data(spec), std::data(spec) + std::size(spec), format) - std::data(spec));
+    };
+    literal_format format{};
+    EXPECT_EQ(3u, parse("Unr}", format));
+    EXPECT_TRUE(format.upper_case);
+    EXPECT_FALSE(format.hyphens);
+    EXPECT_EQ(enclosure::urn, format.wrap);
+
+    literal_format twice{};
+    EXPECT_EQ(1u, parse("bb", twice));
+    literal_format unknown{};
+    EXPECT_EQ(0u, parse("x", unknown));
+}
+
+#if defined(__cpp_lib_format)
+TEST(Format, formatter)
+{
+    const auto id = "6ba7b810-9dad-11d1-80b4-00c04fd430c8"_uuid;
+    EXPECT_EQ(rfc4122::to_string(id), std::format("{}", id));
+    EXPECT_EQ("id={6BA7B810-9DAD-11D1-80B4-00C04FD430C8}", std::format("id={:Ub}", id));
+    EXPECT_EQ(L"urn:uuid:6ba7b8109dad11d180b400c04fd430c8", std::format(L"{:nr}", id));
+}
+#endif
+
+TEST(Format, parse_literal)
+{
+    using namespace rfc4122;
+
+    const auto id = "6ba7b810-9dad-11d1-80b4-00c04fd430c8"_uuid;
+    const literal_format formats[] = 
+    {
+          {}
+        , {.upper_case = true}
+        , {.hyphens = false}
+        , {.wrap = enclosure::braces}
+        , {true, false, enclosure::braces}
+        , {.wrap = enclosure::urn}
+    };
+    for(const auto& format: formats)
+    {
+        const auto text = formatted(id, format);
+        const auto result = parse_literal(std::string_view{text});
+        ASSERT_TRUE(result) << text;
+        EXPECT_TRUE(id == *result) << text;
+        EXPECT_EQ(format.upper_case, result.format.upper_case) << text;
+        EXPECT_EQ(format.hyphens, result.format.hyphens) << text;
+        EXPECT_EQ(format.wrap, result.format.wrap) << text;
+    }
+    EXPECT_TRUE(parse_literal(std::u32string_view{U"URN:UUID:6ba7b810-9dad-11d1-80b4-00c04fd430c8"}));
+
+    constexpr auto parsed = parse_literal(std::string_view{"{6BA7B810-9DAD-11D1-80B4-00C04FD430C8}"});
+    static_assert(parsed && *parsed == NAMESPACE_DNS);
+}
+
+TEST(Format, parse_literal_errors)
+{
+    using namespace rfc4122;
+
+    const auto expect_error = [](const std::string_view text, const parse_error error, const size_t offset)
+    {
+        const auto result = parse_literal(text);
+        EXPECT_FALSE(result) << text;
+        EXPECT_EQ(error, result.error) << text;
+        EXPECT_EQ(offset, result.offset) << text;
+        EXPECT_TRUE(NIL_UUID == result.value_or(NIL_UUID)) << text;
+    };
+    expect_error("", parse_error::length, 0u);
+    expect_error("6ba7b810-9dad-11d1-80b4-00c04fd430c", parse_error::length, 0u);
+    expect_error("6ba7b810-9dad-11d1-80b4-00c04fd430cg", parse_error::digit, 35u);
+    expect_error("6ba7b810-9dad-11d1+80b4-00c04fd430c8", parse_error::separator, 18u);
+    expect_error("6ba7b8109dad11d1-0b400c04fd430c8", parse_error::digit, 16u);
+    expect_error("(6ba7b810-9dad-11d1-80b4-00c04fd430c8}", parse_error::separator, 0u);
+    expect_error("{6ba7b810-9dad-11d1-80b4-00c04fd430c8)", parse_error::separator, 37u);
+    expect_error("{6ba7b810-9dad-11d1-80b4-00c04fd430c8-}", parse_error::length, 0u);
+    expect_error("urn:uid::6ba7b810-9dad-11d1-80b4-00c04fd430c8", parse_error::separator, 5u);
+    expect_error("urn;uuid:6ba7b810-9dad-11d1-80b4-00c04fd430c8", parse_error::separator, 3u);
+    expect_error("urn:uuid:6ba7b810-9dad-11d1-80b4-00c04fd430c ", parse_error::digit, 44u);
+}
@@ -0,0 +1,149 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rfc4122/hash.h>
+#include <rfc4122/uuid.h>
+
+
+
+namespace
+{
+
+using rfc4122::__internal::digest;
+using rfc4122::__internal::hash_algorithm;
+using rfc4122::__internal::instruction_set;
+
+std::string to_hex(const digest& octets, const size_t length)
+{
+    std::string text;
+    char symbols[3];
+    for(size_t i = 0; i < length; ++i)
+    {
+        std::snprintf(symbols, sizeof(symbols), "%02x", octets[i]);
+        text += symbols;
+    }
+    return text;
+}
+
+std::vector<instruction_set> supported_kernels()
+{
+    std::vector<instruction_set> kernels{instruction_set::scalar};
+    if(rfc4122::__internal::detected_instruction_set() >= instruction_set::ssse3) kernels.push_back(instruction_set::ssse3);
+    if(rfc4122::__internal::detected_instruction_set() >= instruction_set::avx2 ) kernels.push_back(instruction_set::avx2);
+    return kernels;
+}
+
+struct vector
+{
+    hash_algorithm algorithm;
+    std::string message;
+    std::string expected;
+};
+
+const std::vector<vector>& vectors()
+{
+    static const std::vector<vector> known
+    {
+          {hash_algorithm::md5 , "",    "d41d8cd98f00b204e9800998ecf8427e"}
+        , {hash_algorithm::md5 , "abc", "900150983cd24fb0d6963f7d28e17f72"}
+        , {hash_algorithm::md5 , "12345678901234567890123456789012345678901234567890123456789012345678901234567890"
+                               , "57edf4a22be3c955ac49da2e2107b67a"}
+        , {hash_algorithm::sha1, "",    "da39a3ee5e6b4b0d3255bfef95601890afd80709"}
+        , {hash_algorithm::sha1, "abc", "a9993e364706816aba3e25717850c26c9cd0d89d"}
+        , {hash_algorithm::sha1, "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"
+                               , "84983e441c3bd26ebaae4aa1f95129e5e54670f1"}
+    };
+    return known;
+}
+
+} // namespace
+
+TEST(Hash, known_vectors)
+{
+    for(const auto kernel: supported_kernels())
+    {
+        for(const auto algorithm: {hash_algorithm::md5, hash_algorithm::sha1})
+        {
+            std::vector<std::string_view> messages;
+            std::vector<std::string> expected;
+            for(const auto& known: vectors())
+            {
+                if(known.algorithm != algorithm) continue;
+                messages.push_back(known.message);
+                expected.push_back(known.expected);
+            }
+            std::vector<digest> digests(std::size(messages));
+            rfc4122::__internal::hash_n(kernel, algorithm, {}, messages, digests);
+            const size_t length = hash_algorithm::md5 == algorithm ? 16u : 20u;
+            for(size_t i = 0; i < std::size(messages); ++i)
+            {
+                EXPECT_EQ(expected[i], to_hex(digests[i], length)) << static_cast<int>(kernel) << " '" << messages[i] << "'";
+            }
+        }
+    }
+}
+
+TEST(Hash, mixed_lengths)
+{
+    // Lengths around the 55/56/64 octet padding edges, several blocks long
+    // and in an order that makes lanes finish at different times.
+    std::vector<std::string> texts;
+    for(size_t length = 0; length < 200u; length += 7u)
+    {
+        texts.emplace_back(length, static_cast<char>('a' + length % 26u));
+        texts.emplace_back((length * 13u) % 150u, 'z');
+    }
+    const std::vector<std::string_view> messages(std::begin(texts), std::end(texts));
+    const std::string prefix = "name space";
+    const auto prefix_bytes = std::as_bytes(std::span{prefix});
+
+    for(const auto algorithm: {hash_algorithm::md5, hash_algorithm::sha1})
+    {
+        std::vector<digest> expected(std::size(messages));
+        for(size_t i = 0; i < std::size(messages); ++i)
+        {
+            rfc4122::__internal::hash_n(instruction_set::scalar, algorithm, prefix_bytes, std::span{&messages[i], 1u}, std::span{&expected[i], 1u});
+        }
+        for(const auto kernel: supported_kernels())
+        {
+            std::vector<digest> digests(std::size(messages));
+            rfc4122::__internal::hash_n(kernel, algorithm, prefix_bytes, messages, digests);
+            EXPECT_EQ(expected, digests) << static_cast<int>(kernel);
+        }
+    }
+}
+
+TEST(Generate, name_based)
+{
+    using namespace rfc4122;
+
+    const auto sha1 = generate_sha1_uuid(NAMESPACE_DNS, "python.org");
+    EXPECT_EQ("886313e1-3b8a-5372-9b90-0c9aee199e5d", to_string(sha1));
+    EXPECT_EQ(version::sha1_name, sha1.version());
+    EXPECT_EQ(variant::rfc4122, sha1.variant());
+
+    const auto md5 = generate_md5_uuid(NAMESPACE_DNS, "python.org");
+    EXPECT_EQ("6fa459ea-ee8a-3ca4-894e-db77e160355e", to_string(md5));
+    EXPECT_EQ(version::md5_name, md5.version());
+
+    std::vector<std::string> texts;
+    for(int i = 0; i < 300; ++i) texts.push_back("host-" + std::to_string(i) + ".example.com");
+    const std::vector<std::string_view> names(std::begin(texts), std::end(texts));
+    std::vector<uuid> ids(std::size(names));
+    generate_sha1_n(NAMESPACE_URL, names, ids);
+    for(size_t i = 0; i < std::size(names); ++i)
+    {
+        EXPECT_EQ(to_string(generate_sha1_uuid(NAMESPACE_URL, names[i])), to_string(ids[i]));
+    }
+    generate_md5_n(NAMESPACE_OID, names, ids);
+    for(size_t i = 0; i < std::size(names); ++i)
+    {
+        EXPECT_EQ(to_string(generate_md5_uuid(NAMESPACE_OID, names[i])), to_string(ids[i]));
+    }
+}
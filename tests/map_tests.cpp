@@ -0,0 +1,91 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rfc4122/map.h>
+
+
+
+TEST(Map, matches_unordered_map)
+{
+    std::vector<rfc4122::uuid> keys(5000);
+    rfc4122::generate_time_based_n(keys);
+
+    std::mt19937_64 random{42u};
+    rfc4122::uuid_map<std::string> map;
+    std::unordered_map<rfc4122::uuid, std::string> expected;
+    for(int i = 0; i < 100000; ++i)
+    {
+        const auto& key = keys[random() % std::size(keys)];
+        switch(random() % 4u)
+        {
+            case 0:
+            case 1:
+            {
+                const auto value = std::to_string(i);
+                const auto [entry, inserted] = map.try_emplace(key, value);
+                EXPECT_EQ(expected.try_emplace(key, value).second, inserted);
+                EXPECT_EQ(expected[key], *entry);
+                break;
+            }
+            case 2:
+                EXPECT_EQ(expected.erase(key) > 0u, map.erase(key));
+                break;
+            default:
+            {
+                const auto found = expected.find(key);
+                const auto* const value = map.find(key);
+                ASSERT_EQ(std::end(expected) != found, nullptr != value);
+                if(value)
+                {
+                    EXPECT_EQ(found->second, *value);
+                }
+            }
+        }
+        ASSERT_EQ(std::size(expected), std::size(map));
+    }
+
+    size_t visited = 0u;
+    map.for_each([&](const rfc4122::uuid& key, const std::string& value)
+    {
+        EXPECT_EQ(expected.at(key), value);
+        ++visited;
+    });
+    EXPECT_EQ(std::size(expected), visited);
+    EXPECT_GE(map.capacity() * 7u / 8u, std::size(map));
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(keys.front()));
+    map[keys.front()] = "again";
+    EXPECT_EQ("again", *map.find(keys.front()));
+}
+
+TEST(Map, set_and_raw_bits)
+{
+    std::vector<rfc4122::uuid> ids(20000);
+    rfc4122::generate_n(ids);
+
+    rfc4122::uuid_set<rfc4122::uuid_bits_hash> set(std::size(ids) / 2u);
+    const auto reserved = set.capacity();
+    for(size_t i = 0; i < std::size(ids) / 2u; ++i) EXPECT_TRUE(set.insert(ids[i]));
+    EXPECT_EQ(reserved, set.capacity());
+    for(size_t i = 0; i < std::size(ids) / 2u; ++i) EXPECT_FALSE(set.insert(ids[i]));
+    for(size_t i = 0; i < std::size(ids); ++i) EXPECT_EQ(i < std::size(ids) / 2u, set.contains(ids[i]));
+
+    // Tombstones left by erasing are reclaimed without unbounded growth.
+    for(size_t round = 0; round < 20u; ++round)
+    {
+        for(size_t i = 0; i < std::size(ids) / 2u; ++i) set.erase(ids[i]);
+        for(size_t i = 0; i < std::size(ids) / 2u; ++i) set.insert(ids[i]);
+    }
+    EXPECT_EQ(std::size(ids) / 2u, std::size(set));
+    EXPECT_GE(2u * reserved, set.capacity());
+    static_assert(16u == sizeof(rfc4122::__internal::flat_table<rfc4122::__internal::no_value, rfc4122::uuid_hash>::slot));
+}
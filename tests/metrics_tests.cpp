@@ -0,0 +1,116 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rfc4122/batch.h>
+#include <rfc4122/metrics.h>
+
+
+
+namespace
+{
+
+uint64_t calls(const rfc4122::metrics_snapshot& snapshot, const rfc4122::metered_operation operation)
+{
+    return snapshot.of(operation).calls;
+}
+
+uint64_t histogram_total(const rfc4122::operation_metrics& metrics)
+{
+    uint64_t total = 0u;
+    for(const auto count: metrics.latency) total += count;
+    return total;
+}
+
+} // namespace
+
+TEST(Metrics, counts_calls)
+{
+    using rfc4122::metered_operation;
+
+    const auto before = rfc4122::collect_metrics();
+    const auto id = rfc4122::generate_uuid();
+    std::vector<rfc4122::uuid> ids(100);
+    rfc4122::generate_n(ids);
+    const std::string text = rfc4122::to_string(id);
+    EXPECT_TRUE(id == rfc4122::from_string(std::string_view{text}));
+    EXPECT_TRUE(rfc4122::NIL_UUID == rfc4122::from_string("not an id"));
+    std::istringstream input{rfc4122::to_string(id) + " " + rfc4122::to_string(ids[0]) + " x"};
+    std::vector<rfc4122::uuid> parsed;
+    rfc4122::parse_all(input, std::back_inserter(parsed));
+    const auto after = rfc4122::collect_metrics();
+
+    if constexpr(!rfc4122::METRICS_ENABLED)
+    {
+        EXPECT_EQ(0u, calls(after, metered_operation::parse));
+        EXPECT_EQ(0u, calls(after, metered_operation::format));
+        EXPECT_EQ(0u, calls(after, metered_operation::generate));
+        EXPECT_TRUE(std::empty(after.threads));
+        return;
+    }
+    const auto& parse    = after.of(metered_operation::parse);
+    const auto& generate = after.of(metered_operation::generate);
+    EXPECT_EQ(2u, generate.calls - before.of(metered_operation::generate).calls);
+    EXPECT_EQ(101u, generate.ids - before.of(metered_operation::generate).ids);
+    EXPECT_EQ(3u, parse.calls - before.of(metered_operation::parse).calls);
+    EXPECT_EQ(4u, parse.ids - before.of(metered_operation::parse).ids);
+    EXPECT_EQ(2u, parse.failures - before.of(metered_operation::parse).failures);
+    EXPECT_EQ(3u, calls(after, metered_operation::format) - calls(before, metered_operation::format));
+    EXPECT_LE(histogram_total(parse), parse.calls);
+    ASSERT_FALSE(std::empty(after.threads));
+}
+
+TEST(Metrics, keeps_finished_threads)
+{
+    using rfc4122::metered_operation;
+
+    const auto before = rfc4122::collect_metrics();
+    std::thread worker{[]
+    {
+        std::vector<rfc4122::uuid> ids(1000);
+        rfc4122::generate_time_based_n(ids);
+        std::vector<char> text(rfc4122::literals_size(std::size(ids), true));
+        rfc4122::to_literals<char>(ids, text, '\n');
+    }};
+    worker.join();
+    const auto after = rfc4122::collect_metrics();
+
+    const uint64_t expected = rfc4122::METRICS_ENABLED ? 1000u : 0u;
+    EXPECT_EQ(expected, after.of(metered_operation::generate).ids - before.of(metered_operation::generate).ids);
+    EXPECT_EQ(expected, after.of(metered_operation::format).ids - before.of(metered_operation::format).ids);
+}
+
+TEST(Metrics, prometheus_text)
+{
+    rfc4122::metrics_snapshot snapshot{};
+    auto& parse = snapshot.operations[static_cast<size_t>(rfc4122::metered_operation::parse)];
+    parse.calls = 3u;
+    parse.ids = 3u;
+    parse.failures = 1u;
+    parse.latency_sum = std::chrono::nanoseconds{1500};
+    parse.latency[1] = 2u; // 1ns
+    parse.latency[5] = 1u; // 16-31ns
+    snapshot.clock_regressions = 4u;
+    snapshot.threads.push_back({7u, 42u});
+
+    const std::string text = rfc4122::to_prometheus(snapshot);
+    EXPECT_NE(std::string::npos, text.find("# TYPE uuid_calls_total counter\n"));
+    EXPECT_NE(std::string::npos, text.find("uuid_calls_total{operation=\"parse\"} 3\n"));
+    EXPECT_NE(std::string::npos, text.find("uuid_failures_total{operation=\"parse\"} 1\n"));
+    EXPECT_NE(std::string::npos, text.find("uuid_clock_regressions_total 4\n"));
+    EXPECT_NE(std::string::npos, text.find("uuid_call_duration_seconds_bucket{operation=\"parse\",le=\"1e-09\"} 0\n"));
+    EXPECT_NE(std::string::npos, text.find("uuid_call_duration_seconds_bucket{operation=\"parse\",le=\"2e-09\"} 2\n"));
+    EXPECT_NE(std::string::npos, text.find("uuid_call_duration_seconds_bucket{operation=\"parse\",le=\"3.2e-08\"} 3\n"));
+    EXPECT_NE(std::string::npos, text.find("uuid_call_duration_seconds_bucket{operation=\"parse\",le=\"+Inf\"} 3\n"));
+    EXPECT_NE(std::string::npos, text.find("uuid_call_duration_seconds_sum{operation=\"parse\"} 0.000001500\n"));
+    EXPECT_NE(std::string::npos, text.find("uuid_call_duration_seconds_count{operation=\"parse\"} 3\n"));
+    EXPECT_NE(std::string::npos, text.find("uuid_call_duration_seconds_count{operation=\"generate\"} 0\n"));
+    EXPECT_NE(std::string::npos, text.find("uuid_thread_generated_ids_total{thread=\"7\"} 42\n"));
+}
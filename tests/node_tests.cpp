@@ -0,0 +1,114 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <rfc4122/node.h>
+
+
+
+namespace
+{
+
+std::filesystem::path temp_path(const char* const name)
+{
+    return std::filesystem::temp_directory_path() / (std::string{"rfc4122_"} + std::to_string(::getpid()) + name);
+}
+
+void add_interface(const std::filesystem::path& directory, const char* const name, const char* const address, const bool device)
+{
+    std::filesystem::create_directories(directory / name);
+    std::ofstream{directory / name / "address"} << address << '\n';
+    if(device) std::filesystem::create_directory(directory / name / "device");
+}
+
+} // namespace
+
+TEST(Node, interface)
+{
+    const auto directory = temp_path("net");
+    std::filesystem::remove_all(directory);
+    add_interface(directory, "lo"   , "00:00:00:00:00:00", false);
+    add_interface(directory, "veth" , "02:42:ac:11:00:02", true ); // locally administered
+    add_interface(directory, "bond" , "01:00:5e:00:00:01", true ); // multicast
+    add_interface(directory, "dummy", "00:16:3e:aa:bb:cc", false);
+    EXPECT_EQ(0x00163eaabbccu, rfc4122::__internal::interface_node(directory));
+
+    // One with a device behind it comes first, whatever its name.
+    add_interface(directory, "wlan0", "00:1b:21:3a:4f:5D", true);
+    EXPECT_EQ(0x001b213a4f5du, rfc4122::__internal::interface_node(directory));
+    add_interface(directory, "eth0", "00:1b:21:3a:4f:5e", true);
+    EXPECT_EQ(0x001b213a4f5eu, rfc4122::__internal::interface_node(directory));
+
+    std::filesystem::remove_all(directory);
+    EXPECT_FALSE(rfc4122::__internal::interface_node(directory));
+}
+
+TEST(Node, machine_id)
+{
+    const auto file = temp_path("machine-id");
+    std::ofstream{file} << "67e3d13727e94486a0cd8c0d55eeb41b\n";
+    const auto node = rfc4122::__internal::machine_id_node(file);
+    ASSERT_TRUE(node);
+    EXPECT_EQ(node, rfc4122::__internal::machine_id_node(file));
+    EXPECT_NE(0u, *node & 0x010000000000u);
+    EXPECT_EQ(0u, *node >> 48);
+
+    std::ofstream{file} << "uninitialized\n";
+    EXPECT_FALSE(rfc4122::__internal::machine_id_node(file));
+    std::filesystem::remove(file);
+    EXPECT_FALSE(rfc4122::__internal::machine_id_node(file));
+}
+
+TEST(Node, host)
+{
+    const auto host = rfc4122::host_node();
+    EXPECT_EQ(host.node, rfc4122::host_node().node);
+    EXPECT_EQ(0u, host.node >> 48);
+    EXPECT_EQ(rfc4122::node_source::interface != host.source, 0u != (host.node & 0x010000000000u));
+    EXPECT_EQ(host.node, rfc4122::generate_time_based_uuid().node());
+    EXPECT_EQ(host.node, rfc4122::generate_reordered_time_uuid().node());
+}
+
+TEST(Node, fork)
+{
+    // Fills the buffers the child inherits.
+    const auto parent_before = rfc4122::generate_time_based_uuid();
+    rfc4122::generate_uuid();
+
+    int pipe[2] = {};
+    ASSERT_EQ(0, ::pipe(pipe));
+    const pid_t child = ::fork();
+    ASSERT_LE(0, child);
+    if(0 == child)
+    {
+        const rfc4122::uuid ids[] = {rfc4122::generate_uuid(), rfc4122::generate_time_based_uuid()};
+        const bool written = sizeof(ids) == ::write(pipe[1], ids, sizeof(ids));
+        ::_exit(written ? 0 : 1);
+    }
+    ::close(pipe[1]);
+    rfc4122::uuid ids[2] = {};
+    const ssize_t read = ::read(pipe[0], ids, sizeof(ids));
+    ::close(pipe[0]);
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(ids)), read);
+    ASSERT_TRUE(WIFEXITED(status) && 0 == WEXITSTATUS(status));
+
+    // Without the fork handlers the parent would come up with the same ids.
+    EXPECT_FALSE(ids[0] == rfc4122::generate_uuid());
+    const auto parent_after = rfc4122::generate_time_based_uuid();
+    EXPECT_TRUE(parent_before.clock_sequence() == parent_after.clock_sequence());
+    EXPECT_NE(parent_after.clock_sequence(), ids[1].clock_sequence());
+    if(rfc4122::node_source::random != rfc4122::host_node().source)
+    {
+        EXPECT_EQ(parent_after.node(), ids[1].node());
+    }
+}
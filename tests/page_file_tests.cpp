@@ -0,0 +1,152 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <rfc4122/page_file.h>
+
+
+
+namespace
+{
+
+std::filesystem::path temp_path(const char* const name)
+{
+    return std::filesystem::temp_directory_path() / (std::string{"rfc4122_"} + std::to_string(::getpid()) + name);
+}
+
+void write_file(const std::filesystem::path& path, const std::vector<rfc4122::uuid>& ids, const size_t page_size)
+{
+    rfc4122::page_file_writer writer{path, page_size};
+    for(size_t first = 0; first < std::size(ids); first += 333u)
+    {
+        writer.write(std::span{ids}.subspan(first, std::min<size_t>(333u, std::size(ids) - first)));
+    }
+    writer.close();
+}
+
+std::vector<rfc4122::uuid> flatten(const std::vector<std::span<const rfc4122::uuid>>& runs)
+{
+    std::vector<rfc4122::uuid> ids;
+    for(const auto& run: runs) ids.insert(std::end(ids), std::begin(run), std::end(run));
+    return ids;
+}
+
+} // namespace
+
+TEST(PageFile, round_trip)
+{
+    const auto path = temp_path("pages");
+    std::vector<rfc4122::uuid> ids(10000);
+    rfc4122::generate_n(ids);
+    write_file(path, ids, 1000);
+
+    const rfc4122::page_file file{path};
+    EXPECT_EQ(std::size(ids), file.size());
+    EXPECT_EQ(10u, file.pages());
+    EXPECT_FALSE(file.sorted());
+    EXPECT_TRUE(std::equal(std::begin(ids), std::end(ids), std::begin(file.ids()), std::end(file.ids())));
+
+    const auto page = file.page(3);
+    EXPECT_EQ(std::data(file.ids()) + 3000, std::data(page.ids));
+    EXPECT_TRUE(*std::min_element(std::begin(page.ids), std::end(page.ids)) == page.min);
+    EXPECT_TRUE(*std::max_element(std::begin(page.ids), std::end(page.ids)) == page.max);
+    EXPECT_GT(page.first_time, page.last_time);
+
+    // Only pages whose bounds overlap the range come back.
+    const auto low  = page.min;
+    const auto high = page.max;
+    const auto selected = flatten(file.select(low, high));
+    for(const auto& id: ids)
+    {
+        if(low <= id && id <= high)
+        {
+            EXPECT_NE(std::end(selected), std::find(std::begin(selected), std::end(selected), id));
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(PageFile, sorted_select)
+{
+    const auto path = temp_path("sorted_pages");
+    std::vector<rfc4122::uuid> ids(5000);
+    rfc4122::generate_n(ids);
+    std::sort(std::begin(ids), std::end(ids));
+    write_file(path, ids, 256);
+
+    const rfc4122::page_file file{path};
+    EXPECT_TRUE(file.sorted());
+    EXPECT_EQ(20u, file.pages());
+    EXPECT_EQ(136u, file.page(19).ids.size());
+
+    std::mt19937_64 random{5u};
+    for(int round = 0; round < 100; ++round)
+    {
+        auto low  = ids[random() % std::size(ids)];
+        auto high = ids[random() % std::size(ids)];
+        if(high < low) std::swap(low, high);
+        const auto first = std::lower_bound(std::begin(ids), std::end(ids), low);
+        const auto last  = std::upper_bound(std::begin(ids), std::end(ids), high);
+        const auto runs  = file.select(low, high);
+        ASSERT_EQ(1u, std::size(runs));
+        EXPECT_TRUE(std::equal(first, last, std::begin(runs[0]), std::end(runs[0])));
+    }
+    EXPECT_TRUE(std::empty(file.select(rfc4122::uuid{~uint64_t{0}, ~uint64_t{0}}, rfc4122::uuid{~uint64_t{0}, ~uint64_t{0}})));
+    std::filesystem::remove(path);
+}
+
+TEST(PageFile, select_time)
+{
+    const auto path = temp_path("time_pages");
+    std::vector<rfc4122::uuid> ids(4000);
+    rfc4122::generate_time_based_n(ids);
+    std::vector<rfc4122::uuid> random(1000);
+    rfc4122::generate_n(random);
+    ids.insert(std::end(ids), std::begin(random), std::end(random));
+    write_file(path, ids, 500);
+
+    const rfc4122::page_file file{path};
+    EXPECT_EQ(10u, file.pages());
+    const auto from = file.page(2).first_time;
+    const auto to   = file.page(4).last_time;
+    const auto selected = flatten(file.select_time(from, to));
+    for(const auto& id: ids)
+    {
+        const auto time = rfc4122::to_time_point(id);
+        const bool within = time && from <= *time && *time <= to;
+        if(within)
+        {
+            EXPECT_NE(std::end(selected), std::find(std::begin(selected), std::end(selected), id));
+        }
+    }
+    // The pages of random ids never pass a time filter.
+    EXPECT_EQ(std::size(file.select_time(rfc4122::uuid_time_point::min(), rfc4122::uuid_time_point::max())), 1u);
+    EXPECT_EQ(4000u, flatten(file.select_time(rfc4122::uuid_time_point::min(), rfc4122::uuid_time_point::max())).size());
+    std::filesystem::remove(path);
+}
+
+TEST(PageFile, invalid)
+{
+    const auto path = temp_path("bad_pages");
+    std::vector<rfc4122::uuid> ids(100);
+    rfc4122::generate_n(ids);
+    write_file(path, ids, 10);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1u);
+    EXPECT_THROW(rfc4122::page_file{path}, std::system_error);
+
+    write_file(path, {}, 10);
+    EXPECT_EQ(0u, rfc4122::page_file{path}.size());
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,126 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rfc4122/pool.h>
+
+
+
+namespace
+{
+
+// Pops `count` ids in each of `threads_count` threads and checks that none repeats.
+void expect_unique_pops(rfc4122::id_pool& pool, const int threads_count, const size_t count)
+{
+    std::vector<std::vector<rfc4122::uuid>> popped(threads_count);
+    std::vector<std::thread> threads;
+    for(auto& ids: popped)
+    {
+        threads.emplace_back([&pool, &ids, count]
+        {
+            for(size_t i = 0; i < count; ++i) ids.push_back(pool.pop());
+        });
+    }
+    for(auto& thread: threads) thread.join();
+
+    std::vector<rfc4122::uuid> all;
+    for(const auto& ids: popped) all.insert(std::end(all), std::begin(ids), std::end(ids));
+    std::sort(std::begin(all), std::end(all));
+    EXPECT_EQ(std::end(all), std::adjacent_find(std::begin(all), std::end(all)));
+    for(const auto& id: all) EXPECT_TRUE(pool.options().version == id.version());
+}
+
+} // namespace
+
+TEST(Pool, ring)
+{
+    rfc4122::__internal::mpmc_ring<int> ring{5};
+    EXPECT_EQ(8u, ring.capacity());
+    for(int i = 0; i < 8; ++i) EXPECT_TRUE(ring.try_push(i));
+    EXPECT_FALSE(ring.try_push(8));
+    EXPECT_EQ(8u, ring.size());
+    for(int round = 0; round < 3; ++round)
+    {
+        for(int i = 0; i < 8; ++i)
+        {
+            int value = -1;
+            EXPECT_TRUE(ring.try_pop(value));
+            EXPECT_EQ(i, value);
+            EXPECT_TRUE(ring.try_push(i));
+        }
+    }
+    int value = -1;
+    for(int i = 0; i < 8; ++i) EXPECT_TRUE(ring.try_pop(value));
+    EXPECT_FALSE(ring.try_pop(value));
+    EXPECT_EQ(0u, ring.size());
+}
+
+TEST(Pool, versions)
+{
+    using rfc4122::version;
+
+    for(const auto kind: {version::random, version::time_based, version::reordered_time, version::unix_time})
+    {
+        rfc4122::id_pool pool{{.version = kind, .capacity = 64, .low_watermark = 16}};
+        expect_unique_pops(pool, 4, 2000);
+    }
+    EXPECT_THROW(rfc4122::id_pool{{.version = version::md5_name}}, std::invalid_argument);
+}
+
+TEST(Pool, watermark)
+{
+    EXPECT_THROW(rfc4122::id_pool({.capacity = 64, .low_watermark = 64}), std::invalid_argument);
+    EXPECT_THROW(rfc4122::id_pool({.capacity = 60, .low_watermark = 100}), std::invalid_argument);
+
+    // 60 is rounded up to 64.
+    rfc4122::id_pool pool{{.capacity = 60, .low_watermark = 63}};
+    EXPECT_EQ(64u, pool.metrics().size);
+}
+
+TEST(Pool, fallback)
+{
+    rfc4122::id_pool pool{{.capacity = 4, .low_watermark = 1, .when_drained = rfc4122::drained_policy::generate}};
+    for(int i = 0; i < 3; ++i) pool.pop();
+    for(int spins = 0; spins < 10000 && pool.metrics().refills < 1u; ++spins) std::this_thread::yield();
+    EXPECT_GE(pool.metrics().refills, 1u);
+    EXPECT_LE(pool.metrics().lowest_size, 1u);
+
+    expect_unique_pops(pool, 4, 5000);
+    const auto metrics = pool.metrics();
+    EXPECT_EQ(20003u, metrics.popped + metrics.fallbacks);
+    EXPECT_EQ(metrics.drained, metrics.fallbacks);
+    EXPECT_LE(metrics.size, 4u);
+    EXPECT_GE(metrics.generated + 4u, metrics.popped);
+}
+
+TEST(Pool, wait)
+{
+    rfc4122::id_pool pool{{.capacity = 8, .low_watermark = 2, .when_drained = rfc4122::drained_policy::wait}};
+    expect_unique_pops(pool, 4, 5000);
+
+    const auto metrics = pool.metrics();
+    EXPECT_EQ(20000u, metrics.popped);
+    EXPECT_EQ(0u, metrics.fallbacks);
+    EXPECT_GE(metrics.refills, 1u);
+}
+
+TEST(Pool, refill)
+{
+    rfc4122::id_pool pool{{.capacity = 1024, .low_watermark = 512}};
+    EXPECT_EQ(1024u, pool.metrics().size);
+    for(int i = 0; i < 600; ++i) pool.pop();
+    for(int spins = 0; spins < 10000 && pool.metrics().refills < 1u; ++spins) std::this_thread::yield();
+    for(int spins = 0; spins < 10000 && pool.metrics().size < 1024u; ++spins) std::this_thread::yield();
+
+    const auto metrics = pool.metrics();
+    EXPECT_EQ(1u, metrics.refills);
+    EXPECT_EQ(1024u, metrics.size);
+    EXPECT_EQ(600u, metrics.generated);
+    EXPECT_EQ(0u, metrics.drained);
+}
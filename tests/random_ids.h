@@ -0,0 +1,25 @@
+#pragma once
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <rfc4122/uuid.h>
+
+
+
+// Ids of random octets, the same for the same count, for tests and benchmarks.
+inline std::vector<rfc4122::uuid> random_ids(const size_t count)
+{
+    std::mt19937_64 random{count};
+    std::vector<rfc4122::uuid> ids(count);
+    for(auto& id: ids)
+    {
+        const uint64_t high = random();
+        id = rfc4122::uuid{high, random()};
+    }
+    return ids;
+}
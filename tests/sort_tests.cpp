@@ -0,0 +1,59 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rfc4122/algorithm.h>
+#include "random_ids.h"
+
+
+
+namespace
+{
+
+void expect_sorted_like_std(std::vector<rfc4122::uuid> ids, const unsigned threads)
+{
+    auto expected = ids;
+    std::sort(std::begin(expected), std::end(expected));
+    rfc4122::sort(ids, threads);
+    EXPECT_TRUE(expected == ids) << std::size(ids) << " ids, " << threads << " threads";
+}
+
+} // namespace
+
+TEST(Sort, random)
+{
+    for(const size_t count: {0u, 1u, 100u, 5000u, 300000u})
+    {
+        for(const unsigned threads: {1u, 3u, 0u})
+        {
+            expect_sorted_like_std(random_ids(count), threads);
+        }
+    }
+}
+
+TEST(Sort, shared_octets)
+{
+    // Version 7 ids of one process share their time prefix, duplicates and
+    // ids equal but for the last octet exercise the skipped and single passes.
+    std::vector<rfc4122::uuid> ids(200000);
+    rfc4122::generate_unix_time_n(ids);
+    std::reverse(std::begin(ids), std::end(ids));
+    expect_sorted_like_std(ids, 4u);
+
+    std::vector<rfc4122::uuid> duplicates(100000, "f81d4fae-7dec-11d0-a765-00a0c91e6bf6"_uuid);
+    expect_sorted_like_std(duplicates, 2u);
+
+    std::vector<rfc4122::uuid> last_octet;
+    for(int i = 0; i < 100000; ++i)
+    {
+        auto bytes = rfc4122::to_string("f81d4fae-7dec-11d0-a765-00a0c91e6b00"_uuid);
+        bytes[34] = "0123456789abcdef"[(i * 7) % 16];
+        bytes[35] = "0123456789abcdef"[(i * 13) % 16];
+        last_octet.push_back(rfc4122::from_string(bytes.c_str(), std::size(bytes)));
+    }
+    expect_sorted_like_std(last_octet, 3u);
+}
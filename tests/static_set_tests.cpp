@@ -0,0 +1,66 @@
+//
+// Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
+//
+
+#include <array>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rfc4122/static_set.h>
+
+
+
+namespace
+{
+
+using namespace rfc4122;
+
+// Ids that differ in a few low bits only, the hard case for a weak hash.
+template<size_t N>
+constexpr std::array<uuid, N> sequential_ids()
+{
+    std::array<uuid, N> ids{};
+    for(size_t i = 0; i < N; ++i) ids[i] = uuid{0x6ba7b8109dad11d1u + (i << 32), 0x80b400c04fd430c8u + i};
+    return ids;
+}
+
+constexpr auto IDS = sequential_ids<300>();
+constexpr static_uuid_set KNOWN{IDS};
+
+constexpr static_uuid_set NAMESPACES{{  NAMESPACE_DNS
+                                      , NAMESPACE_URL
+                                      , NAMESPACE_OID
+                                      , "6ba7b814-9dad-11d1-80b4-00c04fd430c8"_uuid }};
+
+static_assert(NAMESPACES.contains(NAMESPACE_X500));
+static_assert(!NAMESPACES.contains(uuid{}));
+static_assert(2u == *NAMESPACES.find(NAMESPACE_OID));
+static_assert(299u == *KNOWN.find(IDS[299]));
+
+} // namespace
+
+TEST(StaticSet, finds_every_member)
+{
+    for(size_t i = 0; i < std::size(IDS); ++i)
+    {
+        const auto position = KNOWN.find(IDS[i]);
+        ASSERT_TRUE(position.has_value());
+        EXPECT_EQ(i, *position);
+        EXPECT_TRUE(KNOWN.contains(IDS[i]));
+    }
+    EXPECT_EQ(300u, KNOWN.size());
+    EXPECT_EQ(1024u, KNOWN.SLOTS);
+}
+
+TEST(StaticSet, rejects_others)
+{
+    std::vector<uuid> others(100000);
+    generate_n(others);
+    others.push_back(uuid{});
+    for(size_t i = 0; i < std::size(IDS); ++i) others.push_back(uuid{IDS[i].high(), IDS[i].low() + 1000u});
+    for(const auto& id: others)
+    {
+        EXPECT_FALSE(KNOWN.contains(id));
+        EXPECT_FALSE(KNOWN.find(id).has_value());
+    }
+}
@@ -2,13 +2,17 @@
 // Copyright © 2021, Alexander Borisov, https://github.com/SashaBorisov/uuid
 //
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <unordered_set>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <rfc4122/uuid.h>
+#include <rfc4122/node.h>
 
 
 
@@ -246,6 +250,106 @@ TEST(Parse, stream)
     }
 }
 
+namespace
+{
+
+// Hands out one symbol per underflow, so extraction never finds a whole literal in the get area.
+class trickle_buffer: public std::streambuf
+{
+public:
+    explicit trickle_buffer(const std::string& text): text{text} {}
+
+protected:
+    int_type underflow() override
+    {
+        if(position >= std::size(text)) return traits_type::eof();
+        symbol = text[position++];
+        setg(&symbol, &symbol, &symbol + 1);
+        return traits_type::to_int_type(symbol);
+    }
+
+private:
+    std::string text;
+    size_t position = 0u;
+    char symbol = '\0';
+};
+
+} // namespace
+
+TEST(Parse, stream_state)
+{
+    const auto expected = "abcdef12-3456-789a-bcde-f123456789ab"_uuid;
+    const std::string inputs[] = 
+    {
+          "  abcdef12-3456-789a-bcde-f123456789ab tail"
+        , "abcdef12-3456-789a-bcde-f123456789abcd"
+        , "abcdef12-3456-789a-bcde-f12345678"
+        , "abcdef12-3456+789a-bcde-f123456789ab"
+        , "   "
+    };
+    for(const bool trickle: {false, true})
+    {
+        std::vector<std::string> rests;
+        std::vector<std::ios_base::iostate> states;
+        for(const auto& text: inputs)
+        {
+            std::istringstream string_stream{text};
+            trickle_buffer trickle_stream{text};
+            std::istream input{trickle ? static_cast<std::streambuf*>(&trickle_stream) : string_stream.rdbuf()};
+            rfc4122::uuid id = expected;
+            input >> id;
+            states.push_back(input.rdstate());
+            if(input.good())
+            {
+                EXPECT_TRUE(expected == id) << text;
+            }
+            else EXPECT_TRUE(rfc4122::NIL_UUID == id) << text;
+            input.clear();
+            rests.emplace_back(std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{});
+        }
+        const std::vector<std::ios_base::iostate> expected_states = 
+        {
+              std::ios_base::goodbit
+            , std::ios_base::goodbit
+            , std::ios_base::eofbit | std::ios_base::failbit
+            , std::ios_base::failbit
+            , std::ios_base::eofbit | std::ios_base::failbit
+        };
+        EXPECT_EQ(expected_states, states);
+        EXPECT_EQ((std::vector<std::string>{" tail", "cd", "", "+789a-bcde-f123456789ab", ""}), rests);
+    }
+
+    std::istringstream no_skip{" abcdef12-3456-789a-bcde-f123456789ab"};
+    rfc4122::uuid id{};
+    no_skip >> std::noskipws >> id;
+    EXPECT_TRUE(no_skip.fail());
+}
+
+TEST(Parse, parse_all)
+{
+    std::vector<rfc4122::uuid> expected;
+    std::ostringstream text;
+    for(auto i = 0u; i < 100u; ++i)
+    {
+        expected.push_back(rfc4122::generate_uuid());
+        text << expected.back() << (0u == i % 3u ? "\r\n" : " ");
+    }
+    {
+        std::istringstream input{text.str()};
+        std::vector<rfc4122::uuid> actual;
+        rfc4122::parse_all(input, std::back_inserter(actual));
+        EXPECT_EQ(std::ios_base::eofbit, input.rdstate());
+        EXPECT_TRUE(expected == actual);
+    }
+    {
+        std::basic_istringstream<char16_t> input{u"abcdef12-3456-789a-bcde-f123456789ab\nnot-an-id"};
+        std::vector<rfc4122::uuid> actual;
+        rfc4122::parse_all(input, std::back_inserter(actual));
+        EXPECT_EQ(std::ios_base::failbit, input.rdstate());
+        EXPECT_EQ(1u, std::size(actual));
+    }
+}
+
 TEST(Format, to_string)
 {
     constexpr uint8_t expected[] = 
@@ -256,8 +360,7 @@ TEST(Format, to_string)
         , 0xbc, 0xde
         , 0xf1, 0x23, 0x45, 0x67, 0x89, 0xab  
     };
-    rfc4122::uuid actual{};
-    std::memcpy(&actual, &expected, sizeof(actual));
+    const rfc4122::uuid actual{reinterpret_cast<const std::byte*>(expected)};
 
     EXPECT_EQ(  "abcdef12-3456-789a-bcde-f123456789ab", rfc4122::to_string(   actual));
     EXPECT_EQ(u8"abcdef12-3456-789a-bcde-f123456789ab", rfc4122::to_u8string( actual));
@@ -276,8 +379,7 @@ TEST(Format, parts)
         , 0xbc, 0xde
         , 0xf1, 0x23, 0x45, 0x67, 0x89, 0xab  
     };
-    rfc4122::uuid actual{};
-    std::memcpy(&actual, &expected, sizeof(actual));
+    const rfc4122::uuid actual{reinterpret_cast<const std::byte*>(expected)};
     
     EXPECT_EQ("abcdef12"    , hex_string(4, actual.part1()));
     EXPECT_EQ("3456"        , hex_string(2, actual.part2()));
@@ -286,3 +388,200 @@ TEST(Format, parts)
     EXPECT_EQ("f123456789ab", hex_string(6, actual.part5()));
 }
 
+
+TEST(Format, fields)
+{
+    constexpr rfc4122::uuid parts{0xabcdef12u, 0x3456u, 0x789au, 0xbcdeu, 0xf123456789abu};
+    EXPECT_EQ("abcdef12-3456-789a-bcde-f123456789ab", rfc4122::to_string(parts));
+
+    constexpr rfc4122::uuid fields
+    {
+          0x0123456789abcdefu
+        , rfc4122::variant::rfc4122
+        , rfc4122::version::time_based
+        , 0x2345u
+        , 0xf123456789abu
+    };
+    EXPECT_EQ("89abcdef-4567-1123-a345-f123456789ab", rfc4122::to_string(fields));
+    EXPECT_EQ(0x0123456789abcdefu & 0x0FFFFFFFFFFFFFFFu, fields.timestamp());
+    EXPECT_EQ(rfc4122::variant::rfc4122, fields.variant());
+    EXPECT_EQ(rfc4122::version::time_based, fields.version());
+    EXPECT_EQ(0x2345u, fields.clock_sequence());
+    EXPECT_EQ(0xf123456789abu, fields.node());
+
+    EXPECT_EQ(rfc4122::variant::ncs_compatibility, "00000000-0000-0000-7000-000000000000"_uuid.variant());
+    EXPECT_EQ(rfc4122::variant::microsoft        , "00000000-0000-0000-c000-000000000000"_uuid.variant());
+    EXPECT_EQ(rfc4122::variant::future           , "00000000-0000-0000-e000-000000000000"_uuid.variant());
+}
+
+TEST(Generate, random)
+{
+    std::set<std::string> unique;
+    for(int i = 0; i < 1000; ++i)
+    {
+        const auto id = rfc4122::generate_uuid();
+        EXPECT_EQ(rfc4122::version::random, id.version());
+        EXPECT_EQ(rfc4122::variant::rfc4122, id.variant());
+        unique.insert(rfc4122::to_string(id));
+    }
+
+    std::vector<rfc4122::uuid> batch(3000);
+    rfc4122::generate_n(batch);
+    for(const auto& id: batch)
+    {
+        EXPECT_EQ(rfc4122::version::random, id.version());
+        EXPECT_EQ(rfc4122::variant::rfc4122, id.variant());
+        const auto text = rfc4122::to_string(id);
+        EXPECT_EQ('4', text[14]);
+        EXPECT_NE(std::string::npos, std::string_view{"89ab"}.find(text[19]));
+        unique.insert(text);
+    }
+    EXPECT_EQ(4000u, std::size(unique));
+}
+
+TEST(Generate, time_based)
+{
+    using namespace std::chrono;
+    constexpr uint64_t gregorian_to_unix = 0x01B21DD213814000u;
+    const uint64_t now = gregorian_to_unix + duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count() / 100u;
+
+    constexpr int threads_count = 8;
+    constexpr int ids_count = 10000;
+    std::vector<std::vector<rfc4122::uuid>> generated(threads_count);
+    std::vector<std::thread> threads;
+    for(auto& ids: generated)
+    {
+        threads.emplace_back([&ids]
+        {
+            ids.resize(ids_count);
+            for(int i = 0; i < ids_count / 2; ++i) ids[i] = rfc4122::generate_time_based_uuid();
+            rfc4122::generate_time_based_n(std::span{ids}.subspan(ids_count / 2));
+        });
+    }
+    for(auto& thread: threads) thread.join();
+
+    std::set<uint64_t> timestamps;
+    for(const auto& ids: generated)
+    {
+        uint64_t previous = 0u;
+        for(const auto& id: ids)
+        {
+            EXPECT_EQ(rfc4122::version::time_based, id.version());
+            EXPECT_EQ(rfc4122::variant::rfc4122, id.variant());
+            EXPECT_EQ(rfc4122::host_node().node, id.node());
+            EXPECT_LT(previous, id.timestamp());
+            EXPECT_LE(now, id.timestamp());
+            EXPECT_GT(now + 10'000'000u, id.timestamp());
+            previous = id.timestamp();
+            timestamps.insert(id.timestamp());
+        }
+    }
+    EXPECT_EQ(static_cast<size_t>(threads_count * ids_count), std::size(timestamps));
+}
+
+TEST(Format, time_points)
+{
+    using namespace std::chrono;
+
+    // Examples of RFC 9562, all created at 2022-02-22 19:22:22 UTC.
+    constexpr auto time_based     = "c232ab00-9414-11ec-b3c8-9f6bdeced846"_uuid;
+    constexpr auto reordered_time = "1ec9414c-232a-6b00-b3c8-9f6bdeced846"_uuid;
+    constexpr auto unix_time      = "017f22e2-79b0-7cc3-98c4-dc0c0c07398f"_uuid;
+    constexpr system_clock::time_point expected{seconds{1645557742}};
+
+    static_assert(rfc4122::version::reordered_time == reordered_time.version());
+    static_assert(rfc4122::version::unix_time      == unix_time.version());
+    static_assert(time_based.timestamp() == reordered_time.reordered_timestamp());
+    static_assert(1645557742000u == unix_time.unix_timestamp());
+
+    EXPECT_EQ(expected, rfc4122::to_time_point(time_based));
+    EXPECT_EQ(expected, rfc4122::to_time_point(reordered_time));
+    EXPECT_EQ(expected, rfc4122::to_time_point(unix_time));
+    EXPECT_FALSE(rfc4122::to_time_point("f81d4fae-7dec-41d0-a765-00a0c91e6bf6"_uuid));
+}
+
+TEST(Generate, time_ordered)
+{
+    using namespace std::chrono;
+    const auto before = time_point_cast<milliseconds>(system_clock::now());
+
+    std::vector<rfc4122::uuid> reordered(5000);
+    std::vector<rfc4122::uuid> unix_time(5000);
+    for(size_t i = 0; i < std::size(unix_time) / 2; ++i)
+    {
+        reordered[i] = rfc4122::generate_reordered_time_uuid();
+        unix_time[i] = rfc4122::generate_unix_time_uuid();
+    }
+    rfc4122::generate_reordered_time_n(std::span{reordered}.subspan(std::size(reordered) / 2));
+    rfc4122::generate_unix_time_n(std::span{unix_time}.subspan(std::size(unix_time) / 2));
+    const auto after = system_clock::now();
+
+    for(size_t i = 0; i < std::size(unix_time); ++i)
+    {
+        EXPECT_EQ(rfc4122::version::reordered_time, reordered[i].version());
+        EXPECT_EQ(rfc4122::version::unix_time, unix_time[i].version());
+        EXPECT_EQ(rfc4122::variant::rfc4122, reordered[i].variant());
+        EXPECT_EQ(rfc4122::variant::rfc4122, unix_time[i].variant());
+        EXPECT_LE(before, rfc4122::to_time_point(reordered[i]));
+        EXPECT_LE(before, rfc4122::to_time_point(unix_time[i]));
+        EXPECT_GT(after + seconds{1}, rfc4122::to_time_point(reordered[i]));
+        EXPECT_GT(after + seconds{1}, rfc4122::to_time_point(unix_time[i]));
+        if(i > 0)
+        {
+            // Generation order is also the lexicographic order of the text.
+            EXPECT_LT(rfc4122::to_string(reordered[i - 1]), rfc4122::to_string(reordered[i]));
+            EXPECT_LT(rfc4122::to_string(unix_time[i - 1]), rfc4122::to_string(unix_time[i]));
+        }
+    }
+}
+
+TEST(Compare, all_octets)
+{
+    constexpr auto base = "00112233-4455-6677-8899-aabbccddee00"_uuid;
+    static_assert(base == "00112233-4455-6677-8899-AABBCCDDEE00"_uuid);
+    static_assert(0x0011223344556677u == base.high());
+    static_assert(0x8899aabbccddee00u == base.low());
+
+    // A difference in any single octet, the last ones included, is seen and
+    // ordered like the literals.
+    for(size_t octet = 0; octet < 16u; ++octet)
+    {
+        auto literal = rfc4122::to_string(base);
+        const size_t position = 2u * octet + (octet >= 4u) + (octet >= 6u) + (octet >= 8u) + (octet >= 10u);
+        literal[position] = 'f';
+        const auto greater = rfc4122::from_string(literal.c_str(), std::size(literal));
+        EXPECT_FALSE(base == greater) << literal;
+        EXPECT_TRUE (base != greater) << literal;
+        EXPECT_TRUE (base <  greater) << literal;
+        EXPECT_TRUE (greater > base ) << literal;
+        EXPECT_EQ(std::strong_ordering::less, base <=> greater) << literal;
+    }
+
+    std::vector<rfc4122::uuid> ids(1000);
+    rfc4122::generate_n(ids);
+    std::sort(std::begin(ids), std::end(ids));
+    for(size_t i = 1; i < std::size(ids); ++i)
+    {
+        EXPECT_LT(rfc4122::to_string(ids[i - 1]), rfc4122::to_string(ids[i]));
+    }
+}
+
+TEST(Hash, uuid)
+{
+    constexpr auto id = "f81d4fae-7dec-11d0-a765-00a0c91e6bf6"_uuid;
+    static_assert(rfc4122::hash(id) == rfc4122::uuid_hash{}(id));
+    EXPECT_EQ(rfc4122::hash(id), std::hash<rfc4122::uuid>{}(id));
+    EXPECT_NE(rfc4122::hash(id), rfc4122::hash(id, 1u));
+    EXPECT_EQ(rfc4122::process_hash_seed(), rfc4122::seeded_uuid_hash{}.seed);
+
+    // Time-based ids differ in a few low timestamp bits only, their hashes
+    // must still spread over all buckets.
+    std::vector<rfc4122::uuid> ids(4096);
+    rfc4122::generate_time_based_n(ids);
+    std::unordered_set<rfc4122::uuid> set(std::begin(ids), std::end(ids));
+    EXPECT_EQ(std::size(ids), std::size(set));
+    std::vector<int> buckets(256);
+    for(const auto& value: ids) ++buckets[rfc4122::hash(value) & 0xFFu];
+    EXPECT_GT(40, *std::max_element(std::begin(buckets), std::end(buckets)));
+    for(const auto& value: ids) EXPECT_EQ(1u, set.count(value));
+}